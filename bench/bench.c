@@ -0,0 +1,252 @@
+#include "bench.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "frame_scheduler.h"
+
+// Iterações descartadas antes de medir (caches, alocações preguiçosas)
+#define BENCH_WARMUP 3
+#define BENCH_MIN_ITERATIONS 10
+
+// Mediana de um benchmark num baseline carregado
+typedef struct {
+    char name[64];
+    double median_ns;
+} BaselineEntry;
+
+struct BenchRunner {
+    const char* filter;
+    double min_time_ms;
+    
+    BenchResult* results;
+    int num_results;
+    int results_capacity;
+    
+    BaselineEntry* baseline;
+    int num_baseline;
+    
+    double* samples;   // Tempos das iterações do benchmark atual
+};
+
+BenchRunner* bench_runner_init(const char* filter, double min_time_ms) {
+    BenchRunner* runner = calloc(1, sizeof(BenchRunner));
+    if (!runner) {
+        return NULL;
+    }
+    
+    runner->filter = filter;
+    runner->min_time_ms = min_time_ms > 0.0 ? min_time_ms : 500.0;
+    runner->samples = malloc(BENCH_MAX_SAMPLES * sizeof(double));
+    if (!runner->samples) {
+        free(runner);
+        return NULL;
+    }
+    return runner;
+}
+
+void bench_runner_free(BenchRunner* runner) {
+    if (!runner) return;
+    
+    if (runner->results) {
+        free(runner->results);
+    }
+    if (runner->baseline) {
+        free(runner->baseline);
+    }
+    free(runner->samples);
+    free(runner);
+}
+
+bool bench_runner_wants(const BenchRunner* runner, const char* name) {
+    if (!runner || !name) return false;
+    return !runner->filter || strstr(name, runner->filter) != NULL;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Percentil de um array ordenado (mesmo arredondamento do perf_stats)
+static double percentile(const double* sorted, int n, double p) {
+    return sorted[(int)((n - 1) * p + 0.5)];
+}
+
+static double find_baseline(const BenchRunner* runner, const char* name) {
+    for (int i = 0; i < runner->num_baseline; i++) {
+        if (strcmp(runner->baseline[i].name, name) == 0) {
+            return runner->baseline[i].median_ns;
+        }
+    }
+    return 0.0;
+}
+
+bool bench_runner_run(BenchRunner* runner, const char* name, BenchFunction fn, void* ctx,
+                      double items, const char* unit) {
+    if (!runner || !name || !fn || !bench_runner_wants(runner, name)) return false;
+    
+    if (runner->num_results == runner->results_capacity) {
+        int capacity = runner->results_capacity ? runner->results_capacity * 2 : 32;
+        BenchResult* results = realloc(runner->results, capacity * sizeof(BenchResult));
+        if (!results) {
+            fprintf(stderr, "Erro: memória insuficiente para o benchmark %s\n", name);
+            return false;
+        }
+        runner->results = results;
+        runner->results_capacity = capacity;
+    }
+    
+    for (int i = 0; i < BENCH_WARMUP; i++) {
+        fn(ctx);
+    }
+    
+    // Repete até o tempo mínimo (e um mínimo de iterações para os percentis)
+    uint64_t budget_ns = (uint64_t)(runner->min_time_ms * 1000000.0);
+    uint64_t started = frame_clock_now_ns();
+    int n = 0;
+    while (n < BENCH_MAX_SAMPLES &&
+           (n < BENCH_MIN_ITERATIONS || frame_clock_now_ns() - started < budget_ns)) {
+        uint64_t t = frame_clock_now_ns();
+        fn(ctx);
+        runner->samples[n++] = (double)(frame_clock_now_ns() - t);
+    }
+    qsort(runner->samples, n, sizeof(double), compare_double);
+    
+    BenchResult* result = &runner->results[runner->num_results++];
+    memset(result, 0, sizeof(*result));
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->iterations = n;
+    result->items = items;
+    result->unit = unit ? unit : "";
+    result->median_ns = percentile(runner->samples, n, 0.5);
+    result->p90_ns = percentile(runner->samples, n, 0.9);
+    result->p99_ns = percentile(runner->samples, n, 0.99);
+    result->min_ns = runner->samples[0];
+    result->max_ns = runner->samples[n - 1];
+    result->baseline_ns = find_baseline(runner, name);
+    
+    // Progresso na hora (a tabela completa sai no fim)
+    fprintf(stderr, "  %-40s %10.1f us\n", name, result->median_ns / 1000.0);
+    return true;
+}
+
+bool bench_runner_load_baseline(BenchRunner* runner, const char* path) {
+    if (!runner || !path) return false;
+    
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* text = size > 0 ? malloc(size + 1) : NULL;
+    if (!text || fread(text, 1, size, file) != (size_t)size) {
+        fprintf(stderr, "Erro ao ler baseline: %s\n", path);
+        if (text) free(text);
+        fclose(file);
+        return false;
+    }
+    text[size] = '\0';
+    fclose(file);
+    
+    // Cada objeto tem "name" seguido de "median_ns" (formato do write_json)
+    int capacity = 0;
+    const char* cursor = text;
+    while ((cursor = strstr(cursor, "\"name\": \"")) != NULL) {
+        cursor += strlen("\"name\": \"");
+        const char* end = strchr(cursor, '"');
+        const char* median = strstr(cursor, "\"median_ns\": ");
+        const char* next = strstr(cursor, "\"name\": \"");
+        if (!end || !median || (next && median > next)) continue;
+        
+        if (runner->num_baseline == capacity) {
+            capacity = capacity ? capacity * 2 : 32;
+            BaselineEntry* entries = realloc(runner->baseline, capacity * sizeof(BaselineEntry));
+            if (!entries) break;
+            runner->baseline = entries;
+        }
+        
+        BaselineEntry* entry = &runner->baseline[runner->num_baseline++];
+        int length = (int)(end - cursor);
+        if (length >= (int)sizeof(entry->name)) length = sizeof(entry->name) - 1;
+        memcpy(entry->name, cursor, length);
+        entry->name[length] = '\0';
+        entry->median_ns = strtod(median + strlen("\"median_ns\": "), NULL);
+    }
+    
+    free(text);
+    return true;
+}
+
+// Tempo com unidade legível
+static void format_time(double ns, char* text, size_t size) {
+    if (ns >= 1000000.0) {
+        snprintf(text, size, "%.2f ms", ns / 1000000.0);
+    } else {
+        snprintf(text, size, "%.1f us", ns / 1000.0);
+    }
+}
+
+int bench_runner_report(const BenchRunner* runner, double threshold) {
+    if (!runner) return 0;
+    
+    printf("\n%-40s %11s %11s %11s %18s %9s\n", "benchmark", "mediana", "p90", "p99", "vazão", "baseline");
+    int regressions = 0;
+    for (int i = 0; i < runner->num_results; i++) {
+        const BenchResult* r = &runner->results[i];
+        char median[16], p90[16], p99[16], rate[32] = "", delta[24] = "-";
+        format_time(r->median_ns, median, sizeof(median));
+        format_time(r->p90_ns, p90, sizeof(p90));
+        format_time(r->p99_ns, p99, sizeof(p99));
+        
+        if (r->items > 0.0 && r->median_ns > 0.0) {
+            double per_second = r->items * 1e9 / r->median_ns;
+            if (per_second >= 1e6) {
+                snprintf(rate, sizeof(rate), "%.2fM %s/s", per_second / 1e6, r->unit);
+            } else {
+                snprintf(rate, sizeof(rate), "%.0f %s/s", per_second, r->unit);
+            }
+        }
+        
+        // Variação positiva = mais lento que o baseline
+        bool regressed = false;
+        if (r->baseline_ns > 0.0) {
+            double change = (r->median_ns - r->baseline_ns) * 100.0 / r->baseline_ns;
+            regressed = change > threshold;
+            snprintf(delta, sizeof(delta), "%+.1f%%%s", change, regressed ? " !" : "");
+        }
+        if (regressed) regressions++;
+        
+        printf("%-40s %11s %11s %11s %18s %9s\n", r->name, median, p90, p99, rate, delta);
+    }
+    
+    if (regressions > 0) {
+        printf("\n%d benchmark(s) mais lentos que o baseline (limite: +%.0f%%)\n", regressions, threshold);
+    }
+    return regressions;
+}
+
+bool bench_runner_write_json(const BenchRunner* runner, const char* path) {
+    if (!runner || !path) return false;
+    
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Erro ao criar arquivo de resultados: %s\n", path);
+        return false;
+    }
+    
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+    for (int i = 0; i < runner->num_results; i++) {
+        const BenchResult* r = &runner->results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"iterations\": %d, \"items\": %.0f, \"unit\": \"%s\", "
+                "\"median_ns\": %.0f, \"p90_ns\": %.0f, \"p99_ns\": %.0f, \"min_ns\": %.0f, \"max_ns\": %.0f}%s\n",
+                r->name, r->iterations, r->items, r->unit, r->median_ns, r->p90_ns, r->p99_ns,
+                r->min_ns, r->max_ns, i + 1 < runner->num_results ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    
+    return fclose(file) == 0;
+}
@@ -0,0 +1,62 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Medições guardadas por benchmark (percentis sobre elas)
+#define BENCH_MAX_SAMPLES 4096
+
+// Uma execução do trecho medido
+// ctx: estado preparado pelo benchmark
+typedef void (*BenchFunction)(void* ctx);
+
+// Resultado de um benchmark (tempos em nanossegundos por iteração)
+typedef struct {
+    char name[64];
+    int iterations;
+    double items;         // Itens processados por iteração (samples, janelas...; 0 = não se aplica)
+    const char* unit;     // Nome do item (ex: "samples")
+    double median_ns;
+    double p90_ns;
+    double p99_ns;
+    double min_ns;
+    double max_ns;
+    double baseline_ns;   // Mediana no baseline (0 = ausente)
+} BenchResult;
+
+// Executa e registra os benchmarks; compara com um baseline em JSON
+typedef struct BenchRunner BenchRunner;
+
+// Inicializa o executor
+// filter: só roda benchmarks cujo nome contém o texto (NULL = todos)
+// min_time_ms: tempo mínimo medido por benchmark
+BenchRunner* bench_runner_init(const char* filter, double min_time_ms);
+
+// Libera recursos do executor
+void bench_runner_free(BenchRunner* runner);
+
+// Verifica se um benchmark passa no filtro (evita preparar o que não vai rodar)
+bool bench_runner_wants(const BenchRunner* runner, const char* name);
+
+// Mede fn: aquece, depois repete até min_time_ms (de 10 a BENCH_MAX_SAMPLES
+// iterações), cada uma cronometrada no relógio monotônico
+// items/unit: trabalho por iteração, para a vazão (items = 0 se não se aplica)
+// Retorna: false se o benchmark foi filtrado ou faltou memória
+bool bench_runner_run(BenchRunner* runner, const char* name, BenchFunction fn, void* ctx,
+                      double items, const char* unit);
+
+// Carrega as medianas de um JSON gravado por bench_runner_write_json
+// Retorna: false se o arquivo não existe ou não pôde ser lido
+bool bench_runner_load_baseline(BenchRunner* runner, const char* path);
+
+// Imprime a tabela de resultados (com a diferença para o baseline)
+// threshold: variação da mediana (%) acima da qual um benchmark é marcado como regressão
+// Retorna: número de regressões
+int bench_runner_report(const BenchRunner* runner, double threshold);
+
+// Grava os resultados em JSON (formato lido por bench_runner_load_baseline)
+// Retorna: false se o arquivo não pôde ser escrito
+bool bench_runner_write_json(const BenchRunner* runner, const char* path);
+
+#endif // BENCH_H
@@ -0,0 +1,649 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <SDL2/SDL.h>
+
+#include "bench.h"
+#include "fixtures.h"
+#include "audio_decoder.h"
+#include "audio_analyzer.h"
+#include "fft_analyzer.h"
+#include "color_mapper.h"
+#include "visualizer.h"
+
+// Mesmos parâmetros do programa (main.c)
+#define BENCH_SAMPLE_RATE 44100
+#define BENCH_FFT_SIZE 2048
+#define BENCH_BLOCK 512
+#define BENCH_WIDTH 800
+#define BENCH_HEIGHT 800
+#define BENCH_BARS 64
+
+// Duração das fixtures de áudio
+#define BENCH_FIXTURE_SECONDS 10.0
+
+// Quadros de análise pré-calculados, desenhados em ciclo pelas camadas
+#define BENCH_FRAMES 64
+
+// Samples lidos por chamada ao decodificador
+#define BENCH_DECODE_CHUNK 4096
+
+// Cores mapeadas por iteração nos benchmarks de lote e diferença aceita
+// (por canal) entre o lote SSE2 e o caminho escalar
+#define BENCH_COLOR_BATCH 4096
+#define BENCH_COLOR_TOLERANCE 1
+
+// Opções de linha de comando
+typedef struct {
+    const char* baseline;       // JSON de referência (NULL = sem comparação)
+    const char* output;         // JSON de resultados (NULL = não grava)
+    const char* filter;
+    const char* fixtures_dir;
+    double threshold;           // % acima do baseline que conta como regressão
+    double min_time_ms;
+    bool strict;                // Sai com erro se houver regressão
+} BenchOptions;
+
+static void print_usage(const char* program) {
+    fprintf(stderr, "Uso: %s [opções]\n", program);
+    fprintf(stderr, "Opções:\n");
+    fprintf(stderr, "  --baseline ARQUIVO   Compara as medianas com um JSON gravado antes\n");
+    fprintf(stderr, "  --output ARQUIVO     Grava os resultados em JSON\n");
+    fprintf(stderr, "  --filter TEXTO       Só roda benchmarks cujo nome contém o texto\n");
+    fprintf(stderr, "  --fixtures DIR       Diretório das fixtures de áudio geradas (padrão: .)\n");
+    fprintf(stderr, "  --threshold PCT      Regressão a partir de +PCT%% na mediana (padrão: 10)\n");
+    fprintf(stderr, "  --time MS            Tempo mínimo medido por benchmark (padrão: 500)\n");
+    fprintf(stderr, "  --strict             Sai com código 1 se houver regressão\n");
+}
+
+static bool parse_options(int argc, char* argv[], BenchOptions* opts) {
+    memset(opts, 0, sizeof(*opts));
+    opts->fixtures_dir = ".";
+    opts->threshold = 10.0;
+    opts->min_time_ms = 500.0;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            opts->baseline = argv[++i];
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            opts->output = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            opts->filter = argv[++i];
+        } else if (strcmp(argv[i], "--fixtures") == 0 && i + 1 < argc) {
+            opts->fixtures_dir = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            opts->threshold = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            opts->min_time_ms = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--strict") == 0) {
+            opts->strict = true;
+        } else {
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---- Decodificação ----
+
+typedef struct {
+    AudioDecoder* decoder;
+    int16_t buffer[BENCH_DECODE_CHUNK];
+    uint64_t decoded;
+} DecodeBench;
+
+// Decodifica o arquivo inteiro desde o início
+static void run_decode(void* data) {
+    DecodeBench* bench = data;
+    audio_decoder_rewind(bench->decoder);
+    bench->decoded = 0;
+    int n;
+    while ((n = audio_decoder_read(bench->decoder, bench->buffer, BENCH_DECODE_CHUNK)) > 0) {
+        bench->decoded += n;
+    }
+}
+
+// Vazão de audio_decoder_read por codec (fixtures geradas com o sinal de teste)
+static void bench_decoders(BenchRunner* runner, const BenchOptions* opts) {
+    static const char* extensions[] = {"wav", "flac", "mp3", "ogg", "m4a"};
+    
+    for (size_t e = 0; e < sizeof(extensions) / sizeof(extensions[0]); e++) {
+        char name[64];
+        snprintf(name, sizeof(name), "decode/%s", extensions[e]);
+        if (!bench_runner_wants(runner, name)) continue;
+        
+        char path[512];
+        char codec[32] = "";
+        snprintf(path, sizeof(path), "%s/fixture.%s", opts->fixtures_dir, extensions[e]);
+        if (!bench_fixture_write(path, BENCH_SAMPLE_RATE, BENCH_FIXTURE_SECONDS, codec, sizeof(codec))) {
+            fprintf(stderr, "  %-40s sem codificador, ignorado\n", name);
+            continue;
+        }
+        
+        DecodeBench* bench = malloc(sizeof(DecodeBench));
+        if (!bench) continue;
+        bench->decoder = audio_decoder_init(path);
+        if (!bench->decoder || !audio_decoder_is_valid(bench->decoder)) {
+            fprintf(stderr, "Erro ao abrir fixture: %s\n", path);
+            audio_decoder_free(bench->decoder);
+            free(bench);
+            continue;
+        }
+        
+        // Um passe para saber quantos samples cada iteração decodifica
+        run_decode(bench);
+        snprintf(name, sizeof(name), "decode/%s_%s", extensions[e], codec);
+        bench_runner_run(runner, name, run_decode, bench, (double)bench->decoded, "samples");
+        
+        audio_decoder_free(bench->decoder);
+        free(bench);
+    }
+}
+
+// ---- FFT ----
+
+typedef struct {
+    FFTAnalyzer* fft;
+    const int16_t* samples;
+    double* frequencies;
+} FFTBench;
+
+static void run_fft(void* data) {
+    FFTBench* bench = data;
+    fft_analyzer_analyze(bench->fft, bench->samples, bench->frequencies);
+}
+
+// Nome do benchmark de FFT (o backend FFTW mantém os nomes do baseline)
+static void fft_bench_name(char* name, size_t size, FFTBackend backend, int window_size) {
+    if (backend == FFT_BACKEND_FFTW) {
+        snprintf(name, size, "fft/%d", window_size);
+    } else {
+        snprintf(name, size, "fft/%s/%d", fft_analyzer_backend_name(backend), window_size);
+    }
+}
+
+// Precisão do ponto fixo contra o FFTW no sinal de teste: maior diferença
+// de magnitude relativa ao pico (dB) e se a frequência dominante coincide
+static void report_fixed_accuracy(FFTAnalyzer* fixed, int window_size, const int16_t* samples,
+                                  double* frequencies) {
+    double* reference = malloc((window_size / 2 + 1) * sizeof(double));
+    FFTAnalyzer* fftw = fft_analyzer_init_backend(BENCH_SAMPLE_RATE, window_size, FFT_BACKEND_FFTW);
+    if (reference && fftw) {
+        double dominant_fftw = fft_analyzer_analyze(fftw, samples, reference);
+        double dominant_fixed = fft_analyzer_analyze(fixed, samples, frequencies);
+        double peak = 0.0;
+        double error = 0.0;
+        for (int i = 0; i <= window_size / 2; i++) {
+            if (reference[i] > peak) peak = reference[i];
+            double diff = fabs(reference[i] - frequencies[i]);
+            if (diff > error) error = diff;
+        }
+        fprintf(stderr, "  fft/fixed/%d: erro máximo %.1f dB do pico, dominante %.1f Hz (FFTW %.1f Hz)\n",
+                window_size, error > 0.0 ? 20.0 * log10(error / peak) : -INFINITY,
+                dominant_fixed, dominant_fftw);
+    }
+    fft_analyzer_free(fftw);
+    free(reference);
+}
+
+// Janelas por segundo de fft_analyzer_analyze em vários tamanhos, em cada
+// backend compilado (com o FFTW presente, também a precisão do ponto fixo)
+static void bench_fft(BenchRunner* runner) {
+    static const int sizes[] = {512, 1024, 2048, 4096, 8192};
+    static const FFTBackend backends[] = {FFT_BACKEND_FFTW, FFT_BACKEND_FIXED};
+    
+    int16_t* samples = malloc(ANALYSIS_MAX_WINDOW * sizeof(int16_t));
+    double* frequencies = malloc((ANALYSIS_MAX_WINDOW / 2 + 1) * sizeof(double));
+    if (!samples || !frequencies) {
+        free(samples);
+        free(frequencies);
+        return;
+    }
+    bench_fixture_signal(samples, ANALYSIS_MAX_WINDOW, BENCH_SAMPLE_RATE, 0);
+    
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+        if (!fft_analyzer_backend_available(backends[b])) continue;
+        
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            char name[64];
+            fft_bench_name(name, sizeof(name), backends[b], sizes[s]);
+            if (!bench_runner_wants(runner, name)) continue;
+            
+            FFTBench bench = {fft_analyzer_init_backend(BENCH_SAMPLE_RATE, sizes[s], backends[b]),
+                              samples, frequencies};
+            if (!bench.fft) {
+                fprintf(stderr, "Erro ao inicializar FFT de %d\n", sizes[s]);
+                continue;
+            }
+            if (backends[b] == FFT_BACKEND_FIXED && fft_analyzer_backend_available(FFT_BACKEND_FFTW)) {
+                report_fixed_accuracy(bench.fft, sizes[s], samples, frequencies);
+            }
+            bench_runner_run(runner, name, run_fft, &bench, 1.0, "janelas");
+            fft_analyzer_free(bench.fft);
+        }
+    }
+    
+    free(samples);
+    free(frequencies);
+}
+
+// ---- Análise por quadro (bandas e cores) ----
+
+typedef struct {
+    FFTAnalyzer* fft;
+    ColorMapper* mapper;
+    AudioAnalyzer* analyzer;
+    AnalysisFrame* frame;
+    int16_t* signal;          // Sinal de teste em ciclo (BENCH_FRAMES blocos)
+    int next;
+    double low, mid, high;
+} AnalysisBench;
+
+// Energias das três bandas de um espectro (como audio_analyzer_process)
+static void run_bands(void* data) {
+    AnalysisBench* bench = data;
+    const double* spectrum = bench->frame->frequencies;
+    bench->low = fft_analyzer_get_band_energy(bench->fft, spectrum, 20.0, 200.0);
+    bench->mid = fft_analyzer_get_band_energy(bench->fft, spectrum, 200.0, 2000.0);
+    bench->high = fft_analyzer_get_band_energy(bench->fft, spectrum, 2000.0, 20000.0);
+}
+
+// Cores por sample de um bloco (como audio_analyzer_process)
+static void run_colors(void* data) {
+    AnalysisBench* bench = data;
+    AnalysisFrame* frame = bench->frame;
+    RGBColor base = color_mapper_lut_frequency(bench->mapper, frame->dominant_freq);
+    RGBColor bands = color_mapper_bands_to_rgb(bench->low, bench->mid, bench->high);
+    color_mapper_amplitude_blend(base, 0.7f, bands, 0.3f, frame->samples, frame->colors, BENCH_BLOCK);
+}
+
+// Quadro completo: janela deslizante, FFT, bandas e cores
+static void run_analysis_frame(void* data) {
+    AnalysisBench* bench = data;
+    audio_analyzer_process(bench->analyzer, bench->signal + bench->next * BENCH_BLOCK,
+                           BENCH_BLOCK, bench->frame);
+    bench->next = (bench->next + 1) % BENCH_FRAMES;
+}
+
+static void bench_analysis(BenchRunner* runner) {
+    AnalysisBench bench;
+    memset(&bench, 0, sizeof(bench));
+    bench.fft = fft_analyzer_init(BENCH_SAMPLE_RATE, BENCH_FFT_SIZE);
+    bench.mapper = color_mapper_init(COLOR_MAPPER_DEFAULT_RESOLUTION, NULL);
+    bench.analyzer = audio_analyzer_init(BENCH_SAMPLE_RATE, BENCH_FFT_SIZE, COLOR_MAPPER_DEFAULT_RESOLUTION);
+    bench.frame = malloc(sizeof(AnalysisFrame));
+    bench.signal = malloc(BENCH_FRAMES * BENCH_BLOCK * sizeof(int16_t));
+    
+    if (bench.fft && bench.mapper && bench.analyzer && bench.frame && bench.signal) {
+        bench_fixture_signal(bench.signal, BENCH_FRAMES * BENCH_BLOCK, BENCH_SAMPLE_RATE, 0);
+        
+        // Enche a janela para que cada quadro tenha espectro
+        for (int i = 0; i < BENCH_FRAMES; i++) {
+            run_analysis_frame(&bench);
+        }
+        
+        bench_runner_run(runner, "analysis/bands", run_bands, &bench, 3.0, "bandas");
+        bench_runner_run(runner, "analysis/colors", run_colors, &bench, BENCH_BLOCK, "samples");
+        bench_runner_run(runner, "analysis/frame", run_analysis_frame, &bench, BENCH_BLOCK, "samples");
+    } else {
+        fprintf(stderr, "Erro ao preparar benchmarks de análise\n");
+    }
+    
+    if (bench.signal) free(bench.signal);
+    if (bench.frame) free(bench.frame);
+    audio_analyzer_free(bench.analyzer);
+    color_mapper_free(bench.mapper);
+    fft_analyzer_free(bench.fft);
+}
+
+// ---- Cores em lote (SSE2 contra o caminho escalar) ----
+
+typedef struct {
+    ColorMapper* mapper;
+    double* frequencies;
+    double* low;
+    double* mid;
+    double* high;
+    int16_t* samples;
+    RGBColor* colors;
+    RGBColor* reference;
+    uint32_t* packed;
+} ColorBench;
+
+static const RGBColor BENCH_BLEND_BASE = {200, 80, 40};
+static const RGBColor BENCH_BLEND_ACCENT = {40, 120, 230};
+
+static void run_lut_scalar(void* data) {
+    ColorBench* bench = data;
+    for (int i = 0; i < BENCH_COLOR_BATCH; i++) {
+        bench->colors[i] = color_mapper_lut_frequency(bench->mapper, bench->frequencies[i]);
+    }
+}
+
+static void run_lut_batch(void* data) {
+    ColorBench* bench = data;
+    color_mapper_lut_frequencies(bench->mapper, bench->frequencies, bench->colors, BENCH_COLOR_BATCH);
+}
+
+static void run_bands_scalar(void* data) {
+    ColorBench* bench = data;
+    for (int i = 0; i < BENCH_COLOR_BATCH; i++) {
+        bench->colors[i] = color_mapper_bands_to_rgb(bench->low[i], bench->mid[i], bench->high[i]);
+    }
+}
+
+static void run_bands_batch(void* data) {
+    ColorBench* bench = data;
+    color_mapper_bands_to_rgb_batch(bench->low, bench->mid, bench->high, bench->colors, BENCH_COLOR_BATCH);
+}
+
+static void run_blend_rgba32(void* data) {
+    ColorBench* bench = data;
+    color_mapper_amplitude_blend_rgba32(BENCH_BLEND_BASE, 0.7f, BENCH_BLEND_ACCENT, 0.3f,
+                                        bench->samples, 255, bench->packed, BENCH_COLOR_BATCH);
+}
+
+static void run_pack_rgba32(void* data) {
+    ColorBench* bench = data;
+    color_mapper_pack_rgba32(bench->colors, 255, bench->packed, BENCH_COLOR_BATCH);
+}
+
+// Maior diferença por canal entre dois arrays de cores
+static int max_color_error(const RGBColor* a, const RGBColor* b, int count) {
+    int worst = 0;
+    for (int i = 0; i < count; i++) {
+        int dr = abs(a[i].r - b[i].r);
+        int dg = abs(a[i].g - b[i].g);
+        int db = abs(a[i].b - b[i].b);
+        if (dr > worst) worst = dr;
+        if (dg > worst) worst = dg;
+        if (db > worst) worst = db;
+    }
+    return worst;
+}
+
+// Maior diferença por byte entre dois arrays RGBA32
+static int max_rgba32_error(const uint32_t* a, const uint32_t* b, int count) {
+    int worst = 0;
+    for (int i = 0; i < count; i++) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            int d = abs((int)((a[i] >> shift) & 0xFF) - (int)((b[i] >> shift) & 0xFF));
+            if (d > worst) worst = d;
+        }
+    }
+    return worst;
+}
+
+// Confere os lotes contra o caminho escalar (com e sem interpolação nas
+// tabelas); com count = 1 as funções de lote só rodam o laço escalar
+// Retorna: false se alguma diferença passar de BENCH_COLOR_TOLERANCE
+static bool check_color_batches(ColorBench* bench) {
+    int lut_error[2];
+    for (int interpolate = 0; interpolate < 2; interpolate++) {
+        color_mapper_set_interpolation(bench->mapper, interpolate != 0);
+        run_lut_batch(bench);
+        for (int i = 0; i < BENCH_COLOR_BATCH; i++) {
+            bench->reference[i] = color_mapper_lut_frequency(bench->mapper, bench->frequencies[i]);
+        }
+        lut_error[interpolate] = max_color_error(bench->colors, bench->reference, BENCH_COLOR_BATCH);
+    }
+    color_mapper_set_interpolation(bench->mapper, true);
+    
+    run_bands_batch(bench);
+    for (int i = 0; i < BENCH_COLOR_BATCH; i++) {
+        bench->reference[i] = color_mapper_bands_to_rgb(bench->low[i], bench->mid[i], bench->high[i]);
+    }
+    int bands_error = max_color_error(bench->colors, bench->reference, BENCH_COLOR_BATCH);
+    
+    uint32_t* scalar = malloc(BENCH_COLOR_BATCH * sizeof(uint32_t));
+    int blend_error = BENCH_COLOR_TOLERANCE + 1;
+    if (scalar) {
+        run_blend_rgba32(bench);
+        for (int i = 0; i < BENCH_COLOR_BATCH; i++) {
+            color_mapper_amplitude_blend_rgba32(BENCH_BLEND_BASE, 0.7f, BENCH_BLEND_ACCENT, 0.3f,
+                                                bench->samples + i, 255, scalar + i, 1);
+        }
+        blend_error = max_rgba32_error(bench->packed, scalar, BENCH_COLOR_BATCH);
+        free(scalar);
+    }
+    
+    bool ok = lut_error[0] <= BENCH_COLOR_TOLERANCE && lut_error[1] <= BENCH_COLOR_TOLERANCE &&
+              bands_error <= BENCH_COLOR_TOLERANCE && blend_error <= BENCH_COLOR_TOLERANCE;
+    fprintf(stderr, "  colors: diferença máxima do escalar: lut %d (sem interpolação %d), bands %d, blend %d%s\n",
+            lut_error[1], lut_error[0], bands_error, blend_error, ok ? "" : " -- ERRO");
+    return ok;
+}
+
+// Retorna: false se o lote divergir do caminho escalar
+static bool bench_colors(BenchRunner* runner) {
+    static const char* names[] = {
+        "colors/lut/scalar", "colors/lut/batch", "colors/bands/scalar", "colors/bands/batch",
+        "colors/blend_rgba32", "colors/pack_rgba32"
+    };
+    bool wanted = false;
+    for (int i = 0; i < 6; i++) {
+        wanted = wanted || bench_runner_wants(runner, names[i]);
+    }
+    if (!wanted) return true;
+    
+    ColorBench bench;
+    memset(&bench, 0, sizeof(bench));
+    bench.mapper = color_mapper_init(COLOR_MAPPER_DEFAULT_RESOLUTION, NULL);
+    bench.frequencies = malloc(BENCH_COLOR_BATCH * sizeof(double));
+    bench.low = malloc(BENCH_COLOR_BATCH * sizeof(double));
+    bench.mid = malloc(BENCH_COLOR_BATCH * sizeof(double));
+    bench.high = malloc(BENCH_COLOR_BATCH * sizeof(double));
+    bench.samples = malloc(BENCH_COLOR_BATCH * sizeof(int16_t));
+    bench.colors = malloc(BENCH_COLOR_BATCH * sizeof(RGBColor));
+    bench.reference = malloc(BENCH_COLOR_BATCH * sizeof(RGBColor));
+    bench.packed = malloc(BENCH_COLOR_BATCH * sizeof(uint32_t));
+    
+    bool ok = false;
+    if (bench.mapper && bench.frequencies && bench.low && bench.mid && bench.high &&
+        bench.samples && bench.colors && bench.reference && bench.packed) {
+        // Frequências de 10 Hz a 30 kHz (inclui as fora da tabela) e energias
+        // pseudoaleatórias, com trechos sem energia (cor preta)
+        uint32_t state = 12345u;
+        for (int i = 0; i < BENCH_COLOR_BATCH; i++) {
+            bench.frequencies[i] = 10.0 * pow(3000.0, (double)i / (BENCH_COLOR_BATCH - 1));
+            state = state * 1664525u + 1013904223u;
+            bench.low[i] = (state >> 8) / 16777216.0;
+            state = state * 1664525u + 1013904223u;
+            bench.mid[i] = (state >> 8) / 16777216.0;
+            state = state * 1664525u + 1013904223u;
+            bench.high[i] = (state >> 8) / 16777216.0 * 4.0;
+            if (i % 64 == 0) {
+                bench.low[i] = bench.mid[i] = bench.high[i] = 0.0;
+            }
+        }
+        bench_fixture_signal(bench.samples, BENCH_COLOR_BATCH, BENCH_SAMPLE_RATE, 0);
+        
+        ok = check_color_batches(&bench);
+        bench_runner_run(runner, names[0], run_lut_scalar, &bench, BENCH_COLOR_BATCH, "cores");
+        bench_runner_run(runner, names[1], run_lut_batch, &bench, BENCH_COLOR_BATCH, "cores");
+        bench_runner_run(runner, names[2], run_bands_scalar, &bench, BENCH_COLOR_BATCH, "cores");
+        bench_runner_run(runner, names[3], run_bands_batch, &bench, BENCH_COLOR_BATCH, "cores");
+        bench_runner_run(runner, names[4], run_blend_rgba32, &bench, BENCH_COLOR_BATCH, "samples");
+        bench_runner_run(runner, names[5], run_pack_rgba32, &bench, BENCH_COLOR_BATCH, "cores");
+    } else {
+        fprintf(stderr, "Erro ao preparar benchmarks de cores\n");
+    }
+    
+    free(bench.packed);
+    free(bench.reference);
+    free(bench.colors);
+    free(bench.samples);
+    free(bench.high);
+    free(bench.mid);
+    free(bench.low);
+    free(bench.frequencies);
+    color_mapper_free(bench.mapper);
+    return ok;
+}
+
+// ---- Camadas do visualizador ----
+
+typedef enum {
+    LAYER_CLEAR,          // Só limpar e apresentar (custo fixo do quadro)
+    LAYER_FLUID,
+    LAYER_SCROLL,
+    LAYER_BARS,
+    LAYER_PARTICLES,
+    LAYER_SPECTROGRAM,
+    LAYER_COUNT
+} LayerKind;
+
+static const char* layer_names[LAYER_COUNT] = {
+    "clear", "waveform_fluid", "waveform_scroll", "bars", "particles", "spectrogram"
+};
+
+typedef struct {
+    Visualizer* vis;
+    const AnalysisFrame* frames;
+    int next;
+    LayerKind kind;
+} LayerBench;
+
+// Um quadro com uma única camada (desenho + rasterização/present)
+static void run_layer(void* data) {
+    LayerBench* bench = data;
+    const AnalysisFrame* frame = &bench->frames[bench->next];
+    bench->next = (bench->next + 1) % BENCH_FRAMES;
+    
+    visualizer_clear(bench->vis);
+    switch (bench->kind) {
+    case LAYER_FLUID:
+        visualizer_draw_fluid_waveform(bench->vis, frame->samples, frame->num_samples,
+                                       frame->frequencies, frame->colors);
+        break;
+    case LAYER_SCROLL:
+        visualizer_draw_waveform_scroll(bench->vis, frame->samples, frame->num_samples, frame->colors);
+        break;
+    case LAYER_BARS:
+        visualizer_draw_frequency_bars(bench->vis, frame->frequencies, frame->num_bins, BENCH_BARS);
+        break;
+    case LAYER_PARTICLES:
+        visualizer_update_particles(bench->vis, frame->frequencies, frame->num_bins);
+        visualizer_draw_particles(bench->vis);
+        break;
+    case LAYER_SPECTROGRAM:
+        visualizer_draw_spectrogram(bench->vis, frame->frequencies, frame->num_bins);
+        break;
+    default:
+        break;
+    }
+    visualizer_present(bench->vis);
+}
+
+// Verifica se alguma camada de algum backend passa no filtro
+static bool wants_layers(const BenchRunner* runner) {
+    static const char* backends[] = {"software", "sdl"};
+    for (int b = 0; b < 2; b++) {
+        for (int kind = 0; kind < LAYER_COUNT; kind++) {
+            char name[64];
+            snprintf(name, sizeof(name), "layer/%s/%s", backends[b], layer_names[kind]);
+            if (bench_runner_wants(runner, name)) return true;
+        }
+    }
+    return false;
+}
+
+// Mede cada camada num visualizador sem janela visível
+// backend: nome no resultado ("software" = rasterizador em CPU, "sdl" = renderer do SDL)
+static void bench_layers_on(BenchRunner* runner, Visualizer* vis, const char* backend,
+                            const AnalysisFrame* frames) {
+    visualizer_set_audio_format(vis, BENCH_SAMPLE_RATE, BENCH_FFT_SIZE);
+    
+    for (int kind = 0; kind < LAYER_COUNT; kind++) {
+        char name[64];
+        snprintf(name, sizeof(name), "layer/%s/%s", backend, layer_names[kind]);
+        if (!bench_runner_wants(runner, name)) continue;
+        
+        // Partículas começam do mesmo estado em todas as execuções
+        visualizer_set_particle_seed(vis, 1);
+        LayerBench bench = {vis, frames, 0, (LayerKind)kind};
+        bench_runner_run(runner, name, run_layer, &bench, 1.0, "quadros");
+    }
+}
+
+static void bench_layers(BenchRunner* runner) {
+    if (!wants_layers(runner)) return;
+    
+    // Quadros de análise do sinal de teste (com espectro pronto)
+    AnalysisFrame* frames = malloc(BENCH_FRAMES * sizeof(AnalysisFrame));
+    AudioAnalyzer* analyzer = audio_analyzer_init(BENCH_SAMPLE_RATE, BENCH_FFT_SIZE, COLOR_MAPPER_DEFAULT_RESOLUTION);
+    int16_t block[BENCH_BLOCK];
+    if (!frames || !analyzer) {
+        fprintf(stderr, "Erro ao preparar benchmarks de camadas\n");
+        free(frames);
+        audio_analyzer_free(analyzer);
+        return;
+    }
+    uint64_t position = 0;
+    for (int i = 0; i < BENCH_FRAMES + BENCH_FFT_SIZE / BENCH_BLOCK; i++) {
+        bench_fixture_signal(block, BENCH_BLOCK, BENCH_SAMPLE_RATE, position);
+        position += BENCH_BLOCK;
+        audio_analyzer_process(analyzer, block, BENCH_BLOCK, &frames[i % BENCH_FRAMES]);
+    }
+    audio_analyzer_free(analyzer);
+    
+    // Backend software, o mesmo da exportação
+    Visualizer* vis = visualizer_init_headless(BENCH_WIDTH, BENCH_HEIGHT);
+    if (vis) {
+        bench_layers_on(runner, vis, "software", frames);
+        visualizer_free(vis);
+    }
+    
+    // Renderer do SDL sobre o driver de vídeo dummy (sem janela real)
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    vis = visualizer_init(BENCH_WIDTH, BENCH_HEIGHT, "SoundWave bench");
+    if (vis) {
+        bench_layers_on(runner, vis, "sdl", frames);
+        visualizer_free(vis);
+    } else {
+        fprintf(stderr, "  Renderer do SDL indisponível, camadas só no backend software\n");
+    }
+    
+    free(frames);
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opts;
+    if (!parse_options(argc, argv, &opts)) {
+        return 1;
+    }
+    
+    BenchRunner* runner = bench_runner_init(opts.filter, opts.min_time_ms);
+    if (!runner) {
+        fprintf(stderr, "Erro ao inicializar benchmarks\n");
+        return 1;
+    }
+    if (opts.baseline && !bench_runner_load_baseline(runner, opts.baseline)) {
+        fprintf(stderr, "Sem baseline em %s (grave um com make bench-baseline)\n", opts.baseline);
+    }
+    
+    fprintf(stderr, "Executando benchmarks...\n");
+    bench_decoders(runner, &opts);
+    bench_fft(runner);
+    bench_analysis(runner);
+    bool colors_ok = bench_colors(runner);
+    bench_layers(runner);
+    
+    int regressions = bench_runner_report(runner, opts.threshold);
+    bool ok = colors_ok;
+    if (opts.output) {
+        if (bench_runner_write_json(runner, opts.output)) {
+            printf("Resultados gravados em %s\n", opts.output);
+        } else {
+            ok = false;
+        }
+    }
+    
+    bench_runner_free(runner);
+    return !ok || (opts.strict && regressions > 0) ? 1 : 0;
+}
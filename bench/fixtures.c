@@ -0,0 +1,250 @@
+#include "fixtures.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+
+// Varredura logarítmica repetida a cada FIXTURE_SWEEP_SECONDS
+#define FIXTURE_SWEEP_SECONDS 4.0
+#define FIXTURE_SWEEP_LOW 40.0
+#define FIXTURE_SWEEP_HIGH 12000.0
+
+// Amostras por quadro para codecs de tamanho variável (PCM)
+#define FIXTURE_FRAME_SIZE 1024
+
+// Taxa de bits dos codecs com perdas
+#define FIXTURE_BIT_RATE 192000
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Ruído determinístico a partir do índice (hash de 64 bits)
+static double noise_at(uint64_t index) {
+    uint64_t x = index * 0x9E3779B97F4A7C15ULL;
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    return (double)(x >> 11) / (double)(1ULL << 53) * 2.0 - 1.0;
+}
+
+void bench_fixture_signal(int16_t* samples, int num_samples, int sample_rate, uint64_t offset) {
+    if (!samples || num_samples <= 0 || sample_rate <= 0) return;
+    
+    const double period = FIXTURE_SWEEP_SECONDS;
+    const double k = log(FIXTURE_SWEEP_HIGH / FIXTURE_SWEEP_LOW);
+    for (int i = 0; i < num_samples; i++) {
+        uint64_t index = offset + i;
+        double t = fmod((double)index / sample_rate, period);
+        
+        // Fase da varredura exponencial (integral da frequência instantânea)
+        double phase = 2.0 * M_PI * FIXTURE_SWEEP_LOW * period / k * (exp(t / period * k) - 1.0);
+        double value = 0.5 * sin(phase) + 0.2 * sin(2.0 * phase) + 0.1 * noise_at(index);
+        samples[i] = (int16_t)(value * 32767.0);
+    }
+}
+
+// Envia um quadro (NULL = esvaziar) e grava os pacotes prontos
+static bool encode_and_write(AVFormatContext* format_ctx, AVCodecContext* ctx, AVStream* stream,
+                             AVPacket* packet, AVFrame* frame) {
+    if (avcodec_send_frame(ctx, frame) < 0) {
+        return false;
+    }
+    
+    for (;;) {
+        int ret = avcodec_receive_packet(ctx, packet);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+            return true;
+        }
+        if (ret < 0) {
+            return false;
+        }
+        
+        av_packet_rescale_ts(packet, ctx->time_base, stream->time_base);
+        packet->stream_index = stream->index;
+        ret = av_interleaved_write_frame(format_ctx, packet);
+        av_packet_unref(packet);
+        if (ret < 0) {
+            return false;
+        }
+    }
+}
+
+// Converte samples de 16 bits para o formato do codificador (mono: planar = intercalado)
+static bool fill_frame(AVFrame* frame, const int16_t* samples, int count) {
+    switch (frame->format) {
+    case AV_SAMPLE_FMT_S16:
+    case AV_SAMPLE_FMT_S16P:
+        memcpy(frame->data[0], samples, count * sizeof(int16_t));
+        return true;
+    case AV_SAMPLE_FMT_S32:
+    case AV_SAMPLE_FMT_S32P: {
+        int32_t* dst = (int32_t*)frame->data[0];
+        for (int i = 0; i < count; i++) dst[i] = (int32_t)samples[i] << 16;
+        return true;
+    }
+    case AV_SAMPLE_FMT_FLT:
+    case AV_SAMPLE_FMT_FLTP: {
+        float* dst = (float*)frame->data[0];
+        for (int i = 0; i < count; i++) dst[i] = samples[i] * (1.0f / 32768.0f);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+// Escolhe o primeiro formato de sample que fill_frame sabe converter
+static enum AVSampleFormat pick_sample_format(const AVCodec* codec) {
+    if (!codec->sample_fmts) return AV_SAMPLE_FMT_S16;
+    for (const enum AVSampleFormat* f = codec->sample_fmts; *f != AV_SAMPLE_FMT_NONE; f++) {
+        if (*f == AV_SAMPLE_FMT_S16 || *f == AV_SAMPLE_FMT_S16P || *f == AV_SAMPLE_FMT_S32 ||
+            *f == AV_SAMPLE_FMT_S32P || *f == AV_SAMPLE_FMT_FLT || *f == AV_SAMPLE_FMT_FLTP) {
+            return *f;
+        }
+    }
+    return AV_SAMPLE_FMT_NONE;
+}
+
+// Contêiner e codificador de uma fixture
+typedef struct {
+    AVFormatContext* format_ctx;
+    AVCodecContext* ctx;
+    AVStream* stream;
+    AVPacket* packet;
+    AVFrame* frame;
+    int16_t* samples;
+    int frame_size;
+} FixtureEncoder;
+
+static void close_fixture(FixtureEncoder* enc) {
+    if (enc->samples) {
+        free(enc->samples);
+    }
+    if (enc->frame) {
+        av_frame_free(&enc->frame);
+    }
+    if (enc->packet) {
+        av_packet_free(&enc->packet);
+    }
+    if (enc->ctx) {
+        avcodec_free_context(&enc->ctx);
+    }
+    if (enc->format_ctx) {
+        if (enc->format_ctx->pb && !(enc->format_ctx->oformat->flags & AVFMT_NOFILE)) {
+            avio_closep(&enc->format_ctx->pb);
+        }
+        avformat_free_context(enc->format_ctx);
+        enc->format_ctx = NULL;
+    }
+}
+
+// Cria o codificador padrão do contêiner e grava o cabeçalho
+static bool open_fixture(FixtureEncoder* enc, const char* path, int sample_rate,
+                         char* codec_name, size_t name_size) {
+    if (avformat_alloc_output_context2(&enc->format_ctx, NULL, NULL, path) < 0 || !enc->format_ctx) {
+        fprintf(stderr, "Erro: formato desconhecido para %s\n", path);
+        return false;
+    }
+    
+    // Sem codificador para o formato (ex: FFmpeg sem libmp3lame): fixture ignorada
+    const AVCodec* codec = avcodec_find_encoder(enc->format_ctx->oformat->audio_codec);
+    if (!codec) {
+        return false;
+    }
+    if (codec_name) {
+        snprintf(codec_name, name_size, "%s", codec->name);
+    }
+    
+    enc->ctx = avcodec_alloc_context3(codec);
+    enc->packet = av_packet_alloc();
+    enc->frame = av_frame_alloc();
+    if (!enc->ctx || !enc->packet || !enc->frame) {
+        return false;
+    }
+    
+    AVCodecContext* ctx = enc->ctx;
+    ctx->sample_rate = sample_rate;
+    ctx->sample_fmt = pick_sample_format(codec);
+    ctx->bit_rate = FIXTURE_BIT_RATE;
+    ctx->time_base = (AVRational){1, sample_rate};
+    ctx->strict_std_compliance = FF_COMPLIANCE_EXPERIMENTAL;   // Aceita o vorbis nativo
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    ctx->channels = 1;
+    ctx->channel_layout = AV_CH_LAYOUT_MONO;
+    #pragma GCC diagnostic pop
+    if (enc->format_ctx->oformat->flags & AVFMT_GLOBALHEADER) {
+        ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+    if (ctx->sample_fmt == AV_SAMPLE_FMT_NONE || avcodec_open2(ctx, codec, NULL) < 0) {
+        fprintf(stderr, "Erro ao abrir codificador %s\n", codec->name);
+        return false;
+    }
+    
+    enc->stream = avformat_new_stream(enc->format_ctx, NULL);
+    if (!enc->stream || avcodec_parameters_from_context(enc->stream->codecpar, ctx) < 0) {
+        return false;
+    }
+    enc->stream->time_base = ctx->time_base;
+    
+    enc->frame_size = ctx->frame_size > 0 ? ctx->frame_size : FIXTURE_FRAME_SIZE;
+    AVFrame* frame = enc->frame;
+    frame->format = ctx->sample_fmt;
+    frame->nb_samples = enc->frame_size;
+    frame->sample_rate = sample_rate;
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    frame->channels = 1;
+    frame->channel_layout = AV_CH_LAYOUT_MONO;
+    #pragma GCC diagnostic pop
+    enc->samples = malloc(enc->frame_size * sizeof(int16_t));
+    if (!enc->samples || av_frame_get_buffer(frame, 0) < 0) {
+        return false;
+    }
+    
+    if (!(enc->format_ctx->oformat->flags & AVFMT_NOFILE) &&
+        avio_open(&enc->format_ctx->pb, path, AVIO_FLAG_WRITE) < 0) {
+        fprintf(stderr, "Erro ao criar fixture: %s\n", path);
+        return false;
+    }
+    return avformat_write_header(enc->format_ctx, NULL) >= 0;
+}
+
+bool bench_fixture_write(const char* path, int sample_rate, double seconds,
+                         char* codec_name, size_t name_size) {
+    if (!path || sample_rate <= 0 || seconds <= 0.0) return false;
+    
+    FixtureEncoder enc;
+    memset(&enc, 0, sizeof(enc));
+    if (!open_fixture(&enc, path, sample_rate, codec_name, name_size)) {
+        close_fixture(&enc);
+        return false;
+    }
+    
+    // Quadros completos (o último se estende um pouco além da duração)
+    bool ok = true;
+    uint64_t total = (uint64_t)(seconds * sample_rate);
+    for (uint64_t pos = 0; pos < total && ok; pos += enc.frame_size) {
+        ok = av_frame_make_writable(enc.frame) >= 0;
+        if (ok) {
+            bench_fixture_signal(enc.samples, enc.frame_size, sample_rate, pos);
+            ok = fill_frame(enc.frame, enc.samples, enc.frame_size);
+        }
+        if (ok) {
+            enc.frame->pts = (int64_t)pos;
+            ok = encode_and_write(enc.format_ctx, enc.ctx, enc.stream, enc.packet, enc.frame);
+        }
+    }
+    ok = ok && encode_and_write(enc.format_ctx, enc.ctx, enc.stream, enc.packet, NULL);
+    ok = ok && av_write_trailer(enc.format_ctx) >= 0;
+    if (!ok) {
+        fprintf(stderr, "Erro ao gravar fixture: %s\n", path);
+    }
+    
+    close_fixture(&enc);
+    return ok;
+}
@@ -0,0 +1,21 @@
+#ifndef BENCH_FIXTURES_H
+#define BENCH_FIXTURES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Sinal de teste determinístico: varredura de 40 Hz a 12 kHz com harmônicos
+// e ruído, para exercitar todas as bandas (mono, 16 bits)
+// offset: índice do primeiro sample (o sinal é uma função do índice)
+void bench_fixture_signal(int16_t* samples, int num_samples, int sample_rate, uint64_t offset);
+
+// Grava um arquivo de áudio mono com o sinal de teste
+// O codec é o padrão do contêiner escolhido pela extensão (.wav, .flac, .mp3...)
+// codec_name: recebe o nome do codificador usado (pode ser NULL)
+// Retorna: false se não houver codificador para o formato ou o arquivo
+//          não puder ser escrito
+bool bench_fixture_write(const char* path, int sample_rate, double seconds,
+                         char* codec_name, size_t name_size);
+
+#endif // BENCH_FIXTURES_H
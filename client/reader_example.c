@@ -0,0 +1,98 @@
+// nanosleep e clock_gettime (POSIX)
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include "soundwave_client.h"
+
+// Intervalo entre consultas ao anel quando não há quadro novo
+#define POLL_INTERVAL_NS 1000000L
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_signal(int signal_number) {
+    (void)signal_number;
+    stop_requested = 1;
+}
+
+static uint64_t monotonic_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Lê os quadros publicados por `soundwave --publish NOME` e imprime um
+// resumo de cada um (atraso desde a publicação, bandas e ataques)
+int main(int argc, char* argv[]) {
+    const char* name = SHM_DEFAULT_NAME;
+    bool latest_only = false;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--latest") == 0) {
+            latest_only = true;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Uso: %s [--latest] [nome]\n", argv[0]);
+            fprintf(stderr, "  --latest  Só o quadro mais recente a cada consulta (padrão: todos, em ordem)\n");
+            return 1;
+        } else {
+            name = argv[i];
+        }
+    }
+    
+    SoundwaveClient* client = soundwave_client_open(name);
+    if (!client) {
+        fprintf(stderr, "Inicie o SoundWave com --publish %s\n", name);
+        return 1;
+    }
+    
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+    
+    int sample_rate = soundwave_client_get_sample_rate(client);
+    int window_size = soundwave_client_get_window_size(client);
+    printf("Lendo %s (%d Hz, janela %d)\n", name, sample_rate, window_size);
+    
+    // Quadro fora da pilha (o espectro ocupa ~16 KB)
+    ShmFrame* frame = malloc(sizeof(ShmFrame));
+    if (!frame) {
+        soundwave_client_close(client);
+        return 1;
+    }
+    
+    uint64_t total_dropped = 0;
+    while (!stop_requested && soundwave_client_producer_alive(client)) {
+        uint64_t dropped = 0;
+        bool fresh = latest_only ? soundwave_client_read_latest(client, frame) :
+                                   soundwave_client_read_next(client, frame, &dropped);
+        if (!fresh) {
+            struct timespec pause = {0, POLL_INTERVAL_NS};
+            nanosleep(&pause, NULL);
+            continue;
+        }
+        total_dropped += dropped;
+        
+        double lag_ms = (monotonic_now_ns() - frame->timestamp_ns) / 1000000.0;
+        printf("#%-8llu %8.3f s  atraso %6.3f ms  dom %7.1f Hz  "
+               "graves %9.1f  médios %9.1f  agudos %9.1f  %c%c%c\n",
+               (unsigned long long)frame->frame, (double)frame->position / sample_rate, lag_ms,
+               frame->dominant_freq, frame->low_energy, frame->mid_energy, frame->high_energy,
+               (frame->onsets & SHM_ONSET_LOW) ? 'G' : '.',
+               (frame->onsets & SHM_ONSET_MID) ? 'M' : '.',
+               (frame->onsets & SHM_ONSET_HIGH) ? 'A' : '.');
+        if (dropped > 0) {
+            printf("  (%llu quadros perdidos)\n", (unsigned long long)dropped);
+        }
+    }
+    
+    if (!soundwave_client_producer_alive(client)) {
+        printf("Produtor encerrou\n");
+    }
+    printf("Quadros perdidos: %llu\n", (unsigned long long)total_dropped);
+    
+    free(frame);
+    soundwave_client_close(client);
+    return 0;
+}
@@ -0,0 +1,165 @@
+// shm_open e mmap (POSIX)
+#define _POSIX_C_SOURCE 200809L
+
+#include "soundwave_client.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Tentativas de cópia de um slot antes de desistir (cada falha significa que
+// o produtor reescreveu o slot durante a cópia)
+#define CLIENT_READ_ATTEMPTS 8
+
+// Bytes de um quadro antes do espectro
+#define FRAME_FIXED_SIZE offsetof(ShmFrame, spectrum)
+
+struct SoundwaveClient {
+    ShmHeader* shm;        // Mapeado só para leitura
+    size_t size;
+    uint64_t last_frame;   // Último quadro entregue
+};
+
+SoundwaveClient* soundwave_client_open(const char* name) {
+    if (!name) name = SHM_DEFAULT_NAME;
+    
+    char path[64];
+    snprintf(path, sizeof(path), "%s%s", name[0] == '/' ? "" : "/", name);
+    
+    int fd = shm_open(path, O_RDONLY, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Erro ao abrir memória compartilhada %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+    
+    struct stat st;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(ShmHeader)) {
+        mapped = mmap(NULL, sizeof(ShmHeader), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "Erro ao mapear memória compartilhada %s\n", path);
+        return NULL;
+    }
+    
+    // O produtor grava o magic por último: antes disso o cabeçalho não vale
+    ShmHeader* shm = mapped;
+    if (atomic_load_explicit(&shm->magic, memory_order_acquire) != SHM_MAGIC ||
+        shm->version != SHM_VERSION || shm->num_slots != SHM_SLOTS ||
+        shm->max_bins != SHM_MAX_BINS || shm->slot_size != sizeof(ShmSlot)) {
+        fprintf(stderr, "Erro: %s não tem um layout compatível (versão %d)\n", path, SHM_VERSION);
+        munmap(mapped, sizeof(ShmHeader));
+        return NULL;
+    }
+    
+    SoundwaveClient* client = calloc(1, sizeof(SoundwaveClient));
+    if (!client) {
+        munmap(mapped, sizeof(ShmHeader));
+        return NULL;
+    }
+    
+    client->shm = shm;
+    client->size = sizeof(ShmHeader);
+    
+    // Começa no quadro atual (não reentrega o que já está no anel)
+    client->last_frame = atomic_load_explicit(&shm->latest, memory_order_acquire);
+    return client;
+}
+
+void soundwave_client_close(SoundwaveClient* client) {
+    if (!client) return;
+    
+    munmap(client->shm, client->size);
+    free(client);
+}
+
+int soundwave_client_get_sample_rate(const SoundwaveClient* client) {
+    if (!client) return 0;
+    return (int)client->shm->sample_rate;
+}
+
+int soundwave_client_get_window_size(const SoundwaveClient* client) {
+    if (!client) return 0;
+    return (int)client->shm->window_size;
+}
+
+bool soundwave_client_producer_alive(const SoundwaveClient* client) {
+    if (!client) return false;
+    return atomic_load_explicit(&client->shm->alive, memory_order_acquire) != 0;
+}
+
+static uint64_t latest_frame(const SoundwaveClient* client) {
+    return atomic_load_explicit(&client->shm->latest, memory_order_acquire);
+}
+
+// Copia o quadro number do seu slot (leitura do seqlock)
+// Retorna: false se o slot estava sendo escrito ou já guarda outro quadro
+static bool copy_frame(const SoundwaveClient* client, uint64_t number, ShmFrame* frame) {
+    ShmSlot* slot = &client->shm->slots[number % SHM_SLOTS];
+    
+    uint32_t before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (before & 1u) {
+        return false;
+    }
+    
+    // Só os bins válidos (num_bins pode estar inconsistente se o slot mudar
+    // no meio; a verificação de seq abaixo descarta a cópia nesse caso)
+    memcpy(frame, &slot->data, FRAME_FIXED_SIZE);
+    uint32_t num_bins = frame->num_bins < SHM_MAX_BINS ? frame->num_bins : SHM_MAX_BINS;
+    memcpy(frame->spectrum, slot->data.spectrum, num_bins * sizeof(float));
+    
+    atomic_thread_fence(memory_order_acquire);
+    uint32_t after = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    return before == after && frame->frame == number;
+}
+
+bool soundwave_client_read_latest(SoundwaveClient* client, ShmFrame* frame) {
+    if (!client || !frame) return false;
+    
+    for (int attempt = 0; attempt < CLIENT_READ_ATTEMPTS; attempt++) {
+        uint64_t latest = latest_frame(client);
+        if (latest == 0 || latest == client->last_frame) {
+            return false;
+        }
+        if (copy_frame(client, latest, frame)) {
+            client->last_frame = latest;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool soundwave_client_read_next(SoundwaveClient* client, ShmFrame* frame, uint64_t* dropped) {
+    if (dropped) *dropped = 0;
+    if (!client || !frame) return false;
+    
+    for (int attempt = 0; attempt < CLIENT_READ_ATTEMPTS; attempt++) {
+        uint64_t latest = latest_frame(client);
+        uint64_t next = client->last_frame + 1;
+        if (latest < next) {
+            return false;
+        }
+        
+        // O slot seguinte ao mais recente pode estar sendo reescrito: quadros
+        // mais antigos que latest - (SHM_SLOTS - 2) já se perderam
+        uint64_t oldest = latest > SHM_SLOTS - 2 ? latest - (SHM_SLOTS - 2) : 1;
+        uint64_t skipped = 0;
+        if (next < oldest) {
+            skipped = oldest - next;
+            next = oldest;
+        }
+        
+        if (copy_frame(client, next, frame)) {
+            if (dropped) *dropped = skipped;
+            client->last_frame = next;
+            return true;
+        }
+    }
+    return false;
+}
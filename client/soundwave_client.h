@@ -0,0 +1,40 @@
+#ifndef SOUNDWAVE_CLIENT_H
+#define SOUNDWAVE_CLIENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "shm_layout.h"
+
+// Leitor dos quadros publicados pelo SoundWave (--publish) em memória
+// compartilhada. Não depende de SDL, FFmpeg ou FFTW: basta compilar este
+// arquivo com shm_layout.h. O mapeamento é só de leitura e nenhuma chamada
+// bloqueia o produtor; vários leitores podem abrir o mesmo nome.
+typedef struct SoundwaveClient SoundwaveClient;
+
+// Abre e mapeia o objeto publicado
+// name: nome passado a --publish (NULL = SHM_DEFAULT_NAME)
+// Retorna: NULL se o produtor não está rodando ou o layout é incompatível
+SoundwaveClient* soundwave_client_open(const char* name);
+
+// Desmapeia e libera o leitor
+void soundwave_client_close(SoundwaveClient* client);
+
+// Taxa de amostragem e janela FFT do produtor (para converter posição e bins)
+int soundwave_client_get_sample_rate(const SoundwaveClient* client);
+int soundwave_client_get_window_size(const SoundwaveClient* client);
+
+// Verifica se o produtor ainda está publicando (false depois que ele encerra;
+// nesse caso feche e abra de novo para seguir uma nova execução)
+bool soundwave_client_producer_alive(const SoundwaveClient* client);
+
+// Copia o quadro mais recente (para quem só quer o estado atual)
+// Retorna: false se não há quadro novo desde a última leitura
+bool soundwave_client_read_latest(SoundwaveClient* client, ShmFrame* frame);
+
+// Copia o próximo quadro em ordem (para quem precisa de todos os ataques)
+// dropped: se não NULL, recebe quantos quadros foram sobrescritos no anel
+//          antes de serem lidos (leitor mais lento que o produtor)
+// Retorna: false se não há quadro novo
+bool soundwave_client_read_next(SoundwaveClient* client, ShmFrame* frame, uint64_t* dropped);
+
+#endif // SOUNDWAVE_CLIENT_H
@@ -0,0 +1,226 @@
+#include "audio_analyzer.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "fft_analyzer.h"
+#include "memory_arena.h"
+
+// Detecção de ataques: a energia da banda precisa passar de ONSET_RATIO vezes
+// a média recente e de ONSET_FLOOR do pico (ignora ruído no silêncio)
+#define ONSET_RATIO 1.5
+#define ONSET_FLOOR 0.05
+#define ONSET_AVERAGE_WEIGHT 0.1
+#define ONSET_PEAK_DECAY 0.999
+
+// Quadros sem novo ataque na mesma banda depois de um ataque
+#define ONSET_HOLDOFF 4
+
+// Estado da detecção de ataques de uma banda
+typedef struct {
+    double average;
+    double peak;
+    int holdoff;
+} OnsetBand;
+
+struct AudioAnalyzer {
+    FFTAnalyzer* fft;
+    ColorMapper* color_mapper;
+    int window_size;
+    
+    // Janela deslizante (buffer circular) e cópia linear para a FFT
+    int16_t* window;
+    int16_t* linear;
+    int window_pos;
+    bool window_ready;
+    
+    // Médias para os ataques (graves, médios, agudos)
+    OnsetBand onset_bands[3];
+    
+    // Cores por sample (desligadas quando só as medidas interessam)
+    bool colors_enabled;
+    
+    // Instrumentação opcional (FFT, bandas, cores)
+    PerfStats* stats;
+};
+
+AudioAnalyzer* audio_analyzer_init(int sample_rate, int window_size, int color_resolution) {
+    if (window_size <= 0 || window_size > ANALYSIS_MAX_WINDOW) {
+        fprintf(stderr, "Erro: janela FFT inválida (%d)\n", window_size);
+        return NULL;
+    }
+    
+    AudioAnalyzer* analyzer = mem_calloc(1, sizeof(AudioAnalyzer));
+    if (!analyzer) {
+        return NULL;
+    }
+    
+    analyzer->window_size = window_size;
+    analyzer->colors_enabled = true;
+    analyzer->fft = fft_analyzer_init(sample_rate, window_size);
+    analyzer->color_mapper = color_mapper_init(color_resolution, NULL);
+    analyzer->window = mem_calloc(window_size, sizeof(int16_t));
+    analyzer->linear = mem_alloc(window_size * sizeof(int16_t));
+    
+    if (!analyzer->fft || !analyzer->color_mapper || !analyzer->window || !analyzer->linear) {
+        audio_analyzer_free(analyzer);
+        return NULL;
+    }
+    
+    return analyzer;
+}
+
+void audio_analyzer_free(AudioAnalyzer* analyzer) {
+    if (!analyzer) return;
+    
+    if (analyzer->linear) {
+        mem_free(analyzer->linear);
+    }
+    if (analyzer->window) {
+        mem_free(analyzer->window);
+    }
+    if (analyzer->color_mapper) {
+        color_mapper_free(analyzer->color_mapper);
+    }
+    if (analyzer->fft) {
+        fft_analyzer_free(analyzer->fft);
+    }
+    
+    mem_free(analyzer);
+}
+
+void audio_analyzer_set_perf_stats(AudioAnalyzer* analyzer, PerfStats* stats) {
+    if (!analyzer) return;
+    analyzer->stats = stats;
+}
+
+void audio_analyzer_set_colors(AudioAnalyzer* analyzer, bool enabled) {
+    if (!analyzer) return;
+    analyzer->colors_enabled = enabled;
+}
+
+void audio_analyzer_reset(AudioAnalyzer* analyzer) {
+    if (!analyzer) return;
+    analyzer->window_pos = 0;
+    analyzer->window_ready = false;
+    memset(analyzer->onset_bands, 0, sizeof(analyzer->onset_bands));
+}
+
+// Atualiza a média de uma banda; retorna true se a energia é um ataque
+static bool detect_onset(OnsetBand* band, double energy) {
+    bool onset = band->holdoff == 0 && band->average > 0.0 &&
+                 energy > band->average * ONSET_RATIO &&
+                 energy > band->peak * ONSET_FLOOR;
+    
+    if (onset) {
+        band->holdoff = ONSET_HOLDOFF;
+    } else if (band->holdoff > 0) {
+        band->holdoff--;
+    }
+    
+    band->average += (energy - band->average) * ONSET_AVERAGE_WEIGHT;
+    band->peak *= ONSET_PEAK_DECAY;
+    if (energy > band->peak) band->peak = energy;
+    return onset;
+}
+
+// Acumula samples no buffer circular da janela
+static void push_samples(AudioAnalyzer* analyzer, const int16_t* samples, int num_samples) {
+    int size = analyzer->window_size;
+    
+    // Só os últimos window_size samples importam
+    if (num_samples >= size) {
+        samples += num_samples - size;
+        num_samples = size;
+    }
+    
+    int first = size - analyzer->window_pos;
+    if (first > num_samples) first = num_samples;
+    memcpy(analyzer->window + analyzer->window_pos, samples, first * sizeof(int16_t));
+    memcpy(analyzer->window, samples + first, (num_samples - first) * sizeof(int16_t));
+    
+    analyzer->window_pos += num_samples;
+    if (analyzer->window_pos >= size) {
+        analyzer->window_pos -= size;
+        analyzer->window_ready = true;
+    }
+}
+
+void audio_analyzer_process(AudioAnalyzer* analyzer, const int16_t* samples, int num_samples,
+                            AnalysisFrame* frame) {
+    if (!analyzer || !frame) return;
+    
+    if (!samples || num_samples < 0) num_samples = 0;
+    if (num_samples > ANALYSIS_MAX_BLOCK) num_samples = ANALYSIS_MAX_BLOCK;
+    
+    memcpy(frame->samples, samples, num_samples * sizeof(int16_t));
+    frame->num_samples = num_samples;
+    frame->num_bins = analyzer->window_size / 2 + 1;
+    
+    push_samples(analyzer, frame->samples, num_samples);
+    
+    frame->spectrum_ready = analyzer->window_ready;
+    if (!analyzer->window_ready) {
+        frame->dominant_freq = 0.0;
+        frame->low_energy = 0.0;
+        frame->mid_energy = 0.0;
+        frame->high_energy = 0.0;
+        frame->onsets = 0;
+        if (analyzer->colors_enabled) {
+            audio_analyzer_fill_colors(analyzer, frame);
+        }
+        return;
+    }
+    
+    // Desenrola o buffer circular (do sample mais antigo ao mais recente)
+    uint64_t t = perf_stats_begin(analyzer->stats);
+    int size = analyzer->window_size;
+    int tail = size - analyzer->window_pos;
+    memcpy(analyzer->linear, analyzer->window + analyzer->window_pos, tail * sizeof(int16_t));
+    memcpy(analyzer->linear + tail, analyzer->window, analyzer->window_pos * sizeof(int16_t));
+    
+    frame->dominant_freq = fft_analyzer_analyze(analyzer->fft, analyzer->linear, frame->frequencies);
+    t = perf_stats_end(analyzer->stats, PERF_STAGE_FFT, t);
+    
+    // Calcula energias das bandas
+    frame->low_energy = fft_analyzer_get_band_energy(analyzer->fft, frame->frequencies, 20.0, 200.0);
+    frame->mid_energy = fft_analyzer_get_band_energy(analyzer->fft, frame->frequencies, 200.0, 2000.0);
+    frame->high_energy = fft_analyzer_get_band_energy(analyzer->fft, frame->frequencies, 2000.0, 20000.0);
+    
+    frame->onsets = 0;
+    if (detect_onset(&analyzer->onset_bands[0], frame->low_energy)) frame->onsets |= ANALYSIS_ONSET_LOW;
+    if (detect_onset(&analyzer->onset_bands[1], frame->mid_energy)) frame->onsets |= ANALYSIS_ONSET_MID;
+    if (detect_onset(&analyzer->onset_bands[2], frame->high_energy)) frame->onsets |= ANALYSIS_ONSET_HIGH;
+    perf_stats_end(analyzer->stats, PERF_STAGE_BANDS, t);
+    
+    if (analyzer->colors_enabled) {
+        audio_analyzer_fill_colors(analyzer, frame);
+    }
+}
+
+void audio_analyzer_fill_colors(AudioAnalyzer* analyzer, AnalysisFrame* frame) {
+    if (!analyzer || !frame) return;
+    
+    if (!frame->spectrum_ready) {
+        // Ainda não temos janela completa, usa cor padrão
+        RGBColor default_color = {128, 128, 255};
+        for (int i = 0; i < frame->num_samples; i++) {
+            frame->colors[i] = default_color;
+        }
+        return;
+    }
+    
+    uint64_t t = perf_stats_begin(analyzer->stats);
+    
+    // Gera cores para cada sample baseado na frequência dominante
+    RGBColor base_color = color_mapper_lut_frequency(analyzer->color_mapper, frame->dominant_freq);
+    
+    // Cor das bandas é a mesma para todo o bloco
+    RGBColor band_color = color_mapper_bands_to_rgb(frame->low_energy, frame->mid_energy,
+                                                    frame->high_energy);
+    
+    // Mistura cor baseada em frequência com cor baseada em bandas,
+    // modulada pela amplitude de cada sample (em lote)
+    color_mapper_amplitude_blend(base_color, 0.7f, band_color, 0.3f,
+                                 frame->samples, frame->colors, frame->num_samples);
+    perf_stats_end(analyzer->stats, PERF_STAGE_COLORS, t);
+}
@@ -0,0 +1,70 @@
+#ifndef AUDIO_ANALYZER_H
+#define AUDIO_ANALYZER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "color_mapper.h"
+#include "perf_stats.h"
+
+// Limites de tamanho de um quadro de análise
+#define ANALYSIS_MAX_WINDOW 8192
+#define ANALYSIS_MAX_BLOCK 2048
+
+// Bandas com ataque (onset) num quadro (AnalysisFrame.onsets)
+#define ANALYSIS_ONSET_LOW (1u << 0)
+#define ANALYSIS_ONSET_MID (1u << 1)
+#define ANALYSIS_ONSET_HIGH (1u << 2)
+
+// Resultado imutável da análise de um bloco de samples (tudo que o
+// renderizador precisa para desenhar um quadro, sem ponteiros externos)
+typedef struct {
+    uint64_t sequence;         // Número do quadro (cresce a cada publicação)
+    uint64_t position;         // Posição no arquivo (samples) ao fim do bloco
+    bool spectrum_ready;       // false até a primeira janela FFT completa
+    double dominant_freq;      // Frequência dominante em Hz
+    double low_energy;         // Energia 20-200 Hz
+    double mid_energy;         // Energia 200-2000 Hz
+    double high_energy;        // Energia 2000-20000 Hz
+    uint32_t onsets;           // Bandas cuja energia saltou acima da média recente (ANALYSIS_ONSET_*)
+    int num_samples;           // Samples do bloco
+    int num_bins;              // Bins do espectro (window_size / 2 + 1)
+    int16_t samples[ANALYSIS_MAX_BLOCK];
+    RGBColor colors[ANALYSIS_MAX_BLOCK];
+    double frequencies[ANALYSIS_MAX_WINDOW / 2 + 1];
+} AnalysisFrame;
+
+// Acumula samples numa janela deslizante e produz quadros de análise
+// (FFT, energias por banda, ataques e cores por sample)
+typedef struct AudioAnalyzer AudioAnalyzer;
+
+// Inicializa o analisador
+// sample_rate: taxa de amostragem do áudio
+// window_size: tamanho da janela FFT (até ANALYSIS_MAX_WINDOW)
+// color_resolution: resolução das tabelas de cor
+AudioAnalyzer* audio_analyzer_init(int sample_rate, int window_size, int color_resolution);
+
+// Libera recursos do analisador
+void audio_analyzer_free(AudioAnalyzer* analyzer);
+
+// Mede FFT, energias por banda e cores em stats (NULL = sem medição)
+void audio_analyzer_set_perf_stats(AudioAnalyzer* analyzer, PerfStats* stats);
+
+// Liga ou desliga as cores por sample (padrão: ligadas); desligadas,
+// frame->colors não é preenchido e o quadro sai mais barato
+void audio_analyzer_set_colors(AudioAnalyzer* analyzer, bool enabled);
+
+// Esvazia a janela deslizante e o histórico dos ataques
+// (ex: ao voltar ao início do arquivo)
+void audio_analyzer_reset(AudioAnalyzer* analyzer);
+
+// Analisa um bloco de samples e preenche o quadro
+// (sequence e position ficam a cargo do chamador)
+// num_samples: até ANALYSIS_MAX_BLOCK
+void audio_analyzer_process(AudioAnalyzer* analyzer, const int16_t* samples, int num_samples,
+                            AnalysisFrame* frame);
+
+// Preenche frame->colors a partir de samples, frequência dominante e
+// energias já presentes no quadro (ex: quadro lido de um track_cache)
+void audio_analyzer_fill_colors(AudioAnalyzer* analyzer, AnalysisFrame* frame);
+
+#endif // AUDIO_ANALYZER_H
@@ -6,6 +6,7 @@
 #include <libavformat/avformat.h>
 #include <libavcodec/avcodec.h>
 #include <libswresample/swresample.h>
+#include "memory_arena.h"
 
 struct AudioDecoder {
     AVFormatContext* format_ctx;
@@ -62,40 +63,71 @@ static int find_audio_stream(AVFormatContext* format_ctx, AVCodecContext** codec
     return stream_index;
 }
 
+// Verifica se o codec aberto só com o cabeçalho já tem o que o resampler usa
+static bool codec_params_complete(const AVCodecContext* codec_ctx) {
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    int channels = codec_ctx->channels;
+    #pragma GCC diagnostic pop
+    return codec_ctx->sample_rate > 0 && channels > 0 && codec_ctx->sample_fmt != AV_SAMPLE_FMT_NONE;
+}
+
 AudioDecoder* audio_decoder_init(const char* filename) {
-    AudioDecoder* decoder = calloc(1, sizeof(AudioDecoder));
+    return audio_decoder_init_probe(filename, NULL);
+}
+
+AudioDecoder* audio_decoder_init_probe(const char* filename, const AudioDecoderProbe* probe) {
+    AudioDecoder* decoder = mem_calloc(1, sizeof(AudioDecoder));
     if (!decoder) {
         return NULL;
     }
     
     decoder->format_ctx = avformat_alloc_context();
     if (!decoder->format_ctx) {
-        free(decoder);
+        mem_free(decoder);
         return NULL;
     }
     
+    // Limites da detecção (valores menores abrem mais rápido arquivos longos)
+    if (probe && probe->probe_bytes > 0) {
+        decoder->format_ctx->probesize = probe->probe_bytes;
+    }
+    if (probe && probe->analyze_us > 0) {
+        decoder->format_ctx->max_analyze_duration = probe->analyze_us;
+    }
+    
     // Abre o arquivo de áudio
     if (avformat_open_input(&decoder->format_ctx, filename, NULL, NULL) < 0) {
         fprintf(stderr, "Erro ao abrir arquivo de áudio: %s\n", filename);
         avformat_free_context(decoder->format_ctx);
-        free(decoder);
+        mem_free(decoder);
         return NULL;
     }
     
-    // Encontra informações do stream
-    if (avformat_find_stream_info(decoder->format_ctx, NULL) < 0) {
+    // Só com o cabeçalho: usa o stream se o codec abriu com parâmetros completos
+    if (probe && probe->header_only) {
+        decoder->audio_stream_index = find_audio_stream(decoder->format_ctx, &decoder->codec_ctx);
+        if (decoder->codec_ctx && !codec_params_complete(decoder->codec_ctx)) {
+            avcodec_free_context(&decoder->codec_ctx);
+        }
+    }
+    
+    // Encontra informações do stream (lê e decodifica o início do arquivo)
+    if (!decoder->codec_ctx && avformat_find_stream_info(decoder->format_ctx, NULL) < 0) {
         fprintf(stderr, "Erro ao encontrar informações do stream\n");
         avformat_close_input(&decoder->format_ctx);
-        free(decoder);
+        mem_free(decoder);
         return NULL;
     }
     
     // Encontra o stream de áudio
-    decoder->audio_stream_index = find_audio_stream(decoder->format_ctx, &decoder->codec_ctx);
+    if (!decoder->codec_ctx) {
+        decoder->audio_stream_index = find_audio_stream(decoder->format_ctx, &decoder->codec_ctx);
+    }
     if (decoder->audio_stream_index < 0 || !decoder->codec_ctx) {
         fprintf(stderr, "Erro ao encontrar stream de áudio\n");
         avformat_close_input(&decoder->format_ctx);
-        free(decoder);
+        mem_free(decoder);
         return NULL;
     }
     
@@ -114,7 +146,7 @@ AudioDecoder* audio_decoder_init(const char* filename) {
     decoder->swr_ctx = swr_alloc_set_opts(NULL,
                                           AV_CH_LAYOUT_MONO,
                                           AV_SAMPLE_FMT_S16,
-                                          44100,
+                                          AUDIO_DECODER_SAMPLE_RATE,
                                           decoder->codec_ctx->channel_layout,
                                           decoder->codec_ctx->sample_fmt,
                                           decoder->codec_ctx->sample_rate,
@@ -125,12 +157,12 @@ AudioDecoder* audio_decoder_init(const char* filename) {
         fprintf(stderr, "Erro ao inicializar resampler\n");
         avcodec_free_context(&decoder->codec_ctx);
         avformat_close_input(&decoder->format_ctx);
-        free(decoder);
+        mem_free(decoder);
         return NULL;
     }
     
     // Atualiza sample_rate para o resampled
-    decoder->sample_rate = 44100;
+    decoder->sample_rate = AUDIO_DECODER_SAMPLE_RATE;
     decoder->channels = 1;
     
     decoder->frame = av_frame_alloc();
@@ -140,25 +172,25 @@ AudioDecoder* audio_decoder_init(const char* filename) {
         swr_free(&decoder->swr_ctx);
         avcodec_free_context(&decoder->codec_ctx);
         avformat_close_input(&decoder->format_ctx);
-        free(decoder);
+        mem_free(decoder);
         return NULL;
     }
     
     decoder->resample_buffer_size = 4096;
-    decoder->resample_buffer = malloc(decoder->resample_buffer_size * sizeof(int16_t));
-    decoder->pending_buffer = malloc(decoder->resample_buffer_size * sizeof(int16_t));
+    decoder->resample_buffer = mem_alloc(decoder->resample_buffer_size * sizeof(int16_t));
+    decoder->pending_buffer = mem_alloc(decoder->resample_buffer_size * sizeof(int16_t));
     decoder->pending_size = 0;
     decoder->pending_pos = 0;
     
     if (!decoder->resample_buffer || !decoder->pending_buffer) {
-        if (decoder->pending_buffer) free(decoder->pending_buffer);
-        if (decoder->resample_buffer) free(decoder->resample_buffer);
+        if (decoder->pending_buffer) mem_free(decoder->pending_buffer);
+        if (decoder->resample_buffer) mem_free(decoder->resample_buffer);
         av_packet_free(&decoder->packet);
         av_frame_free(&decoder->frame);
         swr_free(&decoder->swr_ctx);
         avcodec_free_context(&decoder->codec_ctx);
         avformat_close_input(&decoder->format_ctx);
-        free(decoder);
+        mem_free(decoder);
         return NULL;
     }
     
@@ -170,10 +202,10 @@ void audio_decoder_free(AudioDecoder* decoder) {
     if (!decoder) return;
     
     if (decoder->pending_buffer) {
-        free(decoder->pending_buffer);
+        mem_free(decoder->pending_buffer);
     }
     if (decoder->resample_buffer) {
-        free(decoder->resample_buffer);
+        mem_free(decoder->resample_buffer);
     }
     if (decoder->packet) {
         av_packet_free(&decoder->packet);
@@ -191,7 +223,7 @@ void audio_decoder_free(AudioDecoder* decoder) {
         avformat_close_input(&decoder->format_ctx);
     }
     
-    free(decoder);
+    mem_free(decoder);
 }
 
 int audio_decoder_read(AudioDecoder* decoder, int16_t* samples, int num_samples) {
@@ -4,11 +4,27 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// Saída do decodificador: mono, 16 bits, sempre nesta taxa (conhecida
+// antes de abrir o arquivo, então player e FFT podem ser criados em paralelo)
+#define AUDIO_DECODER_SAMPLE_RATE 44100
+
 typedef struct AudioDecoder AudioDecoder;
 
-// Inicializa o decodificador de áudio
+// Detecção do formato e dos parâmetros do stream ao abrir o arquivo
+typedef struct {
+    int64_t probe_bytes;   // Bytes lidos para detectar o formato (0 = padrão do FFmpeg)
+    int64_t analyze_us;    // Duração analisada por avformat_find_stream_info (0 = padrão)
+    bool header_only;      // Pula avformat_find_stream_info quando o cabeçalho já
+                           // informa codec, taxa, canais e formato dos samples
+} AudioDecoderProbe;
+
+// Inicializa o decodificador de áudio (detecção padrão do FFmpeg)
 AudioDecoder* audio_decoder_init(const char* filename);
 
+// Inicializa o decodificador com a detecção configurada
+// probe: NULL = detecção padrão
+AudioDecoder* audio_decoder_init_probe(const char* filename, const AudioDecoderProbe* probe);
+
 // Libera recursos do decodificador
 void audio_decoder_free(AudioDecoder* decoder);
 
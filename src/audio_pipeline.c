@@ -0,0 +1,336 @@
+#include "audio_pipeline.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <SDL2/SDL.h>
+#include "triple_buffer.h"
+#include "frame_scheduler.h"
+#include "memory_arena.h"
+
+// Limites da espera entre reabastecimentos da fila de áudio (ns): o prazo
+// é o instante em que a fila chegaria ao buffer mínimo
+#define PIPELINE_AUDIO_MIN_SLEEP_NS 1000000ULL
+#define PIPELINE_AUDIO_MAX_SLEEP_NS 50000000ULL
+
+// Espera da análise no fim do arquivo (até o áudio reiniciar) e limite de
+// cada espera à frente do áudio: running e a geração são relidos a cada volta
+#define PIPELINE_ANALYSIS_IDLE_NS 5000000ULL
+
+// Samples lidos por vez ao reabastecer a fila
+#define PIPELINE_REFILL_CHUNK 1024
+
+struct AudioPipeline {
+    AudioDecoder* decoder;
+    AudioDecoder* vis_decoder;
+    AudioPlayer* player;
+    AudioAnalyzer* analyzer;
+    int sample_rate;
+    int block_size;
+    
+    // Pré-carga (cerca de 500ms, feita pela thread de áudio) e buffer
+    // mínimo (cerca de 200ms)
+    int preload_samples;
+    int min_buffer_samples;
+    
+    // Bloco lido pela thread de análise (até ANALYSIS_MAX_BLOCK samples)
+    int16_t* block_buffer;
+    
+    // Blocos por quadro de análise (menos FFTs por segundo sob carga)
+    atomic_int analysis_hop;
+    
+    // Quadros de análise (escritor: análise, leitor: renderização)
+    TripleBuffer* frames;
+    
+    SDL_Thread* audio_thread;
+    SDL_Thread* analysis_thread;
+    atomic_bool running;
+    
+    // Incrementado a cada reinício do áudio (a análise volta ao início)
+    atomic_uint generation;
+    
+    // Instrumentação opcional (leitura, ressincronização, underruns)
+    PerfStats* stats;
+    
+    // Publicação opcional dos quadros para outros processos
+    FramePublisher* publisher;
+    
+    // Faixa pré-calculada: substitui a leitura e a FFT da análise
+    TrackCache* track_cache;
+};
+
+AudioPipeline* audio_pipeline_init(AudioDecoder* decoder, AudioDecoder* vis_decoder,
+                                   AudioPlayer* player, AudioAnalyzer* analyzer,
+                                   int sample_rate, int block_size) {
+    if (!decoder || !vis_decoder || !player || !analyzer || sample_rate <= 0 ||
+        block_size <= 0 || block_size > ANALYSIS_MAX_BLOCK) {
+        return NULL;
+    }
+    
+    AudioPipeline* pipeline = mem_calloc(1, sizeof(AudioPipeline));
+    if (!pipeline) {
+        return NULL;
+    }
+    
+    pipeline->decoder = decoder;
+    pipeline->vis_decoder = vis_decoder;
+    pipeline->player = player;
+    pipeline->analyzer = analyzer;
+    pipeline->sample_rate = sample_rate;
+    pipeline->block_size = block_size;
+    pipeline->preload_samples = sample_rate / 2;
+    pipeline->min_buffer_samples = sample_rate / 5;
+    atomic_init(&pipeline->running, false);
+    atomic_init(&pipeline->generation, 0u);
+    atomic_init(&pipeline->analysis_hop, 1);
+    
+    pipeline->block_buffer = mem_alloc(ANALYSIS_MAX_BLOCK * sizeof(int16_t));
+    pipeline->frames = triple_buffer_init(sizeof(AnalysisFrame));
+    
+    if (!pipeline->block_buffer || !pipeline->frames) {
+        audio_pipeline_free(pipeline);
+        return NULL;
+    }
+    
+    return pipeline;
+}
+
+void audio_pipeline_free(AudioPipeline* pipeline) {
+    if (!pipeline) return;
+    
+    audio_pipeline_stop(pipeline);
+    
+    if (pipeline->frames) {
+        triple_buffer_free(pipeline->frames);
+    }
+    if (pipeline->block_buffer) {
+        mem_free(pipeline->block_buffer);
+    }
+    
+    mem_free(pipeline);
+}
+
+// Enfileira a pré-carga a partir da posição atual do decoder, um pedaço
+// por vez: a reprodução começa assim que o primeiro pedaço é decodificado
+// chunk: buffer de PIPELINE_REFILL_CHUNK samples
+static void preload_audio(AudioPipeline* pipeline, int16_t* chunk) {
+    int preloaded = 0;
+    while (preloaded < pipeline->preload_samples && atomic_load(&pipeline->running)) {
+        int read = audio_decoder_read(pipeline->decoder, chunk, PIPELINE_REFILL_CHUNK);
+        if (read <= 0) {
+            break;
+        }
+        audio_player_queue(pipeline->player, chunk, read);
+        preloaded += read;
+    }
+}
+
+// Mantém buffer de áudio cheio (independente do FPS visual)
+static int audio_thread_main(void* data) {
+    AudioPipeline* pipeline = data;
+    int16_t temp_buffer[PIPELINE_REFILL_CHUNK];
+    
+    // Pré-carga aqui, não em audio_pipeline_start: a janela não espera por ela
+    preload_audio(pipeline, temp_buffer);
+    
+    while (atomic_load(&pipeline->running)) {
+        int queued = audio_player_get_queued_samples(pipeline->player);
+        
+        // Fila vazia ao acordar: o dispositivo ficou sem samples
+        if (queued == 0 && !audio_player_is_paused(pipeline->player)) {
+            perf_stats_count(pipeline->stats, PERF_COUNTER_UNDERRUNS, 1);
+        }
+        
+        // Enfileira mais samples se o buffer estiver baixo
+        while (queued < pipeline->min_buffer_samples && atomic_load(&pipeline->running)) {
+            uint64_t t = perf_stats_begin(pipeline->stats);
+            int temp_read = audio_decoder_read(pipeline->decoder, temp_buffer, PIPELINE_REFILL_CHUNK);
+            perf_stats_end(pipeline->stats, PERF_STAGE_DECODE, t);
+            if (temp_read > 0) {
+                audio_player_queue(pipeline->player, temp_buffer, temp_read);
+                queued += temp_read;
+            } else {
+                // Fim do áudio, reinicia (a análise acompanha pela geração);
+                // a geração muda antes de zerar o relógio de reprodução e de
+                // novo depois da busca, para a análise descartar o que fez
+                // com o relógio no meio do reinício
+                printf("Fim do áudio. Reiniciando...\n");
+                atomic_fetch_add(&pipeline->generation, 1u);
+                audio_player_clear(pipeline->player);
+                audio_decoder_rewind(pipeline->decoder);
+                atomic_fetch_add(&pipeline->generation, 1u);
+                preload_audio(pipeline, temp_buffer);
+                queued = audio_player_get_queued_samples(pipeline->player);
+            }
+        }
+        
+        // Dorme até a fila voltar ao buffer mínimo
+        uint64_t margin = queued > pipeline->min_buffer_samples ?
+                          (uint64_t)(queued - pipeline->min_buffer_samples) : 0;
+        uint64_t sleep_ns = margin * 1000000000ULL / pipeline->sample_rate;
+        if (sleep_ns < PIPELINE_AUDIO_MIN_SLEEP_NS) sleep_ns = PIPELINE_AUDIO_MIN_SLEEP_NS;
+        if (sleep_ns > PIPELINE_AUDIO_MAX_SLEEP_NS) sleep_ns = PIPELINE_AUDIO_MAX_SLEEP_NS;
+        frame_clock_sleep_until(frame_clock_now_ns() + sleep_ns);
+    }
+    
+    return 0;
+}
+
+// Analisa blocos conforme o áudio é reproduzido e publica cada quadro
+static int analysis_thread_main(void* data) {
+    AudioPipeline* pipeline = data;
+    unsigned int seen_generation = atomic_load(&pipeline->generation);
+    uint64_t position = 0;
+    uint64_t sequence = 0;
+    bool at_end = false;
+    
+    while (atomic_load(&pipeline->running)) {
+        // Áudio reiniciou: volta a análise para o início
+        unsigned int generation = atomic_load(&pipeline->generation);
+        if (generation != seen_generation) {
+            if (!pipeline->track_cache) {
+                audio_decoder_rewind(pipeline->vis_decoder);
+            }
+            audio_analyzer_reset(pipeline->analyzer);
+            position = 0;
+            at_end = false;
+            seen_generation = generation;
+        }
+        
+        // No fim do arquivo: espera o áudio reiniciar
+        if (at_end) {
+            frame_clock_sleep_until(frame_clock_now_ns() + PIPELINE_ANALYSIS_IDLE_NS);
+            continue;
+        }
+        
+        // À frente do áudio reproduzido: dorme até o próximo salto da análise
+        // (em esperas curtas: o relógio de reprodução pode ter sido zerado
+        // por um reinício cuja geração ainda não foi publicada)
+        uint64_t played = audio_player_get_played_samples(pipeline->player);
+        if (position > played) {
+            uint64_t ahead_ns = (position - played) * 1000000000ULL / pipeline->sample_rate;
+            if (ahead_ns < PIPELINE_AUDIO_MIN_SLEEP_NS) ahead_ns = PIPELINE_AUDIO_MIN_SLEEP_NS;
+            if (ahead_ns > PIPELINE_ANALYSIS_IDLE_NS) ahead_ns = PIPELINE_ANALYSIS_IDLE_NS;
+            frame_clock_sleep_until(frame_clock_now_ns() + ahead_ns);
+            continue;
+        }
+        
+        // Tamanho do bloco deste quadro (o salto pode mudar a qualquer momento)
+        int block = pipeline->block_size * atomic_load(&pipeline->analysis_hop);
+        if (block > ANALYSIS_MAX_BLOCK) block = ANALYSIS_MAX_BLOCK;
+        
+        // Replay: lê o quadro da posição tocada (atrasada, pula direto para
+        // ela; os ataques dos quadros pulados são mantidos)
+        if (pipeline->track_cache) {
+            uint64_t start = position;
+            if (played - position > (uint64_t)block * 2) {
+                position = played - block;
+            }
+            position += block;
+            
+            AnalysisFrame* frame = triple_buffer_write_slot(pipeline->frames);
+            if (!track_cache_read(pipeline->track_cache, start, position, frame)) {
+                at_end = true;
+                continue;
+            }
+            audio_analyzer_fill_colors(pipeline->analyzer, frame);
+            frame->sequence = ++sequence;
+            frame_publisher_publish(pipeline->publisher, frame);
+            triple_buffer_publish(pipeline->frames);
+            continue;
+        }
+        
+        // Se a análise ficou para trás, descarta blocos até sincronizar
+        uint64_t t = perf_stats_begin(pipeline->stats);
+        bool resynced = false;
+        while (played - position > (uint64_t)block * 2) {
+            int skipped = audio_decoder_read(pipeline->vis_decoder, pipeline->block_buffer, block);
+            if (skipped <= 0) {
+                at_end = true;
+                break;
+            }
+            position += skipped;
+            resynced = true;
+        }
+        if (resynced) {
+            perf_stats_end(pipeline->stats, PERF_STAGE_RESYNC, t);
+        }
+        if (at_end) continue;
+        
+        int samples_read = audio_decoder_read(pipeline->vis_decoder, pipeline->block_buffer, block);
+        if (samples_read <= 0) {
+            at_end = true;
+            continue;
+        }
+        position += samples_read;
+        
+        AnalysisFrame* frame = triple_buffer_write_slot(pipeline->frames);
+        audio_analyzer_process(pipeline->analyzer, pipeline->block_buffer, samples_read, frame);
+        frame->sequence = ++sequence;
+        frame->position = position;
+        frame_publisher_publish(pipeline->publisher, frame);
+        triple_buffer_publish(pipeline->frames);
+    }
+    
+    return 0;
+}
+
+void audio_pipeline_set_perf_stats(AudioPipeline* pipeline, PerfStats* stats) {
+    if (!pipeline || atomic_load(&pipeline->running)) return;
+    pipeline->stats = stats;
+    audio_analyzer_set_perf_stats(pipeline->analyzer, stats);
+}
+
+void audio_pipeline_set_publisher(AudioPipeline* pipeline, FramePublisher* publisher) {
+    if (!pipeline || atomic_load(&pipeline->running)) return;
+    pipeline->publisher = publisher;
+}
+
+void audio_pipeline_set_track_cache(AudioPipeline* pipeline, TrackCache* cache) {
+    if (!pipeline || atomic_load(&pipeline->running)) return;
+    pipeline->track_cache = cache;
+}
+
+void audio_pipeline_set_analysis_hop(AudioPipeline* pipeline, int hop) {
+    if (!pipeline || hop <= 0) return;
+    atomic_store(&pipeline->analysis_hop, hop);
+}
+
+bool audio_pipeline_start(AudioPipeline* pipeline) {
+    if (!pipeline) return false;
+    if (atomic_load(&pipeline->running)) return true;
+    
+    atomic_store(&pipeline->running, true);
+    pipeline->audio_thread = SDL_CreateThread(audio_thread_main, "soundwave-audio", pipeline);
+    pipeline->analysis_thread = SDL_CreateThread(analysis_thread_main, "soundwave-analysis", pipeline);
+    
+    if (!pipeline->audio_thread || !pipeline->analysis_thread) {
+        fprintf(stderr, "Erro ao criar threads do pipeline: %s\n", SDL_GetError());
+        audio_pipeline_stop(pipeline);
+        return false;
+    }
+    
+    return true;
+}
+
+void audio_pipeline_stop(AudioPipeline* pipeline) {
+    if (!pipeline) return;
+    
+    atomic_store(&pipeline->running, false);
+    
+    if (pipeline->analysis_thread) {
+        SDL_WaitThread(pipeline->analysis_thread, NULL);
+        pipeline->analysis_thread = NULL;
+    }
+    if (pipeline->audio_thread) {
+        SDL_WaitThread(pipeline->audio_thread, NULL);
+        pipeline->audio_thread = NULL;
+    }
+}
+
+const AnalysisFrame* audio_pipeline_latest_frame(AudioPipeline* pipeline, bool* fresh) {
+    if (!pipeline) {
+        if (fresh) *fresh = false;
+        return NULL;
+    }
+    return triple_buffer_read(pipeline->frames, fresh);
+}
@@ -0,0 +1,61 @@
+#ifndef AUDIO_PIPELINE_H
+#define AUDIO_PIPELINE_H
+
+#include <stdbool.h>
+#include "audio_decoder.h"
+#include "audio_player.h"
+#include "audio_analyzer.h"
+#include "frame_publisher.h"
+#include "track_cache.h"
+
+// Pipeline em três estágios:
+//   - thread de áudio: decodifica e mantém a fila do player cheia
+//   - thread de análise: acompanha a posição reproduzida, analisa blocos e
+//     publica quadros de análise num buffer triplo sem travas
+//   - thread de renderização (chamadora): desenha sempre o último quadro
+// Um quadro lento nunca atrasa a alimentação do áudio.
+typedef struct AudioPipeline AudioPipeline;
+
+// Inicializa o pipeline (não assume a posse dos componentes)
+// decoder: decodificador da reprodução (usado só pela thread de áudio)
+// vis_decoder: decodificador da análise (usado só pela thread de análise)
+// block_size: samples por quadro de análise (até ANALYSIS_MAX_BLOCK)
+AudioPipeline* audio_pipeline_init(AudioDecoder* decoder, AudioDecoder* vis_decoder,
+                                   AudioPlayer* player, AudioAnalyzer* analyzer,
+                                   int sample_rate, int block_size);
+
+// Libera recursos do pipeline (encerra as threads se estiverem rodando)
+void audio_pipeline_free(AudioPipeline* pipeline);
+
+// Mede leitura, ressincronização, análise e underruns em stats
+// (NULL = sem medição; só antes de audio_pipeline_start)
+void audio_pipeline_set_perf_stats(AudioPipeline* pipeline, PerfStats* stats);
+
+// Publica também cada quadro de análise em memória compartilhada
+// (NULL = sem publicação; só antes de audio_pipeline_start)
+void audio_pipeline_set_publisher(AudioPipeline* pipeline, FramePublisher* publisher);
+
+// Reproduz os quadros de uma faixa pré-calculada em vez de analisar o áudio
+// (vis_decoder deixa de ser lido; NULL = análise ao vivo; só antes de
+// audio_pipeline_start)
+void audio_pipeline_set_track_cache(AudioPipeline* pipeline, TrackCache* cache);
+
+// Blocos de áudio por quadro de análise (padrão 1; pode mudar durante a reprodução)
+// Com hop > 1 cada quadro cobre hop blocos (até ANALYSIS_MAX_BLOCK samples)
+// e a FFT roda hop vezes menos por segundo
+void audio_pipeline_set_analysis_hop(AudioPipeline* pipeline, int hop);
+
+// Inicia as threads de áudio e análise (a thread de áudio faz a pré-carga;
+// o primeiro quadro de análise sai do primeiro bloco decodificado)
+// Retorna: false se não foi possível criar as threads
+bool audio_pipeline_start(AudioPipeline* pipeline);
+
+// Encerra e aguarda as threads
+void audio_pipeline_stop(AudioPipeline* pipeline);
+
+// Retorna o último quadro de análise publicado (válido até a próxima chamada)
+// fresh: se não NULL, recebe true se o quadro é novo desde a última chamada
+// Retorna: NULL se nenhum quadro foi publicado ainda
+const AnalysisFrame* audio_pipeline_latest_frame(AudioPipeline* pipeline, bool* fresh);
+
+#endif // AUDIO_PIPELINE_H
@@ -3,6 +3,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdatomic.h>
+#include "memory_arena.h"
 
 struct AudioPlayer {
     SDL_AudioDeviceID device_id;
@@ -10,11 +12,12 @@ struct AudioPlayer {
     int sample_rate;
     int channels;
     bool paused;
-    uint64_t total_samples_queued;  // Total de samples enfileirados desde o início
+    // Total de samples enfileirados desde o início (lido por outras threads)
+    atomic_uint_fast64_t total_samples_queued;
 };
 
 AudioPlayer* audio_player_init(int sample_rate, int channels) {
-    AudioPlayer* player = malloc(sizeof(AudioPlayer));
+    AudioPlayer* player = mem_alloc(sizeof(AudioPlayer));
     if (!player) {
         return NULL;
     }
@@ -23,13 +26,13 @@ AudioPlayer* audio_player_init(int sample_rate, int channels) {
     player->channels = channels;
     player->paused = false;
     player->device_id = 0;
-    player->total_samples_queued = 0;
+    atomic_init(&player->total_samples_queued, 0);
     
     // Inicializa SDL Audio se ainda não foi inicializado
     if (!SDL_WasInit(SDL_INIT_AUDIO)) {
         if (SDL_Init(SDL_INIT_AUDIO) < 0) {
             fprintf(stderr, "Erro ao inicializar SDL Audio: %s\n", SDL_GetError());
-            free(player);
+            mem_free(player);
             return NULL;
         }
     }
@@ -46,7 +49,7 @@ AudioPlayer* audio_player_init(int sample_rate, int channels) {
     player->device_id = SDL_OpenAudioDevice(NULL, 0, &player->spec, NULL, SDL_AUDIO_ALLOW_ANY_CHANGE);
     if (player->device_id == 0) {
         fprintf(stderr, "Erro ao abrir dispositivo de áudio: %s\n", SDL_GetError());
-        free(player);
+        mem_free(player);
         return NULL;
     }
     
@@ -63,7 +66,7 @@ void audio_player_free(AudioPlayer* player) {
         SDL_CloseAudioDevice(player->device_id);
     }
     
-    free(player);
+    mem_free(player);
 }
 
 int audio_player_queue(AudioPlayer* player, const int16_t* samples, int num_samples) {
@@ -82,7 +85,7 @@ int audio_player_queue(AudioPlayer* player, const int16_t* samples, int num_samp
     }
     
     // Atualiza contador total
-    player->total_samples_queued += num_samples;
+    atomic_fetch_add(&player->total_samples_queued, (uint64_t)num_samples);
     
     return num_samples;
 }
@@ -98,14 +101,19 @@ uint64_t audio_player_get_played_samples(AudioPlayer* player) {
     if (!player) return 0;
     
     int queued = audio_player_get_queued_samples(player);
+    uint64_t total = atomic_load(&player->total_samples_queued);
+    
+    // Fila limpa por outra thread entre as duas leituras
+    if ((uint64_t)queued > total) return 0;
+    
     // Samples reproduzidos = total enfileirado - ainda na fila
-    return player->total_samples_queued - queued;
+    return total - queued;
 }
 
 void audio_player_clear(AudioPlayer* player) {
     if (!player || player->device_id == 0) return;
     SDL_ClearQueuedAudio(player->device_id);
-    player->total_samples_queued = 0;  // Reseta contador ao limpar
+    atomic_store(&player->total_samples_queued, 0);  // Reseta contador ao limpar
 }
 
 void audio_player_pause(AudioPlayer* player) {
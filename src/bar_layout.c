@@ -0,0 +1,197 @@
+#include "bar_layout.h"
+#include <stdlib.h>
+#include <math.h>
+#include "memory_arena.h"
+
+#define BAR_MIN_FREQ 20.0
+#define BAR_MAX_FREQ 20000.0
+
+struct BarLayout {
+    BarLayoutConfig config;
+    bool valid;          // false = reconstruir na próxima atualização
+    int num_bins;
+    
+    BarSlot bars[BAR_LAYOUT_MAX_BARS];
+    
+    // Pesos da barra i: weights[offset[i] .. offset[i + 1]) sobre os bins
+    // consecutivos a partir de first_bin[i] (pesos somam 1)
+    int first_bin[BAR_LAYOUT_MAX_BARS];
+    int offset[BAR_LAYOUT_MAX_BARS + 1];
+    float* weights;
+    int weights_capacity;
+};
+
+static double hz_to_mel(double hz) {
+    return 2595.0 * log10(1.0 + hz / 700.0);
+}
+
+static double mel_to_hz(double mel) {
+    return 700.0 * (pow(10.0, mel / 2595.0) - 1.0);
+}
+
+// Frequência da borda t (0 = início, 1 = fim) da faixa exibida
+static double edge_frequency(BarScale scale, double min_freq, double max_freq, double t) {
+    if (scale == BAR_SCALE_MEL) {
+        double lo = hz_to_mel(min_freq);
+        double hi = hz_to_mel(max_freq);
+        return mel_to_hz(lo + (hi - lo) * t);
+    }
+    return min_freq * pow(max_freq / min_freq, t);
+}
+
+BarLayout* bar_layout_init(void) {
+    BarLayout* layout = mem_calloc(1, sizeof(BarLayout));
+    if (!layout) {
+        return NULL;
+    }
+    return layout;
+}
+
+void bar_layout_free(BarLayout* layout) {
+    if (!layout) return;
+    
+    if (layout->weights) {
+        mem_free(layout->weights);
+    }
+    mem_free(layout);
+}
+
+void bar_layout_invalidate(BarLayout* layout) {
+    if (!layout) return;
+    layout->valid = false;
+}
+
+// Calcula faixas de bins, pesos, retângulos e cores
+static bool build_layout(BarLayout* layout, const BarLayoutConfig* config, const ColorMapper* mapper) {
+    int num_bars = config->num_bars;
+    int num_bins = config->fft_size / 2 + 1;
+    double bin_hz = (double)config->sample_rate / config->fft_size;
+    double nyquist = config->sample_rate / 2.0;
+    double max_freq = nyquist < BAR_MAX_FREQ ? nyquist : BAR_MAX_FREQ;
+    
+    // Cada barra toca no máximo os bins da sua faixa mais os dois das bordas
+    int needed = num_bins + num_bars * 2;
+    if (needed > layout->weights_capacity) {
+        float* grown = mem_realloc(layout->weights, needed * sizeof(float));
+        if (!grown) {
+            return false;
+        }
+        layout->weights = grown;
+        layout->weights_capacity = needed;
+    }
+    
+    // Centraliza as barras usando 80% da largura
+    float total_width = config->width * 0.8f;
+    float start_x = (config->width - total_width) * 0.5f;
+    float slot_width = total_width / num_bars;
+    float spacing = slot_width >= 3.0f ? 1.0f : 0.0f;
+    
+    int cursor = 0;
+    for (int i = 0; i < num_bars; i++) {
+        // Faixa da barra em unidades de bin (o bin k cobre [k - 0.5, k + 0.5))
+        double f_lo = edge_frequency(config->scale, BAR_MIN_FREQ, max_freq, (double)i / num_bars);
+        double f_hi = edge_frequency(config->scale, BAR_MIN_FREQ, max_freq, (double)(i + 1) / num_bars);
+        double b_lo = f_lo / bin_hz;
+        double b_hi = f_hi / bin_hz;
+        
+        int k_lo = (int)floor(b_lo + 0.5);
+        int k_hi = (int)floor(b_hi + 0.5);
+        if (k_hi > num_bins - 1) k_hi = num_bins - 1;
+        if (k_lo > k_hi) k_lo = k_hi;
+        
+        layout->first_bin[i] = k_lo;
+        layout->offset[i] = cursor;
+        double total = 0.0;
+        for (int k = k_lo; k <= k_hi; k++) {
+            double lo = fmax(b_lo, k - 0.5);
+            double hi = fmin(b_hi, k + 0.5);
+            double w = hi > lo ? hi - lo : 0.0;
+            layout->weights[cursor++] = (float)w;
+            total += w;
+        }
+        
+        // Faixa acima do último bin: usa o último bin inteiro
+        if (total <= 0.0) {
+            for (int j = layout->offset[i]; j < cursor; j++) {
+                layout->weights[j] = 0.0f;
+            }
+            layout->weights[cursor - 1] = 1.0f;
+            total = 1.0;
+        }
+        for (int j = layout->offset[i]; j < cursor; j++) {
+            layout->weights[j] = (float)(layout->weights[j] / total);
+        }
+        
+        // Retângulo e cor base (frequência central mais variação de matiz)
+        BarSlot* bar = &layout->bars[i];
+        bar->x = start_x + i * slot_width + spacing * 0.5f;
+        bar->width = slot_width - spacing;
+        
+        double freq = sqrt(f_lo * f_hi);
+        RGBColor color = color_mapper_lut_frequency(mapper, freq);
+        double hue_shift = (double)i / num_bars * 60.0;
+        RGBColor shifted = color_mapper_lut_hsv(mapper,
+            (freq < 200 ? 0 : (freq < 2000 ? 120 : 240)) + hue_shift, 0.9, 0.9);
+        bar->color.r = (uint8_t)(color.r * 0.6 + shifted.r * 0.4);
+        bar->color.g = (uint8_t)(color.g * 0.6 + shifted.g * 0.4);
+        bar->color.b = (uint8_t)(color.b * 0.6 + shifted.b * 0.4);
+    }
+    layout->offset[num_bars] = cursor;
+    layout->num_bins = num_bins;
+    return true;
+}
+
+static bool same_config(const BarLayoutConfig* a, const BarLayoutConfig* b) {
+    return a->sample_rate == b->sample_rate && a->fft_size == b->fft_size &&
+           a->num_bars == b->num_bars && a->width == b->width && a->scale == b->scale;
+}
+
+bool bar_layout_update(BarLayout* layout, const BarLayoutConfig* config, const ColorMapper* mapper) {
+    if (!layout || !config || !mapper) return false;
+    
+    if (layout->valid && same_config(&layout->config, config)) {
+        return true;
+    }
+    
+    layout->valid = false;
+    if (config->sample_rate <= 0 || config->fft_size < 2 || config->width <= 0 ||
+        config->num_bars <= 0 || config->num_bars > BAR_LAYOUT_MAX_BARS) {
+        return false;
+    }
+    if (!build_layout(layout, config, mapper)) {
+        return false;
+    }
+    
+    layout->config = *config;
+    layout->valid = true;
+    return true;
+}
+
+int bar_layout_get_count(const BarLayout* layout) {
+    if (!layout || !layout->valid) return 0;
+    return layout->config.num_bars;
+}
+
+const BarSlot* bar_layout_get_bars(const BarLayout* layout) {
+    if (!layout) return NULL;
+    return layout->bars;
+}
+
+bool bar_layout_reduce(const BarLayout* layout, const double* magnitudes, int num_bins, float* energies) {
+    if (!layout || !layout->valid || !magnitudes || !energies || num_bins != layout->num_bins) {
+        return false;
+    }
+    
+    for (int i = 0; i < layout->config.num_bars; i++) {
+        const double* m = magnitudes + layout->first_bin[i];
+        const float* w = layout->weights + layout->offset[i];
+        int count = layout->offset[i + 1] - layout->offset[i];
+        
+        double energy = 0.0;
+        for (int j = 0; j < count; j++) {
+            energy += w[j] * m[j] * m[j];
+        }
+        energies[i] = (float)sqrt(energy);
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef BAR_LAYOUT_H
+#define BAR_LAYOUT_H
+
+#include <stdbool.h>
+#include "color_mapper.h"
+
+// Número máximo de barras de frequência
+#define BAR_LAYOUT_MAX_BARS 512
+
+// Espaçamento das barras no eixo de frequência
+typedef enum {
+    BAR_SCALE_LOG,   // Oitavas com a mesma largura (20 Hz até 20 kHz ou Nyquist)
+    BAR_SCALE_MEL    // Escala mel (mais resolução nos médios)
+} BarScale;
+
+// Parâmetros de que o layout depende; muda só em redimensionamento ou configuração
+typedef struct {
+    int sample_rate;
+    int fft_size;
+    int num_bars;
+    int width;        // Largura da janela (as barras ocupam 80%, centralizadas)
+    BarScale scale;
+} BarLayoutConfig;
+
+// Geometria e cor base de uma barra
+typedef struct {
+    float x;
+    float width;
+    RGBColor color;   // Cor com brilho máximo (escurecida pela altura a cada quadro)
+} BarSlot;
+
+// Layout das barras calculado uma vez por configuração: faixas de bins com
+// pesos (sobreposição de cada bin com a faixa da barra), retângulos e cores.
+// Por quadro resta só a redução de energia por barra.
+typedef struct BarLayout BarLayout;
+
+// Inicializa um layout vazio (sem barras até bar_layout_update)
+BarLayout* bar_layout_init(void);
+
+// Libera recursos do layout
+void bar_layout_free(BarLayout* layout);
+
+// Reconstrói o layout se a configuração mudou (ou após bar_layout_invalidate)
+// mapper: tabelas de cor usadas nas cores base
+// Retorna: false se a configuração for inválida ou faltar memória (layout vazio)
+bool bar_layout_update(BarLayout* layout, const BarLayoutConfig* config, const ColorMapper* mapper);
+
+// Força a reconstrução na próxima atualização (ex: troca de paleta)
+void bar_layout_invalidate(BarLayout* layout);
+
+// Retorna o número de barras do layout atual
+int bar_layout_get_count(const BarLayout* layout);
+
+// Retorna as barras do layout atual
+const BarSlot* bar_layout_get_bars(const BarLayout* layout);
+
+// Reduz o espectro à energia RMS ponderada de cada barra
+// magnitudes: magnitudes da FFT (num_bins = fft_size / 2 + 1)
+// energies: saída, uma por barra (tamanho = bar_layout_get_count)
+// Retorna: false se num_bins não corresponder ao layout
+bool bar_layout_reduce(const BarLayout* layout, const double* magnitudes, int num_bins, float* energies);
+
+#endif // BAR_LAYOUT_H
@@ -0,0 +1,453 @@
+// opendir, stat e mkdir (POSIX)
+#define _POSIX_C_SOURCE 200809L
+
+#include "batch_extractor.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <ctype.h>
+#include <math.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <SDL2/SDL.h>
+#include "audio_decoder.h"
+#include "audio_analyzer.h"
+#include "track_cache.h"
+#include "thread_pool.h"
+#include "frame_scheduler.h"
+#include "memory_arena.h"
+
+// Limite de faixas simultâneas (cada uma tem seu decodificador e analisador)
+#define BATCH_MAX_WORKERS 64
+
+#define BATCH_PATH_SIZE 4096
+
+// As cores por sample ficam desligadas: a tabela só precisa existir
+#define BATCH_COLOR_RESOLUTION 2
+
+// Loudness de um bloco em silêncio absoluto
+#define BATCH_SILENCE_DB -120.0
+
+// Extensões aceitas ao percorrer diretórios (arquivos citados diretamente
+// são sempre tentados)
+static const char* const audio_extensions[] = {
+    "wav", "mp3", "flac", "ogg", "oga", "opus", "m4a", "aac", "wma", "aif", "aiff", NULL
+};
+
+// Uma faixa do lote
+typedef struct {
+    char* path;
+    char* output;      // CSV de saída
+    long long size;    // Bytes (as maiores começam primeiro)
+} BatchTrack;
+
+// Estado de uma thread, reaproveitado entre faixas
+typedef struct {
+    atomic_flag busy;
+    AudioAnalyzer* analyzer;
+    int sample_rate;           // Taxa para a qual o analisador foi criado
+    AnalysisFrame* frame;
+    int16_t* block;
+} BatchWorker;
+
+typedef struct {
+    const BatchOptions* options;
+    BatchTrack* tracks;
+    int num_tracks;
+    BatchWorker* workers;
+    int num_workers;
+    
+    // Progresso (atualizado pelas threads ao fim de cada faixa)
+    uint64_t started;
+    atomic_int done;
+    atomic_int failed;
+    atomic_uint_fast64_t audio_ms;
+} BatchJob;
+
+// Lista de faixas em crescimento
+typedef struct {
+    BatchTrack* items;
+    int count;
+    int capacity;
+} TrackList;
+
+static char* copy_string(const char* text) {
+    size_t length = strlen(text) + 1;
+    char* copy = mem_alloc(length);
+    if (copy) {
+        memcpy(copy, text, length);
+    }
+    return copy;
+}
+
+static bool has_audio_extension(const char* name) {
+    const char* dot = strrchr(name, '.');
+    if (!dot) return false;
+    
+    for (int i = 0; audio_extensions[i]; i++) {
+        const char* a = dot + 1;
+        const char* b = audio_extensions[i];
+        while (*a && *b && tolower((unsigned char)*a) == *b) {
+            a++;
+            b++;
+        }
+        if (*a == '\0' && *b == '\0') {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool add_track(TrackList* list, const char* path, long long size) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 64;
+        BatchTrack* items = mem_realloc(list->items, capacity * sizeof(BatchTrack));
+        if (!items) return false;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    
+    BatchTrack* track = &list->items[list->count];
+    track->path = copy_string(path);
+    track->output = NULL;
+    track->size = size;
+    if (!track->path) return false;
+    list->count++;
+    return true;
+}
+
+// Acrescenta um arquivo ou, recursivamente, os arquivos de áudio de um diretório
+// named: true se o caminho foi citado diretamente (aceito com qualquer extensão)
+static bool collect_path(TrackList* list, const char* path, bool named) {
+    // Dentro de um diretório, links para diretórios não são seguidos (um link
+    // para um diretório acima faria a busca recursar sem fim); links para
+    // arquivos continuam valendo
+    struct stat st;
+    if ((named ? stat(path, &st) : lstat(path, &st)) != 0) {
+        fprintf(stderr, "Erro: caminho não encontrado: %s\n", path);
+        return named ? false : true;
+    }
+    if (S_ISLNK(st.st_mode) && (stat(path, &st) != 0 || S_ISDIR(st.st_mode))) {
+        return true;
+    }
+    
+    if (S_ISREG(st.st_mode)) {
+        if (!named && !has_audio_extension(path)) return true;
+        return add_track(list, path, (long long)st.st_size);
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        return true;
+    }
+    
+    DIR* dir = opendir(path);
+    if (!dir) {
+        fprintf(stderr, "Erro ao abrir diretório: %s\n", path);
+        return !named;
+    }
+    
+    bool ok = true;
+    struct dirent* entry;
+    while (ok && (entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;   // ".", ".." e ocultos
+        
+        char child[BATCH_PATH_SIZE];
+        int length = snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+        if (length < 0 || length >= (int)sizeof(child)) continue;
+        ok = collect_path(list, child, false);
+    }
+    closedir(dir);
+    return ok;
+}
+
+// Maiores primeiro: as faixas longas não ficam para o fim do lote
+static int compare_tracks(const void* a, const void* b) {
+    long long x = ((const BatchTrack*)a)->size;
+    long long y = ((const BatchTrack*)b)->size;
+    return (x < y) - (x > y);
+}
+
+// Nome do CSV de cada faixa: <diretório>/<nome sem extensão>.csv, com
+// sufixo -2, -3... quando duas faixas dariam o mesmo nome
+static bool assign_outputs(TrackList* list, const char* output_dir) {
+    for (int i = 0; i < list->count; i++) {
+        const char* path = list->items[i].path;
+        const char* slash = strrchr(path, '/');
+        const char* name = slash ? slash + 1 : path;
+        const char* dot = strrchr(name, '.');
+        int name_length = dot && dot != name ? (int)(dot - name) : (int)strlen(name);
+        
+        // Sem diretório de saída: ao lado do arquivo
+        int dir_length = output_dir ? (int)strlen(output_dir) : (slash ? (int)(slash - path) : 1);
+        const char* dir = output_dir ? output_dir : (slash ? path : ".");
+        
+        char output[BATCH_PATH_SIZE];
+        for (int copy = 1; ; copy++) {
+            if (copy == 1) {
+                snprintf(output, sizeof(output), "%.*s/%.*s.csv", dir_length, dir, name_length, name);
+            } else {
+                snprintf(output, sizeof(output), "%.*s/%.*s-%d.csv", dir_length, dir, name_length, name, copy);
+            }
+            
+            bool taken = false;
+            for (int j = 0; j < i && !taken; j++) {
+                taken = strcmp(list->items[j].output, output) == 0;
+            }
+            if (!taken) break;
+        }
+        
+        list->items[i].output = copy_string(output);
+        if (!list->items[i].output) return false;
+    }
+    return true;
+}
+
+static void free_tracks(TrackList* list) {
+    for (int i = 0; i < list->count; i++) {
+        mem_free(list->items[i].path);
+        if (list->items[i].output) mem_free(list->items[i].output);
+    }
+    if (list->items) {
+        mem_free(list->items);
+    }
+}
+
+// Pega uma thread livre (há tantas quanto itens simultâneos do pool)
+static BatchWorker* acquire_worker(BatchJob* job) {
+    for (;;) {
+        for (int i = 0; i < job->num_workers; i++) {
+            if (!atomic_flag_test_and_set(&job->workers[i].busy)) {
+                return &job->workers[i];
+            }
+        }
+    }
+}
+
+static void release_worker(BatchWorker* worker) {
+    atomic_flag_clear(&worker->busy);
+}
+
+// Loudness de um bloco (RMS em dBFS)
+static double block_loudness(const int16_t* samples, int num_samples) {
+    double sum = 0.0;
+    for (int i = 0; i < num_samples; i++) {
+        sum += (double)samples[i] * samples[i];
+    }
+    double rms = sqrt(sum / num_samples) / 32768.0;
+    return rms > 0.0 ? 20.0 * log10(rms) : BATCH_SILENCE_DB;
+}
+
+// Decodifica e analisa uma faixa inteira, gravando um quadro por linha
+// samples: recebe o número de samples analisados
+static bool extract_track(const BatchJob* job, BatchWorker* worker, const BatchTrack* track,
+                          uint64_t* samples, int* sample_rate) {
+    AudioDecoder* decoder = audio_decoder_init(track->path);
+    if (!decoder || !audio_decoder_is_valid(decoder)) {
+        if (decoder) audio_decoder_free(decoder);
+        return false;
+    }
+    
+    // O analisador da thread serve enquanto a taxa de amostragem for a mesma
+    int rate = audio_decoder_get_sample_rate(decoder);
+    if (!worker->analyzer || worker->sample_rate != rate) {
+        audio_analyzer_free(worker->analyzer);
+        worker->analyzer = audio_analyzer_init(rate, job->options->window_size, BATCH_COLOR_RESOLUTION);
+        worker->sample_rate = rate;
+        if (!worker->analyzer) {
+            audio_decoder_free(decoder);
+            return false;
+        }
+        audio_analyzer_set_colors(worker->analyzer, false);
+    }
+    audio_analyzer_reset(worker->analyzer);
+    
+    // Grava num arquivo temporário: um CSV só aparece completo
+    char partial[BATCH_PATH_SIZE];
+    snprintf(partial, sizeof(partial), "%s.part", track->output);
+    FILE* out = fopen(partial, "w");
+    if (!out) {
+        fprintf(stderr, "Erro ao criar %s\n", partial);
+        audio_decoder_free(decoder);
+        return false;
+    }
+    fprintf(out, "time_s,dominant_hz,low,mid,high,loudness_dbfs,onset_low,onset_mid,onset_high\n");
+    
+    // Faixa pré-calculada: <saída sem .csv>.swv, para o replay
+    TrackCacheWriter* writer = NULL;
+    if (job->options->write_tracks) {
+        char track_path[BATCH_PATH_SIZE];
+        snprintf(track_path, sizeof(track_path), "%.*s.swv",
+                 (int)strlen(track->output) - 4, track->output);
+        writer = track_cache_writer_open(track_path, track->path, rate,
+                                         job->options->window_size, job->options->hop);
+        if (!writer) {
+            fclose(out);
+            remove(partial);
+            audio_decoder_free(decoder);
+            return false;
+        }
+    }
+    
+    AnalysisFrame* frame = worker->frame;
+    bool written = true;
+    uint64_t position = 0;
+    int samples_read;
+    while ((samples_read = audio_decoder_read(decoder, worker->block, job->options->hop)) > 0) {
+        audio_analyzer_process(worker->analyzer, worker->block, samples_read, frame);
+        position += samples_read;
+        if (writer) {
+            written = track_cache_writer_add(writer, frame) && written;
+        }
+        if (!frame->spectrum_ready) continue;
+        
+        // Tempo no fim do bloco analisado
+        fprintf(out, "%.4f,%.1f,%.4f,%.4f,%.4f,%.2f,%d,%d,%d\n",
+                (double)position / rate, frame->dominant_freq,
+                frame->low_energy, frame->mid_energy, frame->high_energy,
+                block_loudness(worker->block, samples_read),
+                (frame->onsets & ANALYSIS_ONSET_LOW) != 0,
+                (frame->onsets & ANALYSIS_ONSET_MID) != 0,
+                (frame->onsets & ANALYSIS_ONSET_HIGH) != 0);
+    }
+    audio_decoder_free(decoder);
+    
+    bool ok = !ferror(out) && written;
+    ok = fclose(out) == 0 && ok;
+    if (writer) {
+        ok = track_cache_writer_close(writer, ok) && ok;
+    }
+    if (ok && rename(partial, track->output) != 0) {
+        fprintf(stderr, "Erro ao gravar %s\n", track->output);
+        ok = false;
+    }
+    if (!ok) {
+        remove(partial);
+    }
+    
+    *samples = position;
+    *sample_rate = rate;
+    return ok;
+}
+
+// Tarefa do pool: uma faixa
+static void process_track(void* arg, int index) {
+    BatchJob* job = arg;
+    const BatchTrack* track = &job->tracks[index];
+    
+    uint64_t t = frame_clock_now_ns();
+    BatchWorker* worker = acquire_worker(job);
+    uint64_t samples = 0;
+    int sample_rate = 0;
+    bool ok = extract_track(job, worker, track, &samples, &sample_rate);
+    release_worker(worker);
+    uint64_t now = frame_clock_now_ns();
+    
+    double audio_seconds = sample_rate > 0 ? (double)samples / sample_rate : 0.0;
+    uint64_t total_ms = atomic_fetch_add(&job->audio_ms, (uint64_t)(audio_seconds * 1000.0)) +
+                        (uint64_t)(audio_seconds * 1000.0);
+    int done = atomic_fetch_add(&job->done, 1) + 1;
+    if (!ok) {
+        atomic_fetch_add(&job->failed, 1);
+    }
+    
+    // Uma linha por faixa: progresso e vazão acumulada
+    double elapsed = (now - job->started) / 1e9;
+    if (ok) {
+        fprintf(stderr, "[%d/%d] %s: %.1f s de áudio em %.2f s | %.2f faixas/s, %.0fx tempo real\n",
+                done, job->num_tracks, track->path, audio_seconds, (now - t) / 1e9,
+                done / elapsed, total_ms / 1000.0 / elapsed);
+    } else {
+        fprintf(stderr, "[%d/%d] Erro ao processar %s\n", done, job->num_tracks, track->path);
+    }
+}
+
+static void free_workers(BatchWorker* workers, int count) {
+    for (int i = 0; i < count; i++) {
+        audio_analyzer_free(workers[i].analyzer);
+        if (workers[i].frame) mem_free(workers[i].frame);
+        if (workers[i].block) mem_free(workers[i].block);
+    }
+    mem_free(workers);
+}
+
+int batch_extract(const char* const* inputs, int num_inputs, const BatchOptions* options) {
+    if (!inputs || num_inputs <= 0 || !options || options->window_size <= 0 ||
+        options->window_size > ANALYSIS_MAX_WINDOW || options->hop <= 0 ||
+        options->hop > ANALYSIS_MAX_BLOCK) {
+        return -1;
+    }
+    
+    if (options->output_dir) {
+        struct stat st;
+        if (stat(options->output_dir, &st) != 0 && mkdir(options->output_dir, 0755) != 0) {
+            fprintf(stderr, "Erro ao criar diretório de saída: %s\n", options->output_dir);
+            return -1;
+        }
+    }
+    
+    TrackList list = {0};
+    bool ok = true;
+    for (int i = 0; i < num_inputs && ok; i++) {
+        ok = collect_path(&list, inputs[i], true);
+    }
+    if (ok && list.count > 0) {
+        qsort(list.items, list.count, sizeof(BatchTrack), compare_tracks);
+        ok = assign_outputs(&list, options->output_dir);
+    }
+    if (!ok || list.count == 0) {
+        if (ok) fprintf(stderr, "Nenhum arquivo de áudio encontrado\n");
+        free_tracks(&list);
+        return -1;
+    }
+    
+    // Uma thread por núcleo, sem passar do número de faixas
+    int threads = options->threads > 0 ? options->threads : SDL_GetCPUCount();
+    if (threads > BATCH_MAX_WORKERS) threads = BATCH_MAX_WORKERS;
+    if (threads > list.count) threads = list.count;
+    if (threads < 1) threads = 1;
+    
+    BatchJob job = {0};
+    job.options = options;
+    job.tracks = list.items;
+    job.num_tracks = list.count;
+    job.num_workers = threads;
+    atomic_init(&job.done, 0);
+    atomic_init(&job.failed, 0);
+    atomic_init(&job.audio_ms, 0);
+    
+    job.workers = mem_calloc(threads, sizeof(BatchWorker));
+    for (int i = 0; job.workers && i < threads; i++) {
+        atomic_flag_clear(&job.workers[i].busy);
+        job.workers[i].frame = mem_alloc(sizeof(AnalysisFrame));
+        job.workers[i].block = mem_alloc(options->hop * sizeof(int16_t));
+        ok = ok && job.workers[i].frame && job.workers[i].block;
+    }
+    
+    // A thread chamadora também processa faixas
+    ThreadPool* pool = threads > 1 ? thread_pool_init(threads - 1) : NULL;
+    if (!job.workers || !ok || (threads > 1 && !pool)) {
+        fprintf(stderr, "Erro: memória insuficiente para o lote\n");
+        thread_pool_free(pool);
+        if (job.workers) free_workers(job.workers, threads);
+        free_tracks(&list);
+        return -1;
+    }
+    
+    fprintf(stderr, "Processando %d faixas em %d threads...\n", list.count, threads);
+    job.started = frame_clock_now_ns();
+    thread_pool_parallel_for(pool, list.count, process_track, &job);
+    
+    double elapsed = (frame_clock_now_ns() - job.started) / 1e9;
+    double audio_seconds = atomic_load(&job.audio_ms) / 1000.0;
+    int failed = atomic_load(&job.failed);
+    fprintf(stderr, "Concluído: %d faixas (%d com erro), %.1f min de áudio em %.1f s (%.0fx tempo real)\n",
+            list.count, failed, audio_seconds / 60.0, elapsed,
+            elapsed > 0.0 ? audio_seconds / elapsed : 0.0);
+    
+    thread_pool_free(pool);
+    free_workers(job.workers, threads);
+    free_tracks(&list);
+    return failed;
+}
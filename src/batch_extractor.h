@@ -0,0 +1,27 @@
+#ifndef BATCH_EXTRACTOR_H
+#define BATCH_EXTRACTOR_H
+
+// Extração de características em lote: decodifica e analisa faixas inteiras
+// em paralelo (uma faixa por thread) e grava um CSV por faixa com um quadro
+// de análise por linha: tempo, frequência dominante, energias das bandas,
+// loudness (RMS em dBFS) e ataques por banda.
+
+#include <stdbool.h>
+
+// Parâmetros do lote
+typedef struct {
+    const char* output_dir;   // Diretório dos CSVs (NULL = ao lado de cada arquivo)
+    int threads;              // Faixas processadas ao mesmo tempo (0 = núcleos disponíveis)
+    int window_size;          // Janela FFT (até ANALYSIS_MAX_WINDOW)
+    int hop;                  // Samples por quadro de análise (até ANALYSIS_MAX_BLOCK)
+    bool write_tracks;        // Grava também a faixa pré-calculada (.swv) ao lado do CSV
+} BatchOptions;
+
+// Processa arquivos e diretórios (percorridos recursivamente, só extensões
+// de áudio). Cada thread reaproveita o próprio analisador entre faixas e lê
+// a faixa em blocos: a memória não depende da duração nem do número de faixas.
+// Progresso e vazão vão para stderr.
+// Retorna: número de faixas que falharam (-1 se o lote não pôde começar)
+int batch_extract(const char* const* inputs, int num_inputs, const BatchOptions* options);
+
+#endif // BATCH_EXTRACTOR_H
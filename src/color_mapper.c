@@ -1,6 +1,31 @@
 #include "color_mapper.h"
 #include <math.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include "memory_arena.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define LUT_FREQ_MIN 20.0
+#define LUT_FREQ_MAX 20000.0
+
+struct ColorMapper {
+    int resolution;
+    bool interpolate;
+    ColorPalette palette;
+    
+    // Tabela frequência → RGB indexada por log2(frequência)
+    RGBColor* frequency_lut;
+    float freq_scale;   // posição = log2(f) * freq_scale + freq_offset
+    float freq_offset;
+    
+    // Tabela matiz → RGB com saturação e brilho máximos (canais em [0, 1]);
+    // s e v são aplicados na consulta: canal = v * (1 - s * (1 - puro))
+    float* hue_lut;     // resolution * 3 floats
+    float hue_scale;    // posição = h * hue_scale
+};
 
 // Mapeia frequência para cor usando escala logarítmica
 // Baixas frequências (20-200 Hz) → Vermelho/Laranja
@@ -27,6 +52,11 @@ RGBColor color_mapper_frequency_to_rgb(double frequency) {
 }
 
 RGBColor color_mapper_bands_to_rgb(double low_energy, double mid_energy, double high_energy) {
+    // Cores das bandas: HSV (0, 0.8, 0.9), (120, 0.8, 0.9) e (240, 0.8, 0.9)
+    static const RGBColor low_color = {229, 45, 45};    // Vermelho
+    static const RGBColor mid_color = {45, 229, 45};    // Verde
+    static const RGBColor high_color = {45, 45, 229};   // Azul
+    
     // Normaliza as energias
     double total = low_energy + mid_energy + high_energy;
     if (total < 0.001) {
@@ -40,10 +70,6 @@ RGBColor color_mapper_bands_to_rgb(double low_energy, double mid_energy, double
     double high_norm = high_energy / total;
     
     // Calcula cor ponderada
-    RGBColor low_color = color_mapper_hsv_to_rgb(0, 0.8, 0.9);    // Vermelho
-    RGBColor mid_color = color_mapper_hsv_to_rgb(120, 0.8, 0.9);  // Verde
-    RGBColor high_color = color_mapper_hsv_to_rgb(240, 0.8, 0.9); // Azul
-    
     RGBColor result;
     result.r = (uint8_t)(low_color.r * low_norm + mid_color.r * mid_norm + high_color.r * high_norm);
     result.g = (uint8_t)(low_color.g * low_norm + mid_color.g * mid_norm + high_color.g * high_norm);
@@ -96,3 +122,364 @@ RGBColor color_mapper_hsv_to_rgb(double h, double s, double v) {
     return rgb;
 }
 
+ColorPalette color_mapper_default_palette(void) {
+    ColorPalette palette = {0.0, 240.0, 0.8, 0.9};
+    return palette;
+}
+
+// log2 aproximado (erro ~1e-4): expoente IEEE + polinômio de ln na mantissa.
+// Suficiente para indexar a tabela sem chamar log10 por elemento.
+static inline float fast_log2f(float x) {
+    union { float f; uint32_t i; } u = { x };
+    float exponent = (float)((int)((u.i >> 23) & 0xFF) - 127);
+    u.i = (u.i & 0x007FFFFFu) | 0x3F800000u;  // mantissa em [1, 2)
+    float m = u.f;
+    float ln_m = -1.7417939f + (2.8212026f + (-1.4699568f + (0.44717955f - 0.056570851f * m) * m) * m) * m;
+    return exponent + ln_m * 1.4426950f;  // 1 / ln(2)
+}
+
+// Consulta a tabela de frequências a partir de uma posição já calculada
+static inline RGBColor lut_frequency_at(const ColorMapper* mapper, float pos) {
+    int last = mapper->resolution - 1;
+    if (pos < 0.0f) pos = 0.0f;
+    if (pos > (float)last) pos = (float)last;
+    
+    if (!mapper->interpolate) {
+        return mapper->frequency_lut[(int)(pos + 0.5f)];
+    }
+    
+    int i = (int)pos;
+    if (i >= last) {
+        return mapper->frequency_lut[last];
+    }
+    float t = pos - (float)i;
+    RGBColor a = mapper->frequency_lut[i];
+    RGBColor b = mapper->frequency_lut[i + 1];
+    
+    RGBColor result;
+    result.r = (uint8_t)(a.r + (b.r - a.r) * t);
+    result.g = (uint8_t)(a.g + (b.g - a.g) * t);
+    result.b = (uint8_t)(a.b + (b.b - a.b) * t);
+    return result;
+}
+
+ColorMapper* color_mapper_init(int resolution, const ColorPalette* palette) {
+    if (resolution < 2) {
+        return NULL;
+    }
+    
+    ColorMapper* mapper = mem_alloc(sizeof(ColorMapper));
+    if (!mapper) {
+        return NULL;
+    }
+    
+    mapper->resolution = resolution;
+    mapper->interpolate = true;
+    mapper->palette = palette ? *palette : color_mapper_default_palette();
+    mapper->frequency_lut = mem_alloc(resolution * sizeof(RGBColor));
+    mapper->hue_lut = mem_alloc(resolution * 3 * sizeof(float));
+    
+    if (!mapper->frequency_lut || !mapper->hue_lut) {
+        if (mapper->hue_lut) mem_free(mapper->hue_lut);
+        if (mapper->frequency_lut) mem_free(mapper->frequency_lut);
+        mem_free(mapper);
+        return NULL;
+    }
+    
+    // Tabela de frequências: entradas igualmente espaçadas em log entre 20 Hz e 20 kHz
+    double log_min = log2(LUT_FREQ_MIN);
+    double log_max = log2(LUT_FREQ_MAX);
+    mapper->freq_scale = (float)((resolution - 1) / (log_max - log_min));
+    mapper->freq_offset = (float)(-log_min * (resolution - 1) / (log_max - log_min));
+    
+    const ColorPalette* p = &mapper->palette;
+    for (int i = 0; i < resolution; i++) {
+        double normalized = (double)i / (resolution - 1);
+        double h = p->hue_start + normalized * (p->hue_end - p->hue_start);
+        mapper->frequency_lut[i] = color_mapper_hsv_to_rgb(h, p->saturation, p->value);
+    }
+    
+    // Tabela de matizes em [0, 360) com s = v = 1. Os canais HSV são lineares
+    // por partes na matiz, então com interpolação o resultado é exato quando
+    // a resolução é múltipla de 6.
+    mapper->hue_scale = (float)(resolution / 360.0);
+    for (int i = 0; i < resolution; i++) {
+        double h = (double)i * 360.0 / resolution;
+        int sector = (int)(h / 60.0) % 6;
+        double f = (h / 60.0) - (int)(h / 60.0);
+        double r, g, b;
+        
+        switch (sector) {
+            case 0: r = 1.0;     g = f;       b = 0.0;     break;
+            case 1: r = 1.0 - f; g = 1.0;     b = 0.0;     break;
+            case 2: r = 0.0;     g = 1.0;     b = f;       break;
+            case 3: r = 0.0;     g = 1.0 - f; b = 1.0;     break;
+            case 4: r = f;       g = 0.0;     b = 1.0;     break;
+            case 5:
+            default: r = 1.0;    g = 0.0;     b = 1.0 - f; break;
+        }
+        
+        mapper->hue_lut[i * 3 + 0] = (float)r;
+        mapper->hue_lut[i * 3 + 1] = (float)g;
+        mapper->hue_lut[i * 3 + 2] = (float)b;
+    }
+    
+    return mapper;
+}
+
+void color_mapper_free(ColorMapper* mapper) {
+    if (!mapper) return;
+    
+    if (mapper->hue_lut) {
+        mem_free(mapper->hue_lut);
+    }
+    if (mapper->frequency_lut) {
+        mem_free(mapper->frequency_lut);
+    }
+    
+    mem_free(mapper);
+}
+
+void color_mapper_set_interpolation(ColorMapper* mapper, bool enabled) {
+    if (!mapper) return;
+    mapper->interpolate = enabled;
+}
+
+RGBColor color_mapper_lut_frequency(const ColorMapper* mapper, double frequency) {
+    if (!mapper) {
+        return color_mapper_frequency_to_rgb(frequency);
+    }
+    
+    if (frequency < LUT_FREQ_MIN) frequency = LUT_FREQ_MIN;
+    if (frequency > LUT_FREQ_MAX) frequency = LUT_FREQ_MAX;
+    
+    float pos = fast_log2f((float)frequency) * mapper->freq_scale + mapper->freq_offset;
+    return lut_frequency_at(mapper, pos);
+}
+
+RGBColor color_mapper_lut_hsv(const ColorMapper* mapper, double h, double s, double v) {
+    if (!mapper) {
+        return color_mapper_hsv_to_rgb(h, s, v);
+    }
+    
+    int res = mapper->resolution;
+    float pos = (float)h * mapper->hue_scale;
+    int i = (int)floorf(pos);
+    float t = pos - (float)i;
+    
+    // Matiz circular: reduz o índice para [0, res) sem laços
+    i %= res;
+    if (i < 0) i += res;
+    
+    float r, g, b;
+    const float* c0 = &mapper->hue_lut[i * 3];
+    if (mapper->interpolate) {
+        const float* c1 = &mapper->hue_lut[((i + 1) == res ? 0 : i + 1) * 3];
+        r = c0[0] + (c1[0] - c0[0]) * t;
+        g = c0[1] + (c1[1] - c0[1]) * t;
+        b = c0[2] + (c1[2] - c0[2]) * t;
+    } else {
+        if (t >= 0.5f) {
+            c0 = &mapper->hue_lut[((i + 1) == res ? 0 : i + 1) * 3];
+        }
+        r = c0[0];
+        g = c0[1];
+        b = c0[2];
+    }
+    
+    float fs = (float)s;
+    float scale = (float)v * 255.0f;
+    RGBColor rgb;
+    rgb.r = (uint8_t)((1.0f - fs * (1.0f - r)) * scale);
+    rgb.g = (uint8_t)((1.0f - fs * (1.0f - g)) * scale);
+    rgb.b = (uint8_t)((1.0f - fs * (1.0f - b)) * scale);
+    return rgb;
+}
+
+void color_mapper_lut_frequencies(const ColorMapper* mapper, const double* frequencies,
+                                  RGBColor* out, int count) {
+    if (!frequencies || !out || count <= 0) return;
+    
+    if (!mapper) {
+        for (int i = 0; i < count; i++) {
+            out[i] = color_mapper_frequency_to_rgb(frequencies[i]);
+        }
+        return;
+    }
+    
+    int i = 0;
+#if defined(__SSE2__)
+    // Calcula 4 posições por vez (log2 vetorizado); a leitura da tabela é escalar
+    const __m128 fmin = _mm_set1_ps((float)LUT_FREQ_MIN);
+    const __m128 fmax = _mm_set1_ps((float)LUT_FREQ_MAX);
+    const __m128 scale = _mm_set1_ps(mapper->freq_scale);
+    const __m128 offset = _mm_set1_ps(mapper->freq_offset);
+    const __m128i mant_mask = _mm_set1_epi32(0x007FFFFF);
+    const __m128i one_bits = _mm_set1_epi32(0x3F800000);
+    float pos[4];
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(frequencies + i));
+        __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(frequencies + i + 2));
+        __m128 f = _mm_movelh_ps(lo, hi);
+        f = _mm_min_ps(_mm_max_ps(f, fmin), fmax);
+        
+        __m128i bits = _mm_castps_si128(f);
+        __m128 exponent = _mm_cvtepi32_ps(
+            _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xFF)),
+                          _mm_set1_epi32(127)));
+        __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mant_mask), one_bits));
+        
+        __m128 ln_m = _mm_sub_ps(_mm_set1_ps(0.44717955f), _mm_mul_ps(_mm_set1_ps(0.056570851f), m));
+        ln_m = _mm_add_ps(_mm_set1_ps(-1.4699568f), _mm_mul_ps(ln_m, m));
+        ln_m = _mm_add_ps(_mm_set1_ps(2.8212026f), _mm_mul_ps(ln_m, m));
+        ln_m = _mm_add_ps(_mm_set1_ps(-1.7417939f), _mm_mul_ps(ln_m, m));
+        __m128 log2_f = _mm_add_ps(exponent, _mm_mul_ps(ln_m, _mm_set1_ps(1.4426950f)));
+        
+        _mm_storeu_ps(pos, _mm_add_ps(_mm_mul_ps(log2_f, scale), offset));
+        out[i + 0] = lut_frequency_at(mapper, pos[0]);
+        out[i + 1] = lut_frequency_at(mapper, pos[1]);
+        out[i + 2] = lut_frequency_at(mapper, pos[2]);
+        out[i + 3] = lut_frequency_at(mapper, pos[3]);
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = color_mapper_lut_frequency(mapper, frequencies[i]);
+    }
+}
+
+void color_mapper_bands_to_rgb_batch(const double* low, const double* mid, const double* high,
+                                     RGBColor* out, int count) {
+    if (!low || !mid || !high || !out || count <= 0) return;
+    
+    int i = 0;
+#if defined(__SSE2__)
+    // Mesmas cores de color_mapper_bands_to_rgb: canal "cheio" 229, demais 45
+    const __m128d full = _mm_set1_pd(229.0);
+    const __m128d dim = _mm_set1_pd(45.0);
+    const __m128d threshold = _mm_set1_pd(0.001);
+    
+    for (; i + 2 <= count; i += 2) {
+        __m128d l = _mm_loadu_pd(low + i);
+        __m128d m = _mm_loadu_pd(mid + i);
+        __m128d h = _mm_loadu_pd(high + i);
+        __m128d total = _mm_add_pd(_mm_add_pd(l, m), h);
+        __m128d valid = _mm_cmpge_pd(total, threshold);
+        __m128d inv = _mm_and_pd(_mm_div_pd(_mm_set1_pd(1.0), total), valid);
+        
+        __m128d ln = _mm_mul_pd(l, inv);
+        __m128d mn = _mm_mul_pd(m, inv);
+        __m128d hn = _mm_mul_pd(h, inv);
+        
+        __m128d r = _mm_add_pd(_mm_mul_pd(full, ln), _mm_mul_pd(dim, _mm_add_pd(mn, hn)));
+        __m128d g = _mm_add_pd(_mm_mul_pd(full, mn), _mm_mul_pd(dim, _mm_add_pd(ln, hn)));
+        __m128d b = _mm_add_pd(_mm_mul_pd(full, hn), _mm_mul_pd(dim, _mm_add_pd(ln, mn)));
+        
+        int32_t ri[4], gi[4], bi[4];
+        _mm_storeu_si128((__m128i*)ri, _mm_cvttpd_epi32(r));
+        _mm_storeu_si128((__m128i*)gi, _mm_cvttpd_epi32(g));
+        _mm_storeu_si128((__m128i*)bi, _mm_cvttpd_epi32(b));
+        
+        for (int k = 0; k < 2; k++) {
+            out[i + k].r = (uint8_t)ri[k];
+            out[i + k].g = (uint8_t)gi[k];
+            out[i + k].b = (uint8_t)bi[k];
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = color_mapper_bands_to_rgb(low[i], mid[i], high[i]);
+    }
+}
+
+#if defined(__SSE2__)
+// Calcula 4 cores RGBA32 moduladas pela amplitude de 4 samples (já em int32)
+static inline __m128i amplitude_blend_4(__m128i s, const __m128 k[3], const __m128 m[3],
+                                        __m128i alpha_bits) {
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    __m128 amp = _mm_andnot_ps(sign_mask, _mm_mul_ps(_mm_cvtepi32_ps(s), _mm_set1_ps(1.0f / 32768.0f)));
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 max = _mm_set1_ps(255.0f);
+    
+    __m128i r = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(k[0], _mm_mul_ps(m[0], amp)), zero), max));
+    __m128i g = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(k[1], _mm_mul_ps(m[1], amp)), zero), max));
+    __m128i b = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(k[2], _mm_mul_ps(m[2], amp)), zero), max));
+    
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    __m128i packed = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 24), _mm_slli_epi32(g, 16)),
+                                  _mm_slli_epi32(b, 8));
+#else
+    __m128i packed = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_slli_epi32(b, 16));
+#endif
+    return _mm_or_si128(packed, alpha_bits);
+}
+#endif
+
+static inline uint8_t amplitude_channel(float k, float m, int16_t sample) {
+    float amp = fabsf((float)sample * (1.0f / 32768.0f));
+    float v = k + m * amp;
+    if (v < 0.0f) v = 0.0f;
+    if (v > 255.0f) v = 255.0f;
+    return (uint8_t)v;
+}
+
+void color_mapper_amplitude_blend_rgba32(RGBColor base, float base_weight,
+                                         RGBColor accent, float accent_weight,
+                                         const int16_t* samples, uint8_t alpha,
+                                         uint32_t* out, int count) {
+    if (!samples || !out || count <= 0) return;
+    
+    // canal = k + m * amplitude
+    float k[3] = {base.r * base_weight, base.g * base_weight, base.b * base_weight};
+    float m[3] = {accent.r * accent_weight, accent.g * accent_weight, accent.b * accent_weight};
+    
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128 kv[3] = {_mm_set1_ps(k[0]), _mm_set1_ps(k[1]), _mm_set1_ps(k[2])};
+    const __m128 mv[3] = {_mm_set1_ps(m[0]), _mm_set1_ps(m[1]), _mm_set1_ps(m[2])};
+    const __m128i alpha_bits = _mm_set1_epi32((int32_t)COLOR_RGBA32(0, 0, 0, alpha));
+    
+    for (; i + 8 <= count; i += 8) {
+        __m128i s16 = _mm_loadu_si128((const __m128i*)(samples + i));
+        // Estende int16 → int32 com sinal
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s16, s16), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s16, s16), 16);
+        _mm_storeu_si128((__m128i*)(out + i), amplitude_blend_4(lo, kv, mv, alpha_bits));
+        _mm_storeu_si128((__m128i*)(out + i + 4), amplitude_blend_4(hi, kv, mv, alpha_bits));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = COLOR_RGBA32(amplitude_channel(k[0], m[0], samples[i]),
+                              amplitude_channel(k[1], m[1], samples[i]),
+                              amplitude_channel(k[2], m[2], samples[i]),
+                              alpha);
+    }
+}
+
+void color_mapper_amplitude_blend(RGBColor base, float base_weight,
+                                  RGBColor accent, float accent_weight,
+                                  const int16_t* samples, RGBColor* out, int count) {
+    if (!samples || !out || count <= 0) return;
+    
+    // Processa em blocos: versão vetorizada em RGBA32 e desempacota para RGB
+    uint32_t packed[256];
+    for (int start = 0; start < count; start += 256) {
+        int n = count - start < 256 ? count - start : 256;
+        color_mapper_amplitude_blend_rgba32(base, base_weight, accent, accent_weight,
+                                            samples + start, 255, packed, n);
+        const uint8_t* bytes = (const uint8_t*)packed;
+        for (int i = 0; i < n; i++) {
+            out[start + i].r = bytes[i * 4 + 0];
+            out[start + i].g = bytes[i * 4 + 1];
+            out[start + i].b = bytes[i * 4 + 2];
+        }
+    }
+}
+
+void color_mapper_pack_rgba32(const RGBColor* colors, uint8_t alpha, uint32_t* out, int count) {
+    if (!colors || !out || count <= 0) return;
+    
+    for (int i = 0; i < count; i++) {
+        out[i] = COLOR_RGBA32(colors[i].r, colors[i].g, colors[i].b, alpha);
+    }
+}
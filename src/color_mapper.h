@@ -2,6 +2,7 @@
 #define COLOR_MAPPER_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 typedef struct {
     uint8_t r;
@@ -9,6 +10,32 @@ typedef struct {
     uint8_t b;
 } RGBColor;
 
+// Paleta das tabelas de cor: a matiz vai de hue_start (20 Hz) a hue_end (20 kHz)
+// em escala logarítmica, com saturação e brilho fixos
+typedef struct {
+    double hue_start;
+    double hue_end;
+    double saturation;
+    double value;
+} ColorPalette;
+
+// Cor empacotada em 32 bits com bytes na ordem R, G, B, A na memória
+// (SDL_PIXELFORMAT_RGBA32), pronta para upload em texturas
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define COLOR_RGBA32(r, g, b, a) \
+    (((uint32_t)(r) << 24) | ((uint32_t)(g) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(a))
+#else
+#define COLOR_RGBA32(r, g, b, a) \
+    ((uint32_t)(r) | ((uint32_t)(g) << 8) | ((uint32_t)(b) << 16) | ((uint32_t)(a) << 24))
+#endif
+
+// Resolução padrão das tabelas de cor (múltipla de 6 para HSV exato com
+// interpolação); analisador e visualizador usam a mesma para as cores baterem
+#define COLOR_MAPPER_DEFAULT_RESOLUTION 1536
+
+// Mapeador com tabelas pré-calculadas (frequência → RGB e matiz → RGB)
+typedef struct ColorMapper ColorMapper;
+
 // Mapeia uma frequência para uma cor RGB
 // frequency: frequência em Hz
 // Retorna: cor RGB correspondente
@@ -24,5 +51,53 @@ RGBColor color_mapper_bands_to_rgb(double low_freq, double mid_freq, double high
 // Converte HSV para RGB
 RGBColor color_mapper_hsv_to_rgb(double h, double s, double v);
 
-#endif // COLOR_MAPPER_H
+// Retorna a paleta padrão (vermelho → azul, igual a color_mapper_frequency_to_rgb)
+ColorPalette color_mapper_default_palette(void);
+
+// Inicializa o mapeador e pré-calcula as tabelas
+// resolution: número de entradas de cada tabela (ex: 1024)
+// palette: paleta usada na tabela de frequências (NULL = paleta padrão)
+ColorMapper* color_mapper_init(int resolution, const ColorPalette* palette);
+
+// Libera recursos do mapeador
+void color_mapper_free(ColorMapper* mapper);
+
+// Ativa/desativa interpolação linear entre entradas vizinhas das tabelas
+void color_mapper_set_interpolation(ColorMapper* mapper, bool enabled);
 
+// Mapeia frequência para cor usando a tabela logarítmica
+RGBColor color_mapper_lut_frequency(const ColorMapper* mapper, double frequency);
+
+// Converte HSV para RGB usando a tabela de matizes
+// (h em graus, qualquer valor; s e v em [0, 1])
+RGBColor color_mapper_lut_hsv(const ColorMapper* mapper, double h, double s, double v);
+
+// ---- Mapeamento em lote (SSE2 quando disponível) ----
+
+// Mapeia um array de frequências usando a tabela logarítmica
+// frequencies: frequências em Hz
+// out: cores de saída (tamanho = count)
+void color_mapper_lut_frequencies(const ColorMapper* mapper, const double* frequencies,
+                                  RGBColor* out, int count);
+
+// Mapeia arrays de energias de bandas (mesmo resultado de color_mapper_bands_to_rgb)
+// low, mid, high: energias por elemento (tamanho = count)
+void color_mapper_bands_to_rgb_batch(const double* low, const double* mid, const double* high,
+                                     RGBColor* out, int count);
+
+// Modula uma cor pela amplitude de cada sample:
+// out[i] = base * base_weight + accent * accent_weight * |samples[i]| / 32768
+void color_mapper_amplitude_blend(RGBColor base, float base_weight,
+                                  RGBColor accent, float accent_weight,
+                                  const int16_t* samples, RGBColor* out, int count);
+
+// Igual a color_mapper_amplitude_blend, mas gera RGBA32 com alpha fixo
+void color_mapper_amplitude_blend_rgba32(RGBColor base, float base_weight,
+                                         RGBColor accent, float accent_weight,
+                                         const int16_t* samples, uint8_t alpha,
+                                         uint32_t* out, int count);
+
+// Empacota um array de RGBColor em RGBA32 com alpha fixo
+void color_mapper_pack_rgba32(const RGBColor* colors, uint8_t alpha, uint32_t* out, int count);
+
+#endif // COLOR_MAPPER_H
@@ -1,64 +1,161 @@
 #include "fft_analyzer.h"
 #include <stdlib.h>
+#include <stdio.h>
 #include <math.h>
 #include <string.h>
+#include "fixed_fft.h"
+#include "memory_arena.h"
+
+#ifndef SOUNDWAVE_FFT_FIXED
 #include <fftw3.h>
+#include <SDL2/SDL.h>
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-struct FFTAnalyzer {
-    int sample_rate;
-    int window_size;
+#ifndef SOUNDWAVE_FFT_FIXED
+// O planejador do FFTW não é reentrante: criar e destruir planos é
+// serializado (fftw_execute pode rodar em paralelo, um plano por analisador)
+static SDL_SpinLock planner_lock = 0;
+
+// Estado do backend FFTW
+typedef struct {
     fftw_plan plan;
     double* input;
     fftw_complex* output;
     double* window;  // Janela de Hanning para reduzir aliasing
+} FFTWState;
+#endif
+
+struct FFTAnalyzer {
+    int sample_rate;
+    int window_size;
+    FFTBackend backend;
+#ifndef SOUNDWAVE_FFT_FIXED
+    FFTWState fftw;
+#endif
+    FixedFFT* fixed;
 };
 
-FFTAnalyzer* fft_analyzer_init(int sample_rate, int window_size) {
-    FFTAnalyzer* analyzer = malloc(sizeof(FFTAnalyzer));
-    if (!analyzer) {
-        return NULL;
+#ifndef SOUNDWAVE_FFT_FIXED
+static void fftw_state_free(FFTWState* state) {
+    if (state->plan) {
+        SDL_AtomicLock(&planner_lock);
+        fftw_destroy_plan(state->plan);
+        SDL_AtomicUnlock(&planner_lock);
     }
-    
-    analyzer->sample_rate = sample_rate;
-    analyzer->window_size = window_size;
-    
+    if (state->window) {
+        mem_free(state->window);
+    }
+    if (state->input) {
+        fftw_free(state->input);
+    }
+    if (state->output) {
+        fftw_free(state->output);
+    }
+}
+
+static bool fftw_state_init(FFTWState* state, int window_size) {
     // Aloca buffers para FFT
-    analyzer->input = fftw_alloc_real(window_size);
-    analyzer->output = fftw_alloc_complex(window_size / 2 + 1);
-    
-    if (!analyzer->input || !analyzer->output) {
-        if (analyzer->input) fftw_free(analyzer->input);
-        if (analyzer->output) fftw_free(analyzer->output);
-        free(analyzer);
-        return NULL;
+    state->input = fftw_alloc_real(window_size);
+    state->output = fftw_alloc_complex(window_size / 2 + 1);
+    state->window = mem_alloc(window_size * sizeof(double));
+    if (!state->input || !state->output || !state->window) {
+        fftw_state_free(state);
+        return false;
     }
     
     // Cria plano FFT
-    analyzer->plan = fftw_plan_dft_r2c_1d(window_size, analyzer->input, analyzer->output, FFTW_ESTIMATE);
+    SDL_AtomicLock(&planner_lock);
+    state->plan = fftw_plan_dft_r2c_1d(window_size, state->input, state->output, FFTW_ESTIMATE);
+    SDL_AtomicUnlock(&planner_lock);
+    if (!state->plan) {
+        fftw_state_free(state);
+        return false;
+    }
+    
+    // Precalcula janela de Hanning
+    for (int i = 0; i < window_size; i++) {
+        state->window[i] = 0.5 * (1.0 - cos(2.0 * M_PI * i / (window_size - 1)));
+    }
+    return true;
+}
+
+// Janela, FFT e magnitudes |X[k]| pelo FFTW
+static void fftw_state_magnitudes(FFTWState* state, int window_size, const int16_t* samples,
+                                  double* magnitudes) {
+    // Aplica janela e normaliza
+    for (int i = 0; i < window_size; i++) {
+        state->input[i] = (double)samples[i] * state->window[i] / 32768.0;
+    }
     
-    if (!analyzer->plan) {
-        fftw_free(analyzer->input);
-        fftw_free(analyzer->output);
-        free(analyzer);
+    // Executa FFT
+    fftw_execute(state->plan);
+    
+    for (int i = 0; i <= window_size / 2; i++) {
+        double real = state->output[i][0];
+        double imag = state->output[i][1];
+        magnitudes[i] = sqrt(real * real + imag * imag);
+    }
+}
+#endif
+
+bool fft_analyzer_backend_available(FFTBackend backend) {
+#ifdef SOUNDWAVE_FFT_FIXED
+    return backend == FFT_BACKEND_FIXED;
+#else
+    return backend == FFT_BACKEND_FFTW || backend == FFT_BACKEND_FIXED;
+#endif
+}
+
+const char* fft_analyzer_backend_name(FFTBackend backend) {
+    switch (backend) {
+    case FFT_BACKEND_FFTW:
+        return "fftw";
+    case FFT_BACKEND_FIXED:
+        return "fixed";
+    }
+    return "?";
+}
+
+FFTAnalyzer* fft_analyzer_init(int sample_rate, int window_size) {
+    return fft_analyzer_init_backend(sample_rate, window_size, FFT_BACKEND_DEFAULT);
+}
+
+FFTAnalyzer* fft_analyzer_init_backend(int sample_rate, int window_size, FFTBackend backend) {
+    if (!fft_analyzer_backend_available(backend)) {
+        fprintf(stderr, "Erro: backend FFT %s não compilado\n", fft_analyzer_backend_name(backend));
         return NULL;
     }
     
-    // Precalcula janela de Hanning
-    analyzer->window = malloc(window_size * sizeof(double));
-    if (!analyzer->window) {
-        fftw_destroy_plan(analyzer->plan);
-        fftw_free(analyzer->input);
-        fftw_free(analyzer->output);
-        free(analyzer);
+    FFTAnalyzer* analyzer = mem_calloc(1, sizeof(FFTAnalyzer));
+    if (!analyzer) {
         return NULL;
     }
     
-    for (int i = 0; i < window_size; i++) {
-        analyzer->window[i] = 0.5 * (1.0 - cos(2.0 * M_PI * i / (window_size - 1)));
+    analyzer->sample_rate = sample_rate;
+    analyzer->window_size = window_size;
+    analyzer->backend = backend;
+    
+    bool ok = false;
+    if (backend == FFT_BACKEND_FIXED) {
+        analyzer->fixed = fixed_fft_init(window_size);
+        ok = analyzer->fixed != NULL;
+        if (!ok) {
+            fprintf(stderr, "Erro: FFT em ponto fixo exige janela potência de 2 (%d)\n", window_size);
+        }
+    }
+#ifndef SOUNDWAVE_FFT_FIXED
+    if (backend == FFT_BACKEND_FFTW) {
+        ok = fftw_state_init(&analyzer->fftw, window_size);
+    }
+#endif
+    
+    if (!ok) {
+        fft_analyzer_free(analyzer);
+        return NULL;
     }
     
     return analyzer;
@@ -67,20 +164,12 @@ FFTAnalyzer* fft_analyzer_init(int sample_rate, int window_size) {
 void fft_analyzer_free(FFTAnalyzer* analyzer) {
     if (!analyzer) return;
     
-    if (analyzer->plan) {
-        fftw_destroy_plan(analyzer->plan);
-    }
-    if (analyzer->window) {
-        free(analyzer->window);
-    }
-    if (analyzer->input) {
-        fftw_free(analyzer->input);
-    }
-    if (analyzer->output) {
-        fftw_free(analyzer->output);
-    }
+#ifndef SOUNDWAVE_FFT_FIXED
+    fftw_state_free(&analyzer->fftw);
+#endif
+    fixed_fft_free(analyzer->fixed);
     
-    free(analyzer);
+    mem_free(analyzer);
 }
 
 double fft_analyzer_analyze(FFTAnalyzer* analyzer, const int16_t* samples, double* frequencies) {
@@ -88,23 +177,23 @@ double fft_analyzer_analyze(FFTAnalyzer* analyzer, const int16_t* samples, doubl
         return 0.0;
     }
     
-    // Aplica janela e normaliza
-    for (int i = 0; i < analyzer->window_size; i++) {
-        analyzer->input[i] = (double)samples[i] * analyzer->window[i] / 32768.0;
+    // Janela, FFT e magnitudes no backend escolhido
+    if (analyzer->fixed) {
+        fixed_fft_magnitudes(analyzer->fixed, samples, frequencies);
     }
+#ifndef SOUNDWAVE_FFT_FIXED
+    else {
+        fftw_state_magnitudes(&analyzer->fftw, analyzer->window_size, samples, frequencies);
+    }
+#endif
     
-    // Executa FFT
-    fftw_execute(analyzer->plan);
-    
-    // Calcula magnitudes e encontra frequência dominante
+    // Normaliza e encontra frequência dominante
     double max_magnitude = 0.0;
     int max_bin = 0;
     double max_frequency = 0.0;
     
     for (int i = 0; i <= analyzer->window_size / 2; i++) {
-        double real = analyzer->output[i][0];
-        double imag = analyzer->output[i][1];
-        double magnitude = sqrt(real * real + imag * imag);
+        double magnitude = frequencies[i];
         
         // Normaliza pela metade do tamanho da janela (exceto DC e Nyquist)
         if (i > 0 && i < analyzer->window_size / 2) {
@@ -2,14 +2,38 @@
 #define FFT_ANALYZER_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 typedef struct FFTAnalyzer FFTAnalyzer;
 
+// Backends da transformada (a mesma API e a mesma escala de magnitudes)
+typedef enum {
+    FFT_BACKEND_FFTW,    // FFTW3 em double (ausente quando compilado com FFT_BACKEND=fixed)
+    FFT_BACKEND_FIXED    // Ponto fixo sobre os samples int16 (só janelas potência de 2)
+} FFTBackend;
+
+// Backend usado por fft_analyzer_init (escolhido na compilação)
+#ifdef SOUNDWAVE_FFT_FIXED
+#define FFT_BACKEND_DEFAULT FFT_BACKEND_FIXED
+#else
+#define FFT_BACKEND_DEFAULT FFT_BACKEND_FFTW
+#endif
+
 // Inicializa o analisador FFT
 // sample_rate: taxa de amostragem do áudio
 // window_size: tamanho da janela FFT (ex: 2048)
 FFTAnalyzer* fft_analyzer_init(int sample_rate, int window_size);
 
+// Inicializa o analisador com um backend específico (comparações, benchmarks)
+// Retorna: NULL se o backend não foi compilado ou não aceita o tamanho
+FFTAnalyzer* fft_analyzer_init_backend(int sample_rate, int window_size, FFTBackend backend);
+
+// Verifica se o backend foi compilado
+bool fft_analyzer_backend_available(FFTBackend backend);
+
+// Retorna o nome do backend ("fftw", "fixed")
+const char* fft_analyzer_backend_name(FFTBackend backend);
+
 // Libera recursos do analisador
 void fft_analyzer_free(FFTAnalyzer* analyzer);
 
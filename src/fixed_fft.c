@@ -0,0 +1,165 @@
+#include "fixed_fft.h"
+#include <stdlib.h>
+#include <math.h>
+#include "memory_arena.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Twiddles em Q30 (1.0 = 1 << 30, representável) e janela em Q15
+#define FIXED_TWIDDLE_SHIFT 30
+
+// Entrada janelada: sample (Q15) x janela (Q15) >> 3 = valor normalizado
+// em Q27, com folga para |re| + |im| não passar de 2^31 nas borboletas
+#define FIXED_INPUT_SHIFT 3
+#define FIXED_INPUT_ONE (1 << 27)
+
+#define FIXED_MAX_SIZE 65536
+
+struct FixedFFT {
+    int size;              // N (entrada real)
+    int half;              // M = N/2 (FFT complexa)
+    int16_t* window;       // Hann em Q15
+    int32_t* twiddle_re;   // cos(2πk/M), k < M/2 (Q30)
+    int32_t* twiddle_im;   // -sin(2πk/M)
+    int32_t* split_re;     // cos(2πk/N), k <= M (separação do espectro real)
+    int32_t* split_im;     // -sin(2πk/N)
+    int* reverse;          // Índice com os bits invertidos (M entradas)
+    int32_t* re;
+    int32_t* im;
+};
+
+// Multiplicação por twiddle Q30 com arredondamento
+static inline int32_t mul_q30(int64_t a, int32_t b) {
+    return (int32_t)((a * b + (1LL << (FIXED_TWIDDLE_SHIFT - 1))) >> FIXED_TWIDDLE_SHIFT);
+}
+
+static int32_t to_q30(double value) {
+    return (int32_t)lrint(value * (1 << FIXED_TWIDDLE_SHIFT));
+}
+
+FixedFFT* fixed_fft_init(int size) {
+    if (size < 4 || size > FIXED_MAX_SIZE || (size & (size - 1)) != 0) {
+        return NULL;
+    }
+    
+    FixedFFT* fft = mem_calloc(1, sizeof(FixedFFT));
+    if (!fft) {
+        return NULL;
+    }
+    
+    int half = size / 2;
+    fft->size = size;
+    fft->half = half;
+    fft->window = mem_alloc(size * sizeof(int16_t));
+    fft->twiddle_re = mem_alloc((half / 2 + 1) * sizeof(int32_t));
+    fft->twiddle_im = mem_alloc((half / 2 + 1) * sizeof(int32_t));
+    fft->split_re = mem_alloc((half + 1) * sizeof(int32_t));
+    fft->split_im = mem_alloc((half + 1) * sizeof(int32_t));
+    fft->reverse = mem_alloc(half * sizeof(int));
+    fft->re = mem_alloc(half * sizeof(int32_t));
+    fft->im = mem_alloc(half * sizeof(int32_t));
+    
+    if (!fft->window || !fft->twiddle_re || !fft->twiddle_im || !fft->split_re ||
+        !fft->split_im || !fft->reverse || !fft->re || !fft->im) {
+        fixed_fft_free(fft);
+        return NULL;
+    }
+    
+    // Mesma janela do backend FFTW, arredondada para Q15
+    for (int i = 0; i < size; i++) {
+        double w = 0.5 * (1.0 - cos(2.0 * M_PI * i / (size - 1)));
+        int q = (int)lrint(w * 32768.0);
+        fft->window[i] = (int16_t)(q > 32767 ? 32767 : q);
+    }
+    
+    for (int k = 0; k <= half / 2; k++) {
+        fft->twiddle_re[k] = to_q30(cos(2.0 * M_PI * k / half));
+        fft->twiddle_im[k] = to_q30(-sin(2.0 * M_PI * k / half));
+    }
+    for (int k = 0; k <= half; k++) {
+        fft->split_re[k] = to_q30(cos(2.0 * M_PI * k / size));
+        fft->split_im[k] = to_q30(-sin(2.0 * M_PI * k / size));
+    }
+    
+    int bits = 0;
+    while ((1 << bits) < half) bits++;
+    for (int i = 0; i < half; i++) {
+        int r = 0;
+        for (int b = 0; b < bits; b++) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        fft->reverse[i] = r;
+    }
+    
+    return fft;
+}
+
+void fixed_fft_free(FixedFFT* fft) {
+    if (!fft) return;
+    
+    if (fft->im) mem_free(fft->im);
+    if (fft->re) mem_free(fft->re);
+    if (fft->reverse) mem_free(fft->reverse);
+    if (fft->split_im) mem_free(fft->split_im);
+    if (fft->split_re) mem_free(fft->split_re);
+    if (fft->twiddle_im) mem_free(fft->twiddle_im);
+    if (fft->twiddle_re) mem_free(fft->twiddle_re);
+    if (fft->window) mem_free(fft->window);
+    mem_free(fft);
+}
+
+void fixed_fft_magnitudes(FixedFFT* fft, const int16_t* samples, double* magnitudes) {
+    if (!fft || !samples || !magnitudes) return;
+    
+    int half = fft->half;
+    int32_t* re = fft->re;
+    int32_t* im = fft->im;
+    
+    // Pares de samples viram um complexo (par = real, ímpar = imaginário),
+    // já janelados e na ordem de bits invertidos
+    for (int n = 0; n < half; n++) {
+        int r = fft->reverse[n];
+        re[r] = ((int32_t)samples[2 * n] * fft->window[2 * n]) >> FIXED_INPUT_SHIFT;
+        im[r] = ((int32_t)samples[2 * n + 1] * fft->window[2 * n + 1]) >> FIXED_INPUT_SHIFT;
+    }
+    
+    // Borboletas radix-2 (decimação no tempo); cada estágio divide por 2,
+    // então a saída é a DFT dividida por M
+    for (int length = 2; length <= half; length <<= 1) {
+        int span = length / 2;
+        int stride = half / length;
+        for (int start = 0; start < half; start += length) {
+            for (int j = 0; j < span; j++) {
+                int32_t wr = fft->twiddle_re[j * stride];
+                int32_t wi = fft->twiddle_im[j * stride];
+                int a = start + j;
+                int b = a + span;
+                int32_t tr = mul_q30(re[b], wr) - mul_q30(im[b], wi);
+                int32_t ti = mul_q30(re[b], wi) + mul_q30(im[b], wr);
+                int32_t ar = re[a];
+                int32_t ai = im[a];
+                re[a] = (ar + tr + 1) >> 1;
+                im[a] = (ai + ti + 1) >> 1;
+                re[b] = (ar - tr + 1) >> 1;
+                im[b] = (ai - ti + 1) >> 1;
+            }
+        }
+    }
+    
+    // Separa o espectro real: X[k] = E[k] + W^k·O[k], com
+    // E = (Z[k] + conj Z[M-k]) / 2 e O = -i (Z[k] - conj Z[M-k]) / 2
+    double scale = (double)half / FIXED_INPUT_ONE;
+    for (int k = 0; k <= half; k++) {
+        int i = k == half ? 0 : k;
+        int c = k == 0 ? 0 : half - k;
+        int64_t er = ((int64_t)re[i] + re[c]) / 2;
+        int64_t ei = ((int64_t)im[i] - im[c]) / 2;
+        int64_t or_ = ((int64_t)im[i] + im[c]) / 2;
+        int64_t oi = ((int64_t)re[c] - re[i]) / 2;
+        int64_t xr = er + mul_q30(or_, fft->split_re[k]) - mul_q30(oi, fft->split_im[k]);
+        int64_t xi = ei + mul_q30(or_, fft->split_im[k]) + mul_q30(oi, fft->split_re[k]);
+        magnitudes[k] = sqrt((double)xr * xr + (double)xi * xi) * scale;
+    }
+}
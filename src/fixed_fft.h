@@ -0,0 +1,25 @@
+#ifndef FIXED_FFT_H
+#define FIXED_FFT_H
+
+#include <stdint.h>
+
+// FFT real em ponto fixo, sem FFTW e sem double na transformada: janela de
+// Hann em Q15 aplicada direto nos samples int16, FFT complexa radix-2 de
+// size/2 pontos em int32 (twiddles Q30, escala 1/2 por estágio, sem
+// overflow) e separação do espectro da entrada real.
+typedef struct FixedFFT FixedFFT;
+
+// Inicializa a FFT (tabelas de twiddles, janela e reversão de bits)
+// size: potência de 2, de 4 a 65536
+// Retorna: NULL se o tamanho não é suportado
+FixedFFT* fixed_fft_init(int size);
+
+// Libera recursos da FFT
+void fixed_fft_free(FixedFFT* fft);
+
+// Aplica a janela e calcula as magnitudes |X[k]|, k = 0..size/2, na escala
+// de uma entrada normalizada em [-1, 1) (a mesma do backend FFTW)
+// samples: size samples
+void fixed_fft_magnitudes(FixedFFT* fft, const int16_t* samples, double* magnitudes);
+
+#endif // FIXED_FFT_H
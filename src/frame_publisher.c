@@ -0,0 +1,133 @@
+// shm_open, ftruncate, mmap e clock_gettime (POSIX)
+#define _POSIX_C_SOURCE 200809L
+
+#include "frame_publisher.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <time.h>
+#include "memory_arena.h"
+
+// Tamanho máximo do nome do objeto (com a barra inicial)
+#define PUBLISHER_NAME_SIZE 64
+
+_Static_assert(SHM_MAX_BINS >= ANALYSIS_MAX_WINDOW / 2 + 1, "SHM_MAX_BINS menor que o espectro da análise");
+_Static_assert(ANALYSIS_ONSET_LOW == SHM_ONSET_LOW && ANALYSIS_ONSET_MID == SHM_ONSET_MID &&
+               ANALYSIS_ONSET_HIGH == SHM_ONSET_HIGH, "bits de ataque divergentes");
+
+struct FramePublisher {
+    char name[PUBLISHER_NAME_SIZE];
+    ShmHeader* shm;
+    uint64_t published;
+};
+
+FramePublisher* frame_publisher_init(const char* name, int sample_rate, int window_size) {
+    if (!name || !name[0] || sample_rate <= 0 || window_size <= 0) {
+        return NULL;
+    }
+    
+    FramePublisher* publisher = mem_calloc(1, sizeof(FramePublisher));
+    if (!publisher) {
+        return NULL;
+    }
+    
+    snprintf(publisher->name, sizeof(publisher->name), "%s%s", name[0] == '/' ? "" : "/", name);
+    
+    // Um objeto deixado por um produtor que não encerrou direito é substituído
+    // (leitores antigos continuam com o mapeamento deles)
+    shm_unlink(publisher->name);
+    int fd = shm_open(publisher->name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Erro ao criar memória compartilhada %s: %s\n", publisher->name, strerror(errno));
+        mem_free(publisher);
+        return NULL;
+    }
+    
+    void* mapped = MAP_FAILED;
+    if (ftruncate(fd, sizeof(ShmHeader)) == 0) {
+        mapped = mmap(NULL, sizeof(ShmHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "Erro ao mapear memória compartilhada %s: %s\n", publisher->name, strerror(errno));
+        shm_unlink(publisher->name);
+        mem_free(publisher);
+        return NULL;
+    }
+    
+    // ftruncate zera o objeto: todos os seqlocks começam pares e latest = 0
+    ShmHeader* shm = mapped;
+    shm->version = SHM_VERSION;
+    shm->num_slots = SHM_SLOTS;
+    shm->max_bins = SHM_MAX_BINS;
+    shm->slot_size = sizeof(ShmSlot);
+    shm->sample_rate = (uint32_t)sample_rate;
+    shm->window_size = (uint32_t)window_size;
+    atomic_store_explicit(&shm->alive, 1u, memory_order_relaxed);
+    atomic_store_explicit(&shm->latest, 0, memory_order_relaxed);
+    
+    // Leitores só aceitam o cabeçalho depois do magic
+    atomic_store_explicit(&shm->magic, SHM_MAGIC, memory_order_release);
+    
+    publisher->shm = shm;
+    return publisher;
+}
+
+void frame_publisher_free(FramePublisher* publisher) {
+    if (!publisher) return;
+    
+    atomic_store_explicit(&publisher->shm->alive, 0u, memory_order_release);
+    munmap(publisher->shm, sizeof(ShmHeader));
+    shm_unlink(publisher->name);
+    mem_free(publisher);
+}
+
+// Relógio dos carimbos: CLOCK_MONOTONIC, comparável entre processos
+static uint64_t monotonic_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void frame_publisher_publish(FramePublisher* publisher, const AnalysisFrame* frame) {
+    if (!publisher || !frame) return;
+    
+    uint64_t number = publisher->published + 1;
+    ShmSlot* slot = &publisher->shm->slots[number % SHM_SLOTS];
+    
+    // Seqlock: ímpar durante a escrita (o fence impede que os dados passem à frente)
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    
+    // Escreve direto no slot mapeado (sem cópia intermediária)
+    ShmFrame* data = &slot->data;
+    int num_bins = frame->num_bins < SHM_MAX_BINS ? frame->num_bins : SHM_MAX_BINS;
+    data->frame = number;
+    data->timestamp_ns = monotonic_now_ns();
+    data->position = frame->position;
+    data->dominant_freq = (float)frame->dominant_freq;
+    data->low_energy = (float)frame->low_energy;
+    data->mid_energy = (float)frame->mid_energy;
+    data->high_energy = (float)frame->high_energy;
+    data->onsets = frame->onsets;
+    data->spectrum_ready = frame->spectrum_ready ? 1u : 0u;
+    data->num_bins = (uint32_t)num_bins;
+    for (int i = 0; i < num_bins; i++) {
+        data->spectrum[i] = (float)frame->frequencies[i];
+    }
+    
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+    atomic_store_explicit(&publisher->shm->latest, number, memory_order_release);
+    publisher->published = number;
+}
+
+uint64_t frame_publisher_get_published(const FramePublisher* publisher) {
+    if (!publisher) return 0;
+    return publisher->published;
+}
@@ -0,0 +1,29 @@
+#ifndef FRAME_PUBLISHER_H
+#define FRAME_PUBLISHER_H
+
+#include <stdint.h>
+#include "audio_analyzer.h"
+#include "shm_layout.h"
+
+// Publica cada quadro de análise num anel em memória compartilhada POSIX
+// (layout em shm_layout.h) para outros processos locais, como controladores
+// de iluminação, sem que eles precisem decodificar e analisar o áudio de novo
+typedef struct FramePublisher FramePublisher;
+
+// Cria (ou recria) o objeto de memória compartilhada
+// name: nome POSIX (ex: "/soundwave"; a barra inicial é acrescentada se faltar)
+// Retorna: NULL se o objeto não pôde ser criado ou mapeado
+FramePublisher* frame_publisher_init(const char* name, int sample_rate, int window_size);
+
+// Marca o produtor como encerrado, desmapeia e remove o nome
+// (leitores que já mapearam continuam lendo os últimos quadros)
+void frame_publisher_free(FramePublisher* publisher);
+
+// Copia o quadro para o próximo slot do anel (uma única thread produtora;
+// nunca espera pelos leitores)
+void frame_publisher_publish(FramePublisher* publisher, const AnalysisFrame* frame);
+
+// Retorna o número de quadros publicados
+uint64_t frame_publisher_get_published(const FramePublisher* publisher);
+
+#endif // FRAME_PUBLISHER_H
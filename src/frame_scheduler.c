@@ -0,0 +1,109 @@
+#include "frame_scheduler.h"
+#include <stdlib.h>
+#include <SDL2/SDL.h>
+#include "memory_arena.h"
+
+#define NS_PER_SECOND 1000000000ULL
+#define NS_PER_MS 1000000ULL
+
+struct FrameScheduler {
+    FramePacing pacing;
+    uint64_t period_ns;
+    uint64_t next_deadline;   // FIXED: prazo do próximo quadro
+    uint64_t last_wake;       // DISPLAY: retorno da espera anterior
+    uint64_t dropped;
+};
+
+uint64_t frame_clock_now_ns(void) {
+    uint64_t frequency = SDL_GetPerformanceFrequency();
+    
+    // Divide em segundos e resto para não estourar 64 bits
+    uint64_t counter = SDL_GetPerformanceCounter();
+    return (counter / frequency) * NS_PER_SECOND + (counter % frequency) * NS_PER_SECOND / frequency;
+}
+
+void frame_clock_sleep_until(uint64_t deadline_ns) {
+    uint64_t now = frame_clock_now_ns();
+    if (deadline_ns <= now) return;
+    
+    // SDL_Delay tem resolução de 1 ms: dorme a parte inteira; com menos de
+    // 1 ms restante dorme 1 ms, para quem chama em laço não girar a CPU
+    uint64_t remaining_ms = (deadline_ns - now) / NS_PER_MS;
+    SDL_Delay((Uint32)(remaining_ms > 0 ? remaining_ms : 1));
+}
+
+FrameScheduler* frame_scheduler_init(double fps, FramePacing pacing) {
+    if (fps <= 0.0) {
+        return NULL;
+    }
+    
+    FrameScheduler* sched = mem_alloc(sizeof(FrameScheduler));
+    if (!sched) {
+        return NULL;
+    }
+    
+    sched->pacing = pacing;
+    sched->period_ns = (uint64_t)(NS_PER_SECOND / fps);
+    sched->last_wake = frame_clock_now_ns();
+    sched->next_deadline = sched->last_wake + sched->period_ns;
+    sched->dropped = 0;
+    return sched;
+}
+
+void frame_scheduler_free(FrameScheduler* sched) {
+    if (!sched) return;
+    mem_free(sched);
+}
+
+// Prazos absolutos: dorme até o prazo ou, se ele já passou, pula os perdidos
+static int wait_fixed(FrameScheduler* sched) {
+    uint64_t now = frame_clock_now_ns();
+    uint64_t deadline = sched->next_deadline;
+    
+    if (now < deadline) {
+        frame_clock_sleep_until(deadline);
+        sched->next_deadline = deadline + sched->period_ns;
+        return 0;
+    }
+    
+    // Prazos inteiros perdidos viram descartes; o quadro atual começa já
+    uint64_t missed = (now - deadline) / sched->period_ns;
+    sched->next_deadline = deadline + (missed + 1) * sched->period_ns;
+    return (int)missed;
+}
+
+// Vsync: o present já esperou o monitor; mede o intervalo para achar descartes
+static int wait_display(FrameScheduler* sched) {
+    uint64_t now = frame_clock_now_ns();
+    uint64_t interval = now - sched->last_wake;
+    
+    // O present voltou cedo demais: sem vsync efetivo, espera como no modo FIXED
+    if (interval < sched->period_ns / 2) {
+        frame_clock_sleep_until(sched->last_wake + sched->period_ns);
+        now = frame_clock_now_ns();
+        interval = now - sched->last_wake;
+    }
+    sched->last_wake = now;
+    
+    // Intervalo de N períodos (arredondado) = N - 1 refreshes sem quadro novo
+    uint64_t periods = (interval + sched->period_ns / 2) / sched->period_ns;
+    return periods > 1 ? (int)(periods - 1) : 0;
+}
+
+int frame_scheduler_wait(FrameScheduler* sched) {
+    if (!sched) return 0;
+    
+    int dropped = sched->pacing == FRAME_PACING_DISPLAY ? wait_display(sched) : wait_fixed(sched);
+    sched->dropped += dropped;
+    return dropped;
+}
+
+uint64_t frame_scheduler_get_dropped(const FrameScheduler* sched) {
+    if (!sched) return 0;
+    return sched->dropped;
+}
+
+uint64_t frame_scheduler_get_period_ns(const FrameScheduler* sched) {
+    if (!sched) return 0;
+    return sched->period_ns;
+}
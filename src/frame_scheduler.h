@@ -0,0 +1,44 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Ritmo dos quadros
+typedef enum {
+    FRAME_PACING_FIXED,    // Prazos absolutos a cada 1 / fps (dorme até o próximo)
+    FRAME_PACING_DISPLAY   // Acompanha o vsync do present; só dorme se o vsync não bloquear
+} FramePacing;
+
+// Relógio monotônico (não recua e não depende do tempo de CPU do processo)
+// Retorna: nanossegundos desde um instante arbitrário
+uint64_t frame_clock_now_ns(void);
+
+// Dorme até o instante (em frame_clock_now_ns) sem espera ocupada
+// (acorda no máximo 1 ms antes, ou até 1 ms depois se faltava menos de
+// 1 ms; prazos absolutos não acumulam o erro)
+void frame_clock_sleep_until(uint64_t deadline_ns);
+
+// Agenda os quadros da renderização por prazos no relógio monotônico.
+// Quadros atrasados não são compensados com rajadas: os prazos perdidos
+// são contados como quadros descartados e o próximo prazo é realinhado.
+typedef struct FrameScheduler FrameScheduler;
+
+// Inicializa o agendador
+// fps: quadros por segundo (no modo DISPLAY, a taxa do monitor)
+FrameScheduler* frame_scheduler_init(double fps, FramePacing pacing);
+
+// Libera recursos do agendador
+void frame_scheduler_free(FrameScheduler* sched);
+
+// Espera o prazo do próximo quadro (chamar após o present)
+// Retorna: quadros descartados desde a chamada anterior
+int frame_scheduler_wait(FrameScheduler* sched);
+
+// Retorna o total de quadros descartados
+uint64_t frame_scheduler_get_dropped(const FrameScheduler* sched);
+
+// Retorna o intervalo nominal entre quadros em nanossegundos
+uint64_t frame_scheduler_get_period_ns(const FrameScheduler* sched);
+
+#endif // FRAME_SCHEDULER_H
@@ -0,0 +1,348 @@
+#include "frame_trace.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "memory_arena.h"
+
+#define FRAME_TRACE_VERSION 1
+
+// Opções booleanas no cabeçalho
+#define TRACE_OPTION_SPECTROGRAM (1u << 0)
+#define TRACE_OPTION_TRAILS (1u << 1)
+#define TRACE_OPTION_GLOW (1u << 2)
+#define TRACE_OPTION_SOFTWARE (1u << 3)
+
+// Flags de um registro
+#define TRACE_RECORD_HAS_FRAME (1u << 0)
+#define TRACE_RECORD_FRESH (1u << 1)
+#define TRACE_RECORD_ANALYSIS (1u << 2)   // Quadro de análise em seguida
+
+#define TRACE_MAX_BINS (ANALYSIS_MAX_WINDOW / 2 + 1)
+
+typedef struct {
+    char magic[4];             // "SWTR"
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t record_size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t sample_rate;
+    uint32_t fft_size;
+    uint32_t particles;
+    uint32_t particle_blend;
+    uint32_t bars;
+    uint32_t bar_scale;
+    uint32_t options;          // TRACE_OPTION_*
+    uint32_t reserved;
+    uint64_t particle_seed;
+    double history_seconds;
+    double layer_rates[FRAME_TRACE_MAX_LAYERS];
+} FrameTraceHeader;
+
+typedef struct {
+    uint64_t time_ns;
+    uint64_t played;
+    uint32_t flags;            // TRACE_RECORD_*
+    uint32_t particle_capacity;
+    float line_scale;
+    uint16_t waveform_step;
+    uint16_t bars;
+} FrameTraceRecord;
+
+typedef struct {
+    uint64_t sequence;
+    uint64_t position;
+    double dominant_freq;
+    double energies[3];        // Graves, médios, agudos
+    uint32_t onsets;
+    uint16_t num_samples;      // Seguidos de num_samples int16
+    uint16_t num_bins;         // Seguidos de num_bins float se spectrum_ready
+    uint8_t spectrum_ready;
+    uint8_t reserved[7];
+} FrameTraceAnalysis;
+
+_Static_assert(sizeof(FrameTraceHeader) == 104, "cabeçalho .swt deve ter 104 bytes");
+_Static_assert(sizeof(FrameTraceRecord) == 32, "registro .swt deve ter 32 bytes");
+_Static_assert(sizeof(FrameTraceAnalysis) == 64, "quadro de análise .swt deve ter 64 bytes");
+
+struct FrameTraceWriter {
+    FILE* file;
+    bool has_last;
+    uint64_t last_sequence;
+    uint64_t last_position;
+    float* spectrum;
+    bool ok;
+};
+
+struct FrameTrace {
+    FILE* file;
+    FrameTraceConfig config;
+    bool has_analysis;         // Algum quadro de análise já foi lido
+    float* spectrum;
+};
+
+FrameTraceWriter* frame_trace_writer_open(const char* path, const FrameTraceConfig* config) {
+    if (!path || !config || config->width <= 0 || config->height <= 0 || config->sample_rate <= 0 ||
+        config->fft_size <= 0 || config->fft_size > ANALYSIS_MAX_WINDOW) {
+        return NULL;
+    }
+    
+    FrameTraceWriter* writer = mem_calloc(1, sizeof(FrameTraceWriter));
+    if (!writer) {
+        return NULL;
+    }
+    writer->spectrum = mem_alloc(TRACE_MAX_BINS * sizeof(float));
+    if (!writer->spectrum) {
+        mem_free(writer);
+        return NULL;
+    }
+    
+    FrameTraceHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "SWTR", 4);
+    header.version = FRAME_TRACE_VERSION;
+    header.header_size = sizeof(FrameTraceHeader);
+    header.record_size = sizeof(FrameTraceRecord);
+    header.width = (uint32_t)config->width;
+    header.height = (uint32_t)config->height;
+    header.sample_rate = (uint32_t)config->sample_rate;
+    header.fft_size = (uint32_t)config->fft_size;
+    header.particles = (uint32_t)(config->particles > 0 ? config->particles : 0);
+    header.particle_blend = (uint32_t)config->particle_blend;
+    header.bars = (uint32_t)(config->bars > 0 ? config->bars : 0);
+    header.bar_scale = (uint32_t)config->bar_scale;
+    header.options = (config->spectrogram ? TRACE_OPTION_SPECTROGRAM : 0) |
+                     (config->trails ? TRACE_OPTION_TRAILS : 0) |
+                     (config->glow ? TRACE_OPTION_GLOW : 0) |
+                     (config->software ? TRACE_OPTION_SOFTWARE : 0);
+    header.particle_seed = config->particle_seed;
+    header.history_seconds = config->history_seconds;
+    for (int i = 0; i < FRAME_TRACE_MAX_LAYERS; i++) {
+        header.layer_rates[i] = config->layer_rates[i];
+    }
+    
+    writer->file = fopen(path, "wb");
+    if (!writer->file || fwrite(&header, sizeof(header), 1, writer->file) != 1) {
+        fprintf(stderr, "Erro ao criar trace: %s\n", path);
+        if (writer->file) {
+            fclose(writer->file);
+            remove(path);
+        }
+        mem_free(writer->spectrum);
+        mem_free(writer);
+        return NULL;
+    }
+    
+    writer->ok = true;
+    return writer;
+}
+
+// Grava o quadro de análise que segue um registro
+static bool write_analysis(FrameTraceWriter* writer, const AnalysisFrame* frame) {
+    FrameTraceAnalysis analysis;
+    memset(&analysis, 0, sizeof(analysis));
+    analysis.sequence = frame->sequence;
+    analysis.position = frame->position;
+    analysis.dominant_freq = frame->dominant_freq;
+    analysis.energies[0] = frame->low_energy;
+    analysis.energies[1] = frame->mid_energy;
+    analysis.energies[2] = frame->high_energy;
+    analysis.onsets = frame->onsets;
+    analysis.num_samples = (uint16_t)frame->num_samples;
+    analysis.num_bins = (uint16_t)frame->num_bins;
+    analysis.spectrum_ready = frame->spectrum_ready ? 1 : 0;
+    
+    if (fwrite(&analysis, sizeof(analysis), 1, writer->file) != 1) {
+        return false;
+    }
+    if (frame->num_samples > 0 &&
+        fwrite(frame->samples, sizeof(int16_t), frame->num_samples, writer->file) != (size_t)frame->num_samples) {
+        return false;
+    }
+    
+    // Espectro em float: metade do tamanho, e o replay lê sempre os mesmos valores
+    if (frame->spectrum_ready && frame->num_bins > 0) {
+        for (int i = 0; i < frame->num_bins; i++) {
+            writer->spectrum[i] = (float)frame->frequencies[i];
+        }
+        if (fwrite(writer->spectrum, sizeof(float), frame->num_bins, writer->file) != (size_t)frame->num_bins) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool frame_trace_writer_add(FrameTraceWriter* writer, const FrameTraceEntry* entry,
+                            const AnalysisFrame* frame) {
+    if (!writer || !entry || !writer->ok) return false;
+    if (frame && (frame->num_samples < 0 || frame->num_samples > ANALYSIS_MAX_BLOCK ||
+                  frame->num_bins < 0 || frame->num_bins > TRACE_MAX_BINS)) {
+        return false;
+    }
+    
+    // O mesmo quadro redesenhado não é gravado de novo
+    bool new_analysis = frame && (!writer->has_last || frame->sequence != writer->last_sequence ||
+                                  frame->position != writer->last_position);
+    
+    FrameTraceRecord record;
+    memset(&record, 0, sizeof(record));
+    record.time_ns = entry->time_ns;
+    record.played = entry->played;
+    record.flags = (frame ? TRACE_RECORD_HAS_FRAME : 0) |
+                   (entry->fresh ? TRACE_RECORD_FRESH : 0) |
+                   (new_analysis ? TRACE_RECORD_ANALYSIS : 0);
+    record.particle_capacity = (uint32_t)(entry->particle_capacity > 0 ? entry->particle_capacity : 0);
+    record.line_scale = entry->line_scale;
+    record.waveform_step = (uint16_t)(entry->waveform_step > 0 ? entry->waveform_step : 1);
+    record.bars = (uint16_t)(entry->bars > 0 ? entry->bars : 0);
+    
+    writer->ok = fwrite(&record, sizeof(record), 1, writer->file) == 1 &&
+                 (!new_analysis || write_analysis(writer, frame));
+    if (new_analysis) {
+        writer->has_last = true;
+        writer->last_sequence = frame->sequence;
+        writer->last_position = frame->position;
+    }
+    return writer->ok;
+}
+
+bool frame_trace_writer_close(FrameTraceWriter* writer) {
+    if (!writer) return false;
+    
+    bool ok = writer->ok && !ferror(writer->file);
+    ok = fclose(writer->file) == 0 && ok;
+    
+    mem_free(writer->spectrum);
+    mem_free(writer);
+    return ok;
+}
+
+FrameTrace* frame_trace_open(const char* path) {
+    if (!path) return NULL;
+    
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    
+    // Formato e tamanhos precisam bater
+    FrameTraceHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 memcmp(header.magic, "SWTR", 4) == 0 &&
+                 header.version == FRAME_TRACE_VERSION &&
+                 header.header_size == sizeof(FrameTraceHeader) &&
+                 header.record_size == sizeof(FrameTraceRecord) &&
+                 header.width > 0 && header.height > 0 && header.sample_rate > 0 &&
+                 header.fft_size > 0 && header.fft_size <= ANALYSIS_MAX_WINDOW;
+    
+    FrameTrace* trace = valid ? mem_calloc(1, sizeof(FrameTrace)) : NULL;
+    if (trace) {
+        trace->spectrum = mem_alloc(TRACE_MAX_BINS * sizeof(float));
+    }
+    if (!trace || !trace->spectrum) {
+        if (trace) mem_free(trace);
+        fclose(file);
+        return NULL;
+    }
+    
+    trace->file = file;
+    FrameTraceConfig* config = &trace->config;
+    config->width = (int)header.width;
+    config->height = (int)header.height;
+    config->sample_rate = (int)header.sample_rate;
+    config->fft_size = (int)header.fft_size;
+    config->particle_seed = header.particle_seed;
+    config->particles = (int)header.particles;
+    config->particle_blend = (int)header.particle_blend;
+    config->bars = (int)header.bars;
+    config->bar_scale = (int)header.bar_scale;
+    config->spectrogram = (header.options & TRACE_OPTION_SPECTROGRAM) != 0;
+    config->trails = (header.options & TRACE_OPTION_TRAILS) != 0;
+    config->glow = (header.options & TRACE_OPTION_GLOW) != 0;
+    config->software = (header.options & TRACE_OPTION_SOFTWARE) != 0;
+    config->history_seconds = header.history_seconds;
+    for (int i = 0; i < FRAME_TRACE_MAX_LAYERS; i++) {
+        config->layer_rates[i] = header.layer_rates[i];
+    }
+    return trace;
+}
+
+void frame_trace_free(FrameTrace* trace) {
+    if (!trace) return;
+    
+    fclose(trace->file);
+    mem_free(trace->spectrum);
+    mem_free(trace);
+}
+
+const FrameTraceConfig* frame_trace_get_config(const FrameTrace* trace) {
+    return trace ? &trace->config : NULL;
+}
+
+// Lê o quadro de análise que segue um registro
+static bool read_analysis(FrameTrace* trace, AnalysisFrame* frame) {
+    FrameTraceAnalysis analysis;
+    if (fread(&analysis, sizeof(analysis), 1, trace->file) != 1 ||
+        analysis.num_samples > ANALYSIS_MAX_BLOCK || analysis.num_bins > TRACE_MAX_BINS) {
+        return false;
+    }
+    
+    int num_samples = analysis.num_samples;
+    int num_bins = analysis.num_bins;
+    if (num_samples > 0 &&
+        fread(frame->samples, sizeof(int16_t), num_samples, trace->file) != (size_t)num_samples) {
+        return false;
+    }
+    
+    if (analysis.spectrum_ready && num_bins > 0) {
+        if (fread(trace->spectrum, sizeof(float), num_bins, trace->file) != (size_t)num_bins) {
+            return false;
+        }
+        for (int i = 0; i < num_bins; i++) {
+            frame->frequencies[i] = trace->spectrum[i];
+        }
+    } else {
+        memset(frame->frequencies, 0, num_bins * sizeof(double));
+    }
+    
+    frame->sequence = analysis.sequence;
+    frame->position = analysis.position;
+    frame->spectrum_ready = analysis.spectrum_ready != 0;
+    frame->dominant_freq = analysis.dominant_freq;
+    frame->low_energy = analysis.energies[0];
+    frame->mid_energy = analysis.energies[1];
+    frame->high_energy = analysis.energies[2];
+    frame->onsets = analysis.onsets;
+    frame->num_samples = num_samples;
+    frame->num_bins = num_bins;
+    return true;
+}
+
+bool frame_trace_next(FrameTrace* trace, FrameTraceEntry* entry, AnalysisFrame* frame) {
+    if (!trace || !entry || !frame) return false;
+    
+    FrameTraceRecord record;
+    if (fread(&record, sizeof(record), 1, trace->file) != 1) {
+        return false;
+    }
+    
+    entry->time_ns = record.time_ns;
+    entry->played = record.played;
+    entry->has_frame = (record.flags & TRACE_RECORD_HAS_FRAME) != 0;
+    entry->fresh = (record.flags & TRACE_RECORD_FRESH) != 0;
+    entry->new_analysis = (record.flags & TRACE_RECORD_ANALYSIS) != 0;
+    entry->particle_capacity = (int)record.particle_capacity;
+    entry->line_scale = record.line_scale;
+    entry->waveform_step = record.waveform_step;
+    entry->bars = record.bars;
+    
+    if (entry->new_analysis) {
+        if (!read_analysis(trace, frame)) {
+            return false;
+        }
+        trace->has_analysis = true;
+    }
+    
+    // Quadro desenhado sem nenhum quadro de análise gravado antes: arquivo corrompido
+    return !entry->has_frame || trace->has_analysis;
+}
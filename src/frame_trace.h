@@ -0,0 +1,98 @@
+#ifndef FRAME_TRACE_H
+#define FRAME_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_analyzer.h"
+
+// Trace de sessão (.swt): tudo que entrou em cada quadro desenhado, para
+// repetir a sessão sem áudio nem relógio. O replay faz as mesmas chamadas
+// ao visualizador, na mesma ordem, com os mesmos instantes e a mesma
+// semente das partículas, e o resultado não depende da máquina.
+//
+// Formato (versão 1, ordem de bytes nativa/little-endian):
+//   cabeçalho de 104 bytes: "SWTR", versão, tamanhos, dimensões da janela,
+//     taxa de amostragem, janela FFT, opções do visualizador, semente das
+//     partículas e taxas das camadas
+//   um registro de 32 bytes por quadro desenhado: instante (ns desde o
+//     início da sessão), samples reproduzidos, flags, capacidade de
+//     partículas, detalhe da waveform e barras
+//   quando o quadro de análise mudou, o registro é seguido do quadro:
+//     cabeçalho de 64 bytes (sequência, posição, frequência dominante,
+//     energias, ataques, tamanhos), samples (int16) e espectro (float)
+//
+// As cores não são gravadas: o replay refaz com audio_analyzer_fill_colors.
+
+// Número máximo de camadas com taxa própria no cabeçalho
+#define FRAME_TRACE_MAX_LAYERS 4
+
+// Opções da sessão gravada (as mesmas no replay)
+typedef struct {
+    int width;
+    int height;
+    int sample_rate;
+    int fft_size;
+    uint64_t particle_seed;
+    int particles;             // 0 = padrão do visualizador
+    int particle_blend;        // VisualizerBlend
+    int bars;
+    int bar_scale;             // BarScale
+    bool spectrogram;
+    bool trails;
+    bool glow;
+    bool software;
+    double history_seconds;    // 0 = padrão do visualizador
+    double layer_rates[FRAME_TRACE_MAX_LAYERS];
+} FrameTraceConfig;
+
+// Estado de um quadro desenhado
+typedef struct {
+    uint64_t time_ns;          // Instante do desenho, desde o início da sessão
+    uint64_t played;           // Samples já reproduzidos
+    bool has_frame;            // false = nenhum quadro de análise publicado ainda
+    bool fresh;                // Quadro de análise desenhado pela primeira vez
+    bool new_analysis;         // Leitura: o quadro de análise foi substituído
+    int particle_capacity;
+    float line_scale;          // Detalhe da waveform (visualizer_set_waveform_detail)
+    int waveform_step;
+    int bars;
+} FrameTraceEntry;
+
+// ---- Gravação ----
+
+typedef struct FrameTraceWriter FrameTraceWriter;
+
+// Cria o arquivo e grava o cabeçalho
+FrameTraceWriter* frame_trace_writer_open(const char* path, const FrameTraceConfig* config);
+
+// Acrescenta um quadro desenhado; o quadro de análise só é gravado quando
+// a sequência muda (o mesmo quadro redesenhado custa 32 bytes)
+// frame: quadro de análise desenhado (NULL = nenhum)
+bool frame_trace_writer_add(FrameTraceWriter* writer, const FrameTraceEntry* entry,
+                            const AnalysisFrame* frame);
+
+// Fecha o arquivo e libera o gravador
+// Retorna: false se alguma escrita falhou
+bool frame_trace_writer_close(FrameTraceWriter* writer);
+
+// ---- Leitura ----
+
+typedef struct FrameTrace FrameTrace;
+
+// Abre um arquivo .swt para leitura sequencial
+// Retorna: NULL se o arquivo não existe ou é de outra versão
+FrameTrace* frame_trace_open(const char* path);
+
+// Fecha o arquivo e libera o leitor
+void frame_trace_free(FrameTrace* trace);
+
+// Opções da sessão gravada
+const FrameTraceConfig* frame_trace_get_config(const FrameTrace* trace);
+
+// Lê o próximo quadro desenhado
+// frame: quadro de análise em uso; só é reescrito quando entry->new_analysis
+//        (as cores ficam a cargo de audio_analyzer_fill_colors)
+// Retorna: false no fim do arquivo (um registro truncado também encerra)
+bool frame_trace_next(FrameTrace* trace, FrameTraceEntry* entry, AnalysisFrame* frame);
+
+#endif // FRAME_TRACE_H
@@ -0,0 +1,19 @@
+#include "hud_font.h"
+
+// Glifos de ' ' (32) a '_' (95)
+static const uint16_t hud_font_glyphs[64] = {
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x52a5, 0x0000, 0x0000,  // ' ' ! " # $ % & '
+    0x4494, 0x1491, 0x0000, 0x05d0, 0x1400, 0x01c0, 0x2000, 0x12a4,  // ( ) * + , - . /
+    0x7b6f, 0x749a, 0x73e7, 0x79e7, 0x49ed, 0x79cf, 0x7bcf, 0x24a7,  // 0 1 2 3 4 5 6 7
+    0x7bef, 0x79ef, 0x0410, 0x0000, 0x0000, 0x0e38, 0x0000, 0x0000,  // 8 9 : ; < = > ?
+    0x0000, 0x5bea, 0x3aeb, 0x624e, 0x3b6b, 0x72cf, 0x12cf, 0x6b4e,  // @ A B C D E F G
+    0x5bed, 0x7497, 0x2b24, 0x5aed, 0x7249, 0x5bfd, 0x5b6b, 0x2b6a,  // H I J K L M N O
+    0x12eb, 0x676a, 0x5aeb, 0x388e, 0x2497, 0x7b6d, 0x2b6d, 0x5fed,  // P Q R S T U V W
+    0x5aad, 0x24ad, 0x72a7, 0x0000, 0x0000, 0x0000, 0x0000, 0x7000,  // X Y Z [ \\ ] ^ _
+};
+
+uint16_t hud_font_glyph(char c) {
+    if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A');
+    if (c < 32 || c > 95) return 0;
+    return hud_font_glyphs[c - 32];
+}
@@ -0,0 +1,14 @@
+#ifndef HUD_FONT_H
+#define HUD_FONT_H
+
+#include <stdint.h>
+
+// Fonte bitmap mínima para textos de diagnóstico (sem dependência de fontes)
+#define HUD_FONT_WIDTH 3
+#define HUD_FONT_HEIGHT 5
+
+// Retorna o glifo 3x5 de um caractere: bit (linha * 3 + coluna) aceso
+// Letras minúsculas usam o glifo maiúsculo; caracteres sem glifo ficam vazios
+uint16_t hud_font_glyph(char c);
+
+#endif // HUD_FONT_H
@@ -0,0 +1,388 @@
+#include "latency_probe.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "memory_arena.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Trecho só com ruído antes do primeiro clique (pré-carga e janela da FFT)
+// e depois do último (o reinício da faixa descarta o fim da fila)
+#define LATENCY_LEAD_SECONDS 1.0
+#define LATENCY_TAIL_SECONDS 1.5
+
+// Intervalo entre cliques: base mais um desvio que varia com o índice, para
+// não coincidir com o bloco de análise nem com o período dos quadros
+#define LATENCY_CLICK_INTERVAL 0.5
+#define LATENCY_CLICK_JITTER 0.037
+
+// Clique: chirp linear com decaimento exponencial
+#define LATENCY_CLICK_SECONDS 0.025
+#define LATENCY_CLICK_DECAY 0.006
+#define LATENCY_CLICK_START_HZ 300.0
+#define LATENCY_CLICK_END_HZ 6000.0
+#define LATENCY_CLICK_AMPLITUDE 24000.0
+
+// Ruído de fundo (a detecção de ataques precisa de uma média não nula)
+#define LATENCY_NOISE_AMPLITUDE 64.0
+
+// Pico a partir do qual o quadro exibido contém o clique
+#define LATENCY_CLICK_VISIBLE 8000
+
+// Relógio de reprodução parado por mais que isso encerra a medição
+#define LATENCY_STALL_NS 2000000000ULL
+
+// Trechos em que a deriva é resumida
+#define LATENCY_SEGMENTS 5
+
+// Um quadro renderizado
+typedef struct {
+    uint64_t time_ns;
+    uint64_t played;     // Relógio de reprodução (samples)
+    uint64_t shown;      // Fim do bloco do quadro de análise exibido
+} LatencyRecord;
+
+struct LatencyProbe {
+    int sample_rate;
+    uint64_t track_samples;
+    uint64_t end_samples;      // A medição termina aqui (depois do último clique)
+    
+    // Cliques: posição, latência até aparecer na tela e se o quadro o trazia
+    uint64_t* clicks;
+    int64_t* click_latency;
+    bool* click_visible;
+    int num_clicks;
+    int next_click;
+    
+    LatencyRecord* records;
+    int num_records;
+    int max_records;
+    uint64_t frames;
+    
+    // Quadros de análise que a renderização pulou ou repetiu
+    uint64_t last_sequence;
+    uint64_t skipped;
+    uint64_t repeated;
+    
+    uint64_t last_played;
+    uint64_t last_change_ns;
+    bool restarted;
+    bool stalled;
+};
+
+// Instante de início do clique k (segundos)
+static double click_time(int k) {
+    double t = LATENCY_LEAD_SECONDS;
+    for (int i = 0; i < k; i++) {
+        t += LATENCY_CLICK_INTERVAL + (i % 7) * LATENCY_CLICK_JITTER;
+    }
+    return t;
+}
+
+LatencyProbe* latency_probe_init(int sample_rate, double seconds, int max_frames) {
+    if (sample_rate <= 0 || seconds <= 0.0 || max_frames <= 0) {
+        return NULL;
+    }
+    
+    LatencyProbe* probe = mem_calloc(1, sizeof(LatencyProbe));
+    if (!probe) {
+        return NULL;
+    }
+    
+    probe->sample_rate = sample_rate;
+    double end = LATENCY_LEAD_SECONDS + seconds;
+    while (click_time(probe->num_clicks) < end) {
+        probe->num_clicks++;
+    }
+    
+    probe->track_samples = (uint64_t)((end + LATENCY_TAIL_SECONDS) * sample_rate);
+    probe->end_samples = (uint64_t)((click_time(probe->num_clicks - 1) + LATENCY_CLICK_INTERVAL) * sample_rate);
+    probe->max_records = max_frames;
+    probe->clicks = mem_alloc(probe->num_clicks * sizeof(uint64_t));
+    probe->click_latency = mem_alloc(probe->num_clicks * sizeof(int64_t));
+    probe->click_visible = mem_calloc(probe->num_clicks, sizeof(bool));
+    probe->records = mem_alloc(max_frames * sizeof(LatencyRecord));
+    
+    if (!probe->clicks || !probe->click_latency || !probe->click_visible || !probe->records) {
+        latency_probe_free(probe);
+        return NULL;
+    }
+    
+    for (int k = 0; k < probe->num_clicks; k++) {
+        probe->clicks[k] = (uint64_t)(click_time(k) * sample_rate + 0.5);
+    }
+    
+    return probe;
+}
+
+void latency_probe_free(LatencyProbe* probe) {
+    if (!probe) return;
+    
+    if (probe->records) mem_free(probe->records);
+    if (probe->click_visible) mem_free(probe->click_visible);
+    if (probe->click_latency) mem_free(probe->click_latency);
+    if (probe->clicks) mem_free(probe->clicks);
+    mem_free(probe);
+}
+
+static void write_u16(FILE* file, uint16_t value) {
+    fputc(value & 0xFF, file);
+    fputc(value >> 8, file);
+}
+
+static void write_u32(FILE* file, uint32_t value) {
+    write_u16(file, value & 0xFFFF);
+    write_u16(file, value >> 16);
+}
+
+bool latency_probe_write_track(const LatencyProbe* probe, const char* path) {
+    if (!probe || !path) return false;
+    
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Erro ao criar faixa de cliques: %s\n", path);
+        return false;
+    }
+    
+    // Cabeçalho RIFF/WAVE (PCM 16 bits, mono, little-endian)
+    uint32_t data_bytes = (uint32_t)(probe->track_samples * sizeof(int16_t));
+    fwrite("RIFF", 1, 4, file);
+    write_u32(file, 36 + data_bytes);
+    fwrite("WAVEfmt ", 1, 8, file);
+    write_u32(file, 16);
+    write_u16(file, 1);
+    write_u16(file, 1);
+    write_u32(file, (uint32_t)probe->sample_rate);
+    write_u32(file, (uint32_t)probe->sample_rate * 2);
+    write_u16(file, 2);
+    write_u16(file, 16);
+    fwrite("data", 1, 4, file);
+    write_u32(file, data_bytes);
+    
+    int click_samples = (int)(LATENCY_CLICK_SECONDS * probe->sample_rate);
+    uint32_t noise = 12345u;
+    int k = 0;
+    for (uint64_t i = 0; i < probe->track_samples; i++) {
+        noise = noise * 1664525u + 1013904223u;
+        double value = ((noise >> 16) / 32768.0 - 1.0) * LATENCY_NOISE_AMPLITUDE;
+        
+        while (k < probe->num_clicks && i >= probe->clicks[k] + click_samples) {
+            k++;
+        }
+        if (k < probe->num_clicks && i >= probe->clicks[k]) {
+            double t = (double)(i - probe->clicks[k]) / probe->sample_rate;
+            double sweep = (LATENCY_CLICK_END_HZ - LATENCY_CLICK_START_HZ) / LATENCY_CLICK_SECONDS;
+            double phase = 2.0 * M_PI * (LATENCY_CLICK_START_HZ * t + 0.5 * sweep * t * t);
+            value += LATENCY_CLICK_AMPLITUDE * exp(-t / LATENCY_CLICK_DECAY) * cos(phase);
+        }
+        
+        if (value > 32767.0) value = 32767.0;
+        if (value < -32768.0) value = -32768.0;
+        write_u16(file, (uint16_t)(int16_t)lrint(value));
+    }
+    
+    bool ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    if (!ok) {
+        fprintf(stderr, "Erro ao gravar faixa de cliques: %s\n", path);
+    }
+    return ok;
+}
+
+// Maior amplitude do trecho de waveform do quadro
+static int frame_peak(const AnalysisFrame* frame) {
+    int peak = 0;
+    for (int i = 0; i < frame->num_samples; i++) {
+        int value = abs(frame->samples[i]);
+        if (value > peak) peak = value;
+    }
+    return peak;
+}
+
+bool latency_probe_record(LatencyProbe* probe, uint64_t now_ns, uint64_t played,
+                          const AnalysisFrame* frame) {
+    if (!probe) return false;
+    
+    // A faixa reiniciou (o player zera o relógio) ou o relógio parou
+    if (probe->frames > 0 && played < probe->last_played) {
+        probe->restarted = true;
+        return false;
+    }
+    if (probe->frames == 0 || played != probe->last_played) {
+        probe->last_played = played;
+        probe->last_change_ns = now_ns;
+    } else if (now_ns - probe->last_change_ns > LATENCY_STALL_NS) {
+        probe->stalled = true;
+        return false;
+    }
+    probe->frames++;
+    
+    if (!frame) {
+        return true;
+    }
+    
+    if (probe->last_sequence != 0 && frame->sequence > probe->last_sequence + 1) {
+        probe->skipped += frame->sequence - probe->last_sequence - 1;
+    } else if (frame->sequence == probe->last_sequence) {
+        probe->repeated++;
+    }
+    probe->last_sequence = frame->sequence;
+    
+    if (probe->num_records < probe->max_records) {
+        LatencyRecord* record = &probe->records[probe->num_records++];
+        record->time_ns = now_ns;
+        record->played = played;
+        record->shown = frame->position;
+    }
+    
+    // Cliques que o quadro exibido já cobre: a latência é o quanto o som
+    // andou desde o clique até ele chegar à tela
+    int peak = -1;
+    while (probe->next_click < probe->num_clicks && frame->position > probe->clicks[probe->next_click]) {
+        if (peak < 0) peak = frame_peak(frame);
+        probe->click_latency[probe->next_click] = (int64_t)played - (int64_t)probe->clicks[probe->next_click];
+        probe->click_visible[probe->next_click] = peak >= LATENCY_CLICK_VISIBLE;
+        probe->next_click++;
+    }
+    
+    return played < probe->end_samples;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Percentil de valores ordenados (posição mais próxima)
+static double percentile(const double* sorted, int count, double p) {
+    return sorted[(int)(p * (count - 1) + 0.5)];
+}
+
+// Imprime média, percentis e extremos (ordena values)
+static void print_distribution(const char* label, double* values, int count) {
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for (int i = 0; i < count; i++) {
+        sum += values[i];
+        sum_sq += values[i] * values[i];
+    }
+    double mean = sum / count;
+    double variance = sum_sq / count - mean * mean;
+    
+    qsort(values, count, sizeof(double), compare_double);
+    printf("%s (ms): média %.1f  desvio %.1f  mín %.1f  p50 %.1f  p95 %.1f  p99 %.1f  máx %.1f\n",
+           label, mean, variance > 0.0 ? sqrt(variance) : 0.0, values[0],
+           percentile(values, count, 0.50), percentile(values, count, 0.95),
+           percentile(values, count, 0.99), values[count - 1]);
+}
+
+bool latency_probe_report(const LatencyProbe* probe, const PerfStats* stats, const char* csv_path) {
+    if (!probe) return false;
+    
+    int count = probe->num_records;
+    if (count == 0) {
+        printf("Latência: nenhum quadro de análise exibido\n");
+        return false;
+    }
+    
+    double* values = mem_alloc((count > probe->num_clicks ? count : probe->num_clicks) * sizeof(double));
+    if (!values) {
+        return false;
+    }
+    
+    double rate_ms = 1000.0 / probe->sample_rate;
+    const LatencyRecord* first = &probe->records[0];
+    printf("Latência: %llu quadros renderizados, %d medidos, %.1f s de reprodução%s\n",
+           (unsigned long long)probe->frames, count,
+           (probe->records[count - 1].time_ns - first->time_ns) / 1e9,
+           probe->restarted ? " (faixa reiniciou antes do fim)" :
+           probe->stalled ? " (relógio de reprodução parou)" : "");
+    
+    // Erro entre a posição exibida e a reproduzida (positivo = imagem adiantada)
+    for (int i = 0; i < count; i++) {
+        values[i] = ((double)probe->records[i].shown - (double)probe->records[i].played) * rate_ms;
+    }
+    print_distribution("Erro A/V", values, count);
+    
+    // Latência dos cliques: som do clique até o quadro que o cobre
+    int visible = 0;
+    for (int k = 0; k < probe->next_click; k++) {
+        values[k] = probe->click_latency[k] * rate_ms;
+        if (probe->click_visible[k]) visible++;
+    }
+    if (probe->next_click > 0) {
+        print_distribution("Latência dos cliques", values, probe->next_click);
+    }
+    printf("Cliques: %d de %d exibidos, %d com o próprio clique no quadro\n",
+           probe->next_click, probe->num_clicks, visible);
+    
+    // Ressincronizações e perdas
+    printf("Quadros de análise pulados: %llu, repetidos: %llu\n",
+           (unsigned long long)probe->skipped, (unsigned long long)probe->repeated);
+    if (stats) {
+        PerfSummary resync;
+        perf_stats_summary(stats, PERF_STAGE_RESYNC, &resync);
+        printf("Ressincronizações: %llu  underruns: %llu  quadros descartados: %llu\n",
+               (unsigned long long)resync.count,
+               (unsigned long long)perf_stats_get_counter(stats, PERF_COUNTER_UNDERRUNS),
+               (unsigned long long)perf_stats_get_counter(stats, PERF_COUNTER_DROPPED));
+    }
+    
+    // Deriva: inclinação do erro no tempo (mínimos quadrados) e média por trecho
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    double segment_sum[LATENCY_SEGMENTS] = {0};
+    int segment_count[LATENCY_SEGMENTS] = {0};
+    double duration = (probe->records[count - 1].time_ns - first->time_ns) / 1e9;
+    for (int i = 0; i < count; i++) {
+        double x = (probe->records[i].time_ns - first->time_ns) / 1e9;
+        double y = ((double)probe->records[i].shown - (double)probe->records[i].played) * rate_ms;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+        
+        int segment = duration > 0.0 ? (int)(x / duration * LATENCY_SEGMENTS) : 0;
+        if (segment >= LATENCY_SEGMENTS) segment = LATENCY_SEGMENTS - 1;
+        segment_sum[segment] += y;
+        segment_count[segment]++;
+    }
+    double denominator = count * sxx - sx * sx;
+    double slope = denominator > 0.0 ? (count * sxy - sx * sy) / denominator : 0.0;
+    printf("Deriva: %+.2f ms/min; erro médio por trecho:", slope * 60.0);
+    for (int s = 0; s < LATENCY_SEGMENTS; s++) {
+        if (segment_count[s] > 0) {
+            printf(" %.1f", segment_sum[s] / segment_count[s]);
+        } else {
+            printf(" -");
+        }
+    }
+    printf("\n");
+    mem_free(values);
+    
+    if (!csv_path) {
+        return true;
+    }
+    
+    FILE* file = fopen(csv_path, "w");
+    if (!file) {
+        fprintf(stderr, "Erro ao criar %s\n", csv_path);
+        return false;
+    }
+    fprintf(file, "time_s,played_s,shown_s,error_ms\n");
+    for (int i = 0; i < count; i++) {
+        const LatencyRecord* record = &probe->records[i];
+        fprintf(file, "%.4f,%.4f,%.4f,%.2f\n", (record->time_ns - first->time_ns) / 1e9,
+                (double)record->played / probe->sample_rate, (double)record->shown / probe->sample_rate,
+                ((double)record->shown - (double)record->played) * rate_ms);
+    }
+    bool ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    if (ok) {
+        printf("Quadros gravados em %s\n", csv_path);
+    }
+    return ok;
+}
@@ -0,0 +1,43 @@
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_analyzer.h"
+#include "perf_stats.h"
+
+// Medição de sincronia A/V e latência de ponta a ponta: gera uma faixa de
+// cliques (chirps curtos em instantes conhecidos, sobre ruído baixo), registra
+// a cada quadro renderizado o relógio de reprodução e a posição do quadro de
+// análise exibido e, ao fim, resume o erro entre os dois, a latência de cada
+// clique, as ressincronizações e a deriva ao longo do tempo.
+typedef struct LatencyProbe LatencyProbe;
+
+// Inicializa a medição
+// seconds: duração da faixa de cliques (sem contar o início e o fim em silêncio)
+// max_frames: quadros renderizados guardados (os seguintes só contam no total)
+LatencyProbe* latency_probe_init(int sample_rate, double seconds, int max_frames);
+
+// Libera recursos da medição
+void latency_probe_free(LatencyProbe* probe);
+
+// Grava a faixa de cliques em WAV (PCM 16 bits, mono)
+// Retorna: false se o arquivo não pôde ser escrito
+bool latency_probe_write_track(const LatencyProbe* probe, const char* path);
+
+// Registra um quadro renderizado
+// now_ns: instante do desenho (frame_clock_now_ns)
+// played: samples reproduzidos (audio_player_get_played_samples)
+// frame: quadro de análise desenhado (NULL = nenhum ainda)
+// Retorna: false quando a medição terminou (último clique passou, a faixa
+//          reiniciou ou o relógio de reprodução parou)
+bool latency_probe_record(LatencyProbe* probe, uint64_t now_ns, uint64_t played,
+                          const AnalysisFrame* frame);
+
+// Imprime o resumo e grava os quadros em CSV (time_s, played_s, shown_s, error_ms)
+// stats: ressincronizações, underruns e quadros descartados (NULL = não informa)
+// csv_path: NULL = só o resumo
+// Retorna: false se a medição não tem quadros ou o CSV não pôde ser escrito
+bool latency_probe_report(const LatencyProbe* probe, const PerfStats* stats, const char* csv_path);
+
+#endif // LATENCY_PROBE_H
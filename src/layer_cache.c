@@ -0,0 +1,180 @@
+#include "layer_cache.h"
+#include <stdio.h>
+#include <math.h>
+#include <SDL2/SDL.h>
+#include "memory_arena.h"
+
+// Mistura pré-multiplicada existe a partir do SDL 2.0.6
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+#define LAYER_HAVE_CUSTOM_BLEND 1
+#else
+#define LAYER_HAVE_CUSTOM_BLEND 0
+#endif
+
+// Fração do intervalo aceita como adiantamento: com quadros de jitter a
+// camada não perde o quadro certo e cai para a metade da taxa
+#define LAYER_EARLY_DIVISOR 4
+
+typedef struct {
+    SDL_Texture* texture;   // NULL = desenhada direto na tela
+    uint64_t interval_ns;
+    uint64_t drawn_ns;      // Instante do último redesenho
+    uint64_t frame;         // Último quadro em que a camada entrou
+    bool dirty;
+} CachedLayer;
+
+struct LayerCache {
+    SDL_Renderer* renderer;
+    int width;
+    int height;
+    SDL_BlendMode compose_blend;
+    
+    CachedLayer layers[LAYER_CACHE_MAX_LAYERS];
+    int num_layers;
+    int current;            // Camada com a textura como alvo (-1 = nenhuma)
+    uint64_t frame;
+};
+
+LayerCache* layer_cache_init(SDL_Renderer* renderer, int width, int height, int num_layers) {
+    if (!renderer || width <= 0 || height <= 0 || num_layers <= 0 || num_layers > LAYER_CACHE_MAX_LAYERS) {
+        return NULL;
+    }
+    if (!SDL_RenderTargetSupported(renderer)) {
+        fprintf(stderr, "Erro ao criar cache de camadas: renderer sem texturas alvo\n");
+        return NULL;
+    }
+    
+    LayerCache* cache = mem_calloc(1, sizeof(LayerCache));
+    if (!cache) {
+        return NULL;
+    }
+    
+    cache->renderer = renderer;
+    cache->width = width;
+    cache->height = height;
+    cache->num_layers = num_layers;
+    cache->current = -1;
+    cache->frame = 1;
+    
+    // Cor pré-multiplicada: dst = src + dst * (1 - src_alpha)
+    cache->compose_blend = SDL_BLENDMODE_BLEND;
+#if LAYER_HAVE_CUSTOM_BLEND
+    cache->compose_blend = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+#endif
+    
+    for (int i = 0; i < num_layers; i++) {
+        cache->layers[i].dirty = true;
+    }
+    return cache;
+}
+
+void layer_cache_free(LayerCache* cache) {
+    if (!cache) return;
+    
+    if (cache->current >= 0) {
+        SDL_SetRenderTarget(cache->renderer, NULL);
+    }
+    for (int i = 0; i < cache->num_layers; i++) {
+        if (cache->layers[i].texture) {
+            SDL_DestroyTexture(cache->layers[i].texture);
+        }
+    }
+    mem_free(cache);
+}
+
+// Cria a textura alvo de uma camada
+static SDL_Texture* create_layer_texture(LayerCache* cache) {
+    SDL_Texture* texture = SDL_CreateTexture(cache->renderer, SDL_PIXELFORMAT_RGBA8888,
+                                             SDL_TEXTUREACCESS_TARGET, cache->width, cache->height);
+    if (!texture) {
+        fprintf(stderr, "Erro ao criar textura de camada: %s\n", SDL_GetError());
+        return NULL;
+    }
+    
+    // Sem a mistura pré-multiplicada, bordas semitransparentes escurecem um pouco
+    if (SDL_SetTextureBlendMode(texture, cache->compose_blend) != 0) {
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    }
+    return texture;
+}
+
+bool layer_cache_set_rate(LayerCache* cache, int layer, double hz) {
+    if (!cache || layer < 0 || layer >= cache->num_layers || hz < 0.0) return false;
+    
+    CachedLayer* entry = &cache->layers[layer];
+    if (hz > 0.0 && !entry->texture) {
+        entry->texture = create_layer_texture(cache);
+        if (!entry->texture) {
+            return false;
+        }
+    }
+    
+    entry->interval_ns = hz > 0.0 ? (uint64_t)llround(1e9 / hz) : 0;
+    entry->dirty = true;
+    return true;
+}
+
+void layer_cache_invalidate(LayerCache* cache, int layer) {
+    if (!cache || layer >= cache->num_layers) return;
+    
+    for (int i = 0; i < cache->num_layers; i++) {
+        if (layer < 0 || i == layer) {
+            cache->layers[i].dirty = true;
+        }
+    }
+}
+
+void layer_cache_next_frame(LayerCache* cache) {
+    if (!cache) return;
+    cache->frame++;
+}
+
+bool layer_cache_begin(LayerCache* cache, int layer, uint64_t now_ns) {
+    if (!cache || layer < 0 || layer >= cache->num_layers) return true;
+    
+    // Camada anterior sem layer_cache_end: termina antes de trocar o alvo
+    if (cache->current >= 0) {
+        layer_cache_end(cache);
+    }
+    
+    CachedLayer* entry = &cache->layers[layer];
+    bool continuous = entry->frame + 1 >= cache->frame;
+    entry->frame = cache->frame;
+    
+    // Camada a cada quadro: desenhada direto na tela
+    if (!entry->texture || entry->interval_ns == 0) {
+        return true;
+    }
+    
+    cache->current = layer;
+    uint64_t early = entry->interval_ns / LAYER_EARLY_DIVISOR;
+    bool due = now_ns - entry->drawn_ns + early >= entry->interval_ns;
+    if (!entry->dirty && continuous && !due) {
+        return false;
+    }
+    
+    // Redesenho: limpa a textura com alpha 0 e passa a desenhar nela
+    if (SDL_SetRenderTarget(cache->renderer, entry->texture) != 0) {
+        cache->current = -1;
+        return true;
+    }
+    SDL_SetRenderDrawColor(cache->renderer, 0, 0, 0, 0);
+    SDL_RenderClear(cache->renderer);
+    
+    entry->drawn_ns = now_ns;
+    entry->dirty = false;
+    return true;
+}
+
+void layer_cache_end(LayerCache* cache) {
+    if (!cache || cache->current < 0) return;
+    
+    CachedLayer* entry = &cache->layers[cache->current];
+    cache->current = -1;
+    
+    // Composição: um quad texturizado por camada guardada
+    SDL_SetRenderTarget(cache->renderer, NULL);
+    SDL_RenderCopy(cache->renderer, entry->texture, NULL, NULL);
+}
@@ -0,0 +1,51 @@
+#ifndef LAYER_CACHE_H
+#define LAYER_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct SDL_Renderer;
+
+// Número máximo de camadas de um cache
+#define LAYER_CACHE_MAX_LAYERS 8
+
+// Camadas com taxa própria desenhadas numa textura alvo guardada entre
+// quadros: a camada só é redesenhada quando o intervalo dela passou ou o
+// conteúdo foi invalidado; nos outros quadros a textura é só copiada para a
+// tela. Camadas sem taxa são desenhadas direto na tela, na mesma ordem.
+// As texturas guardam cor pré-multiplicada (limpas com alpha 0), então o
+// que foi desenhado com mistura aditiva continua aditivo na composição.
+typedef struct LayerCache LayerCache;
+
+// Inicializa o cache (as texturas só são criadas para camadas com taxa)
+// width, height: tamanho das texturas (o da janela)
+// num_layers: número de camadas (até LAYER_CACHE_MAX_LAYERS)
+// Retorna: NULL se o renderer não suporta texturas alvo
+LayerCache* layer_cache_init(struct SDL_Renderer* renderer, int width, int height, int num_layers);
+
+// Libera recursos do cache (inclusive as texturas)
+void layer_cache_free(LayerCache* cache);
+
+// Taxa de atualização de uma camada
+// hz: redesenhos por segundo (0 = a cada quadro, direto na tela)
+// Retorna: false se a textura da camada não pôde ser criada
+bool layer_cache_set_rate(LayerCache* cache, int layer, double hz);
+
+// Marca o conteúdo de uma camada como inválido (redesenhada no próximo quadro)
+// layer: camada (negativo = todas)
+void layer_cache_invalidate(LayerCache* cache, int layer);
+
+// Início de um quadro: camadas que ficaram fora do quadro anterior são
+// redesenhadas quando voltarem (a textura delas não acompanhou o estado)
+void layer_cache_next_frame(LayerCache* cache);
+
+// Começa uma camada
+// now_ns: instante do quadro (frame_clock_now_ns)
+// Retorna: true se a camada deve ser desenhada (na textura dela, já limpa,
+//          ou direto na tela); false se a textura guardada será reutilizada
+bool layer_cache_begin(LayerCache* cache, int layer, uint64_t now_ns);
+
+// Termina a camada atual: volta a desenhar na tela e copia a textura
+void layer_cache_end(LayerCache* cache);
+
+#endif // LAYER_CACHE_H
@@ -1,323 +1,1160 @@
+// mkstemp e close (POSIX)
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include <time.h>
+#include <unistd.h>
+
+#include <SDL2/SDL.h>
 
 #include "audio_decoder.h"
-#include "fft_analyzer.h"
-#include "color_mapper.h"
+#include "audio_analyzer.h"
+#include "audio_pipeline.h"
 #include "visualizer.h"
 #include "audio_player.h"
+#include "video_exporter.h"
+#include "frame_scheduler.h"
+#include "perf_stats.h"
+#include "quality_governor.h"
+#include "memory_arena.h"
+#include "frame_publisher.h"
+#include "batch_extractor.h"
+#include "track_cache.h"
+#include "latency_probe.h"
+#include "frame_trace.h"
 
 #define WINDOW_WIDTH 800
 #define WINDOW_HEIGHT 800
 #define FFT_WINDOW_SIZE 2048
 #define SAMPLES_PER_FRAME 512
+#define TRAIL_PERSISTENCE 0.85f
+#define TARGET_FPS 60
 
-int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        fprintf(stderr, "Uso: %s <arquivo_de_audio>\n", argv[0]);
-        fprintf(stderr, "Exemplo: %s Feelings\\ V4.mp3\n", argv[0]);
-        return 1;
+// HUD de desempenho: posição, escala da fonte e intervalo de atualização do texto
+#define HUD_MARGIN 8.0f
+#define HUD_SCALE 2.0f
+#define HUD_REFRESH_NS 250000000ULL
+
+// Arena com os buffers da sessão (páginas não usadas não ocupam memória)
+#define SESSION_ARENA_BYTES (64u << 20)
+
+// Quadros de aquecimento antes de contar alocações em regime (buffers que
+// crescem sob demanda atingem o tamanho final nos primeiros quadros)
+#define WARMUP_FRAMES 120
+
+// Arquivos gravados com a tecla P
+#define PERF_CSV_PATH "soundwave_perf.csv"
+#define PERF_TRACE_PATH "soundwave_trace.json"
+
+// Teste de latência: faixa de cliques gerada num arquivo temporário exclusivo
+// (apagado no fim) e quadros medidos
+#define LATENCY_TRACK_TEMPLATE "soundwave_latency_XXXXXX"
+#define LATENCY_CSV_PATH "soundwave_latency.csv"
+#define LATENCY_SAMPLE_RATE 44100
+
+_Static_assert(VISUALIZER_LAYER_COUNT <= FRAME_TRACE_MAX_LAYERS, "camadas a mais para o trace");
+
+// Nomes das camadas em --layer-rate (na ordem de VisualizerLayer)
+static const char* const LAYER_NAMES[VISUALIZER_LAYER_COUNT] = {
+    "background", "waveform", "bars", "particles"
+};
+
+// Opções de linha de comando
+typedef struct {
+    const char* audio_file;
+    bool force_software;
+    bool trails;
+    bool glow;
+    int render_threads;        // -1 = padrão do visualizador
+    int particles;             // 0 = padrão do visualizador
+    VisualizerBlend particle_blend;
+    double history_seconds;    // 0 = padrão do visualizador
+    bool spectrogram;          // Espectrograma como fundo
+    int bars;                  // Barras de frequência (0 = desligadas)
+    BarScale bar_scale;
+    double layer_rates[VISUALIZER_LAYER_COUNT];   // Hz por camada (0 = a cada quadro)
+    uint64_t particle_seed;
+    
+    // Ritmo dos quadros (janela e exportação)
+    int fps;
+    bool vsync;                // Acompanha o monitor em vez de fps
+    bool hud;                  // HUD de desempenho visível ao iniciar
+    bool fixed_quality;        // Desliga o ajuste automático de qualidade
+    
+    // Exportação sem janela (NULL = visualização em tempo real)
+    const char* export_path;
+    
+    // Memória compartilhada com os quadros de análise (NULL = sem publicação)
+    const char* publish_name;
+    
+    // Detecção do formato ao abrir o arquivo (zeros = padrão do FFmpeg)
+    AudioDecoderProbe decoder_probe;
+    
+    // Faixa pré-calculada (.swv) usada no lugar da análise (NULL = ao vivo)
+    const char* replay_path;
+    
+    // Extração em lote: todos os arquivos e diretórios da linha de comando
+    bool batch;
+    const char* batch_dir;     // NULL = CSV ao lado de cada arquivo
+    bool batch_tracks;         // Grava também a faixa pré-calculada (.swv)
+    const char** inputs;
+    int num_inputs;
+    
+    // Teste de sincronia A/V sem janela nem som (0 = desligado)
+    double latency_seconds;
+    
+    // Trace da sessão: gravação (junto da visualização) e replay sem áudio
+    const char* trace_record_path;
+    const char* trace_replay_path;
+} AppOptions;
+
+static void print_usage(const char* program) {
+    fprintf(stderr, "Uso: %s [opções] <arquivo_de_audio>\n", program);
+    fprintf(stderr, "     %s --batch [--batch-dir DIR] <arquivos ou diretórios>...\n", program);
+    fprintf(stderr, "     %s --latency-test SEGUNDOS [opções]\n", program);
+    fprintf(stderr, "     %s --trace-replay ARQUIVO.swt\n", program);
+    fprintf(stderr, "Exemplo: %s Feelings\\ V4.mp3\n", program);
+    fprintf(stderr, "Opções:\n");
+    fprintf(stderr, "  --software                  Rasteriza em CPU e envia uma textura por quadro\n");
+    fprintf(stderr, "  --trails                    Rastro entre quadros (backend software)\n");
+    fprintf(stderr, "  --glow                      Brilho em torno das waveforms (backend software)\n");
+    fprintf(stderr, "  --threads N                 Threads de rasterização (backend software, 0 = automático; no lote, faixas simultâneas)\n");
+    fprintf(stderr, "  --particles N               Máximo de partículas vivas (até 100000)\n");
+    fprintf(stderr, "  --particle-blend add|alpha  Mistura das partículas (padrão: add)\n");
+    fprintf(stderr, "  --history S                 Duração do scroll da waveform em segundos\n");
+    fprintf(stderr, "  --spectrogram               Espectrograma (waterfall) como fundo\n");
+    fprintf(stderr, "  --bars N                    Barras de frequência (até %d, 0 = desligadas)\n", BAR_LAYOUT_MAX_BARS);
+    fprintf(stderr, "  --bar-scale log|mel         Espaçamento das barras (padrão: log)\n");
+    fprintf(stderr, "  --layer-rate CAMADA=HZ      Redesenha a camada (background, waveform, bars, particles) HZ vezes por segundo\n");
+    fprintf(stderr, "  --seed N                    Semente das partículas (padrão fixo)\n");
+    fprintf(stderr, "  --hud                       Mostra o HUD de desempenho (tecla H alterna, P grava %s e %s)\n",
+            PERF_CSV_PATH, PERF_TRACE_PATH);
+    fprintf(stderr, "  --export ARQUIVO            Renderiza sem janela e exporta vídeo (.y4m, .rgba, - = Y4M na saída padrão, outros = codificado com áudio)\n");
+    fprintf(stderr, "  --fps N                     Quadros por segundo (padrão: %d)\n", TARGET_FPS);
+    fprintf(stderr, "  --vsync                     Quadros no ritmo do monitor (ignora --fps na janela)\n");
+    fprintf(stderr, "  --fixed-quality             Não reduz a qualidade quando o quadro estoura o orçamento\n");
+    fprintf(stderr, "  --batch                     Extrai características de todos os arquivos em paralelo (um CSV por faixa)\n");
+    fprintf(stderr, "  --batch-dir DIR             Diretório dos CSVs do lote (padrão: ao lado de cada arquivo)\n");
+    fprintf(stderr, "  --batch-swv                 Grava também a faixa pré-calculada (.swv) de cada arquivo do lote\n");
+    fprintf(stderr, "  --replay ARQUIVO.swv        Reproduz a análise de uma faixa pré-calculada (gerada se faltar)\n");
+    fprintf(stderr, "  --trace-record ARQUIVO.swt  Grava cada quadro desenhado (entradas, instantes e semente) para replay\n");
+    fprintf(stderr, "  --trace-replay ARQUIVO.swt  Repete um trace sem áudio nem janela, o mais rápido possível, e mede cada etapa\n");
+    fprintf(stderr, "  --latency-test S            Mede a sincronia A/V com uma faixa de cliques de S segundos (driver de áudio dummy, sem janela)\n");
+    fprintf(stderr, "  --probe-size BYTES          Bytes lidos para detectar o formato do arquivo (padrão do FFmpeg: 5000000)\n");
+    fprintf(stderr, "  --probe-ms MS               Duração analisada para obter os parâmetros do stream (padrão do FFmpeg: 5000)\n");
+    fprintf(stderr, "  --fast-probe                Abre pelo cabeçalho, sem analisar o início do stream quando ele já basta\n");
+    fprintf(stderr, "  --publish NOME              Publica os quadros de análise em memória compartilhada (ex: %s)\n",
+            SHM_DEFAULT_NAME);
+}
+
+// Lê CAMADA=HZ de --layer-rate
+// Retorna: false se a camada for desconhecida ou a taxa inválida
+static bool parse_layer_rate(const char* arg, AppOptions* opts) {
+    const char* eq = strchr(arg, '=');
+    if (!eq) return false;
+    
+    char* end = NULL;
+    double hz = strtod(eq + 1, &end);
+    if (end == eq + 1 || *end != '\0' || hz < 0.0) return false;
+    
+    for (int layer = 0; layer < VISUALIZER_LAYER_COUNT; layer++) {
+        if (strlen(LAYER_NAMES[layer]) == (size_t)(eq - arg) &&
+            strncmp(arg, LAYER_NAMES[layer], eq - arg) == 0) {
+            opts->layer_rates[layer] = hz;
+            return true;
+        }
     }
+    return false;
+}
+
+// Lê as opções; retorna false (após imprimir o uso) se forem inválidas
+static bool parse_options(int argc, char* argv[], AppOptions* opts) {
+    memset(opts, 0, sizeof(*opts));
+    opts->render_threads = -1;
+    opts->particle_blend = VISUALIZER_BLEND_ADD;
+    opts->fps = TARGET_FPS;
+    opts->bar_scale = BAR_SCALE_LOG;
+    opts->particle_seed = VISUALIZER_PARTICLE_SEED;
     
-    const char* audio_file = argv[1];
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--software") == 0) {
+            opts->force_software = true;
+        } else if (strcmp(argv[i], "--trails") == 0) {
+            opts->trails = true;
+        } else if (strcmp(argv[i], "--glow") == 0) {
+            opts->glow = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            opts->render_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            opts->particles = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--particle-blend") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            if (strcmp(mode, "add") == 0) {
+                opts->particle_blend = VISUALIZER_BLEND_ADD;
+            } else if (strcmp(mode, "alpha") == 0) {
+                opts->particle_blend = VISUALIZER_BLEND_ALPHA;
+            } else {
+                fprintf(stderr, "Mistura desconhecida: %s\n", mode);
+                print_usage(argv[0]);
+                return false;
+            }
+        } else if (strcmp(argv[i], "--history") == 0 && i + 1 < argc) {
+            opts->history_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--spectrogram") == 0) {
+            opts->spectrogram = true;
+        } else if (strcmp(argv[i], "--bars") == 0 && i + 1 < argc) {
+            opts->bars = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bar-scale") == 0 && i + 1 < argc) {
+            const char* scale = argv[++i];
+            if (strcmp(scale, "log") == 0) {
+                opts->bar_scale = BAR_SCALE_LOG;
+            } else if (strcmp(scale, "mel") == 0) {
+                opts->bar_scale = BAR_SCALE_MEL;
+            } else {
+                fprintf(stderr, "Escala desconhecida: %s\n", scale);
+                print_usage(argv[0]);
+                return false;
+            }
+        } else if (strcmp(argv[i], "--layer-rate") == 0 && i + 1 < argc) {
+            if (!parse_layer_rate(argv[++i], opts)) {
+                fprintf(stderr, "Taxa de camada inválida: %s\n", argv[i]);
+                print_usage(argv[0]);
+                return false;
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            opts->particle_seed = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc) {
+            opts->export_path = argv[++i];
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            opts->fps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--vsync") == 0) {
+            opts->vsync = true;
+        } else if (strcmp(argv[i], "--hud") == 0) {
+            opts->hud = true;
+        } else if (strcmp(argv[i], "--fixed-quality") == 0) {
+            opts->fixed_quality = true;
+        } else if (strcmp(argv[i], "--probe-size") == 0 && i + 1 < argc) {
+            opts->decoder_probe.probe_bytes = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--probe-ms") == 0 && i + 1 < argc) {
+            opts->decoder_probe.analyze_us = (int64_t)(atof(argv[++i]) * 1000.0);
+        } else if (strcmp(argv[i], "--fast-probe") == 0) {
+            opts->decoder_probe.header_only = true;
+        } else if (strcmp(argv[i], "--publish") == 0 && i + 1 < argc) {
+            opts->publish_name = argv[++i];
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            opts->batch = true;
+        } else if (strcmp(argv[i], "--batch-dir") == 0 && i + 1 < argc) {
+            opts->batch_dir = argv[++i];
+        } else if (strcmp(argv[i], "--batch-swv") == 0) {
+            opts->batch_tracks = true;
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            opts->replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--latency-test") == 0 && i + 1 < argc) {
+            opts->latency_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--trace-record") == 0 && i + 1 < argc) {
+            opts->trace_record_path = argv[++i];
+        } else if (strcmp(argv[i], "--trace-replay") == 0 && i + 1 < argc) {
+            opts->trace_replay_path = argv[++i];
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            fprintf(stderr, "Opção desconhecida: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return false;
+        } else {
+            // Posicionais vão para o início de argv, na ordem (como no getopt)
+            opts->audio_file = argv[i];
+            argv[1 + opts->num_inputs++] = argv[i];
+        }
+    }
+    opts->inputs = (const char**)(argv + 1);
     
-    // Inicializa decodificador de áudio (para reprodução)
-    printf("Inicializando decodificador de áudio...\n");
-    AudioDecoder* decoder = audio_decoder_init(audio_file);
-    if (!decoder || !audio_decoder_is_valid(decoder)) {
-        fprintf(stderr, "Erro ao inicializar decodificador de áudio\n");
+    if (!opts->audio_file && opts->latency_seconds <= 0.0 && !opts->trace_replay_path) {
+        print_usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+// Aplica as opções de renderização ao visualizador
+static void apply_visualizer_options(Visualizer* vis, const AppOptions* opts, int sample_rate) {
+    visualizer_set_audio_format(vis, sample_rate, FFT_WINDOW_SIZE);
+    if (opts->render_threads >= 0) {
+        visualizer_set_render_threads(vis, opts->render_threads);
+    }
+    if (opts->force_software && !visualizer_set_backend(vis, VISUALIZER_BACKEND_SOFTWARE)) {
+        fprintf(stderr, "Backend software indisponível, usando SDL\n");
+    }
+    if (opts->trails) {
+        visualizer_set_trails(vis, TRAIL_PERSISTENCE);
+    }
+    visualizer_set_glow(vis, opts->glow);
+    if (opts->particles > 0 && !visualizer_set_particle_capacity(vis, opts->particles)) {
+        fprintf(stderr, "Capacidade de partículas inválida: %d\n", opts->particles);
+    }
+    visualizer_set_particle_seed(vis, opts->particle_seed);
+    visualizer_set_particle_blend(vis, opts->particle_blend);
+    visualizer_set_bar_scale(vis, opts->bar_scale);
+    if (opts->history_seconds > 0.0 &&
+        !visualizer_set_scroll_history(vis, (uint64_t)(opts->history_seconds * sample_rate))) {
+        fprintf(stderr, "Histórico de scroll muito longo: %.1f s\n", opts->history_seconds);
+    }
+    for (int layer = 0; layer < VISUALIZER_LAYER_COUNT; layer++) {
+        if (opts->layer_rates[layer] > 0.0 &&
+            !visualizer_set_layer_rate(vis, (VisualizerLayer)layer, opts->layer_rates[layer])) {
+            fprintf(stderr, "Taxa da camada %s indisponível, redesenhando a cada quadro\n", LAYER_NAMES[layer]);
+        }
+    }
+}
+
+// Opções de renderização gravadas no cabeçalho do trace
+static void trace_config_from_options(const AppOptions* opts, int sample_rate, FrameTraceConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->width = WINDOW_WIDTH;
+    config->height = WINDOW_HEIGHT;
+    config->sample_rate = sample_rate;
+    config->fft_size = FFT_WINDOW_SIZE;
+    config->particle_seed = opts->particle_seed;
+    config->particles = opts->particles;
+    config->particle_blend = (int)opts->particle_blend;
+    config->bars = opts->bars;
+    config->bar_scale = (int)opts->bar_scale;
+    config->spectrogram = opts->spectrogram;
+    config->trails = opts->trails;
+    config->glow = opts->glow;
+    config->software = opts->force_software;
+    config->history_seconds = opts->history_seconds;
+    for (int layer = 0; layer < VISUALIZER_LAYER_COUNT; layer++) {
+        config->layer_rates[layer] = opts->layer_rates[layer];
+    }
+}
+
+// Aplica um nível de qualidade às opções escolhidas pelo usuário
+// base: opções originais; active: opções usadas no desenho (barras reduzidas)
+// base_particles: capacidade de partículas no nível 0
+static void apply_quality_level(Visualizer* vis, AudioPipeline* pipeline, const QualitySettings* level,
+                                const AppOptions* base, AppOptions* active, int base_particles) {
+    int particles = (int)(base_particles * level->particle_scale);
+    visualizer_set_particle_capacity(vis, particles > 0 ? particles : 1);
+    visualizer_set_waveform_detail(vis, level->line_scale, level->waveform_step);
+    
+    active->bars = (int)(base->bars * level->bar_scale);
+    if (base->bars > 0 && active->bars < 1) active->bars = 1;
+    
+    audio_pipeline_set_analysis_hop(pipeline, level->analysis_hop);
+}
+
+// Desenha as camadas de um quadro de análise
+// fresh: false se o quadro já foi desenhado antes (não repete samples no histórico)
+// now: instante do quadro em ns (camadas com taxa própria comparam com o último redesenho)
+// stats: mede cada camada e o present (NULL = sem medição)
+// hud_text: texto do HUD por cima das camadas (NULL = sem HUD)
+static void draw_analysis_frame(Visualizer* vis, const AppOptions* opts, const AnalysisFrame* frame,
+                                bool fresh, uint64_t now, PerfStats* stats, const char* hud_text) {
+    uint64_t frame_start = perf_stats_begin(stats);
+    uint64_t t = frame_start;
+    
+    // Limpa tela
+    visualizer_clear(vis);
+    
+    // 0. Espectrograma de fundo (uma linha nova por quadro de análise)
+    if (opts->spectrogram && frame && frame->spectrum_ready) {
+        visualizer_begin_layer(vis, VISUALIZER_LAYER_BACKGROUND, now);
+        visualizer_draw_spectrogram(vis, fresh ? frame->frequencies : NULL, frame->num_bins);
+        visualizer_end_layer(vis);
+        t = perf_stats_end(stats, PERF_STAGE_SPECTROGRAM, t);
+    }
+    
+    // Desenha múltiplas camadas de visualização (numa camada que não será
+    // redesenhada as chamadas só avançam o estado)
+    if (frame && frame->spectrum_ready) {
+        // 1. Waveform fluida/ambient
+        visualizer_begin_layer(vis, VISUALIZER_LAYER_WAVEFORM, now);
+        visualizer_draw_fluid_waveform(vis, frame->samples, frame->num_samples,
+                                       frame->frequencies, frame->colors);
+        visualizer_end_layer(vis);
+        t = perf_stats_end(stats, PERF_STAGE_WAVEFORM, t);
+        
+        // 2. Barras de frequência
+        if (opts->bars > 0) {
+            visualizer_begin_layer(vis, VISUALIZER_LAYER_BARS, now);
+            visualizer_draw_frequency_bars(vis, frame->frequencies, frame->num_bins, opts->bars);
+            visualizer_end_layer(vis);
+            t = perf_stats_end(stats, PERF_STAGE_BARS, t);
+        }
+        
+        // 3. Partículas (simulação a cada quadro, desenho no ritmo da camada)
+        visualizer_begin_layer(vis, VISUALIZER_LAYER_PARTICLES, now);
+        visualizer_update_particles(vis, frame->frequencies, frame->num_bins);
+        visualizer_draw_particles(vis);
+        visualizer_end_layer(vis);
+        t = perf_stats_end(stats, PERF_STAGE_PARTICLES, t);
+    } else if (frame) {
+        // Fallback: waveform simples enquanto carrega (só adiciona quadros novos)
+        visualizer_begin_layer(vis, VISUALIZER_LAYER_WAVEFORM, now);
+        visualizer_draw_waveform_scroll(vis, frame->samples, fresh ? frame->num_samples : 0,
+                                        frame->colors);
+        visualizer_end_layer(vis);
+        t = perf_stats_end(stats, PERF_STAGE_WAVEFORM, t);
+    }
+    
+    if (hud_text) {
+        visualizer_draw_text(vis, HUD_MARGIN, HUD_MARGIN, HUD_SCALE, hud_text, (RGBColor){220, 255, 220});
+        t = perf_stats_begin(stats);
+    }
+    
+    // Atualiza tela
+    visualizer_present(vis);
+    perf_stats_end(stats, PERF_STAGE_PRESENT, t);
+    perf_stats_end(stats, PERF_STAGE_FRAME, frame_start);
+}
+
+// Escolhe o formato de exportação pela extensão do arquivo
+static VideoExportFormat export_format_for_path(const char* path) {
+    const char* ext = strrchr(path, '.');
+    if (strcmp(path, "-") == 0 || (ext && strcmp(ext, ".y4m") == 0)) {
+        return VIDEO_EXPORT_Y4M;
+    }
+    if (ext && (strcmp(ext, ".rgba") == 0 || strcmp(ext, ".raw") == 0)) {
+        return VIDEO_EXPORT_RAW;
+    }
+    return VIDEO_EXPORT_ENCODE;
+}
+
+// Renderiza o arquivo inteiro sem janela, guiado pelo tempo do arquivo (não
+// pelo relógio): cada quadro consome sample_rate / fps samples e é entregue
+// ao exportador, que converte/codifica numa thread própria
+static int run_export(const AppOptions* opts, AudioDecoder* decoder, AudioAnalyzer* analyzer,
+                      int sample_rate) {
+    int fps = opts->fps;
+    if (fps <= 0 || (sample_rate + fps - 1) / fps > ANALYSIS_MAX_BLOCK) {
+        fprintf(stderr, "FPS de exportação inválido: %d\n", fps);
         return 1;
     }
     
-    // Inicializa segundo decodificador para visualização (sincronizado)
-    AudioDecoder* vis_decoder = audio_decoder_init(audio_file);
-    if (!vis_decoder || !audio_decoder_is_valid(vis_decoder)) {
-        fprintf(stderr, "Erro ao inicializar decodificador de visualização\n");
-        audio_decoder_free(decoder);
+    // Visualizador sem janela (framebuffer em CPU, determinístico)
+    Visualizer* vis = visualizer_init_headless(WINDOW_WIDTH, WINDOW_HEIGHT);
+    if (!vis) {
+        fprintf(stderr, "Erro ao inicializar visualizador sem janela\n");
         return 1;
     }
+    apply_visualizer_options(vis, opts, sample_rate);
     
-    int sample_rate = audio_decoder_get_sample_rate(decoder);
-    printf("Taxa de amostragem: %d Hz\n", sample_rate);
+    VideoExporter* exporter = video_exporter_open(opts->export_path, export_format_for_path(opts->export_path),
+                                                  WINDOW_WIDTH, WINDOW_HEIGHT, fps, sample_rate);
+    AnalysisFrame* frame = mem_alloc(sizeof(AnalysisFrame));
+    int16_t* block = mem_alloc(ANALYSIS_MAX_BLOCK * sizeof(int16_t));
     
-    // Inicializa player de áudio
-    printf("Inicializando player de áudio...\n");
-    AudioPlayer* player = audio_player_init(sample_rate, 1);  // Mono
-    if (!player) {
-        fprintf(stderr, "Erro ao inicializar player de áudio\n");
-        audio_decoder_free(vis_decoder);
-        audio_decoder_free(decoder);
+    if (!exporter || !frame || !block) {
+        fprintf(stderr, "Erro ao iniciar exportação: %s\n", opts->export_path);
+        if (block) mem_free(block);
+        if (frame) mem_free(frame);
+        if (exporter) video_exporter_close(exporter);
+        visualizer_free(vis);
         return 1;
     }
     
-    // Inicializa analisador FFT
-    printf("Inicializando analisador FFT...\n");
-    FFTAnalyzer* fft = fft_analyzer_init(sample_rate, FFT_WINDOW_SIZE);
-    if (!fft) {
+    fprintf(stderr, "Exportando para %s (%dx%d, %d FPS)...\n",
+            opts->export_path, WINDOW_WIDTH, WINDOW_HEIGHT, fps);
+    
+    Uint64 start = SDL_GetPerformanceCounter();
+    uint64_t position = 0;
+    uint64_t frame_index = 0;
+    bool ok = true;
+    
+    for (;;) {
+        // Instante do próximo quadro e samples até o fim dele, no tempo do arquivo
+        uint64_t now = frame_index * 1000000000ULL / fps;
+        uint64_t target = (frame_index + 1) * (uint64_t)sample_rate / fps;
+        int samples_read = audio_decoder_read(decoder, block, (int)(target - position));
+        if (samples_read <= 0) {
+            break;
+        }
+        position += samples_read;
+        
+        audio_analyzer_process(analyzer, block, samples_read, frame);
+        frame->sequence = ++frame_index;
+        frame->position = position;
+        
+        draw_analysis_frame(vis, opts, frame, true, now, NULL, NULL);
+        
+        if (!video_exporter_submit(exporter, visualizer_get_pixels(vis), block, samples_read)) {
+            ok = false;
+            break;
+        }
+    }
+    
+    ok = video_exporter_close(exporter) && ok;
+    double elapsed = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    
+    if (ok) {
+        fprintf(stderr, "Exportados %llu quadros (%.1f s de áudio) em %.2f s\n",
+                (unsigned long long)frame_index, (double)position / sample_rate, elapsed);
+    } else {
+        fprintf(stderr, "Erro ao exportar vídeo: %s\n", opts->export_path);
+    }
+    
+    mem_free(block);
+    mem_free(frame);
+    visualizer_free(vis);
+    return ok ? 0 : 1;
+}
+
+// Extrai as características de todas as faixas (--batch)
+static int run_batch(const AppOptions* opts) {
+    // --threads N limita as faixas simultâneas (padrão: uma por núcleo)
+    BatchOptions batch;
+    batch.output_dir = opts->batch_dir;
+    batch.threads = opts->render_threads > 0 ? opts->render_threads : 0;
+    batch.window_size = FFT_WINDOW_SIZE;
+    batch.hop = SAMPLES_PER_FRAME;
+    batch.write_tracks = opts->batch_tracks;
+    return batch_extract(opts->inputs, opts->num_inputs, &batch) == 0 ? 0 : 1;
+}
+
+// Abre a faixa pré-calculada de --replay; se ela faltar ou for de outra
+// faixa ou formato, refaz a análise completa antes de abrir
+// Retorna: NULL se não foi possível (a sessão segue com análise ao vivo)
+static TrackCache* open_track_cache(const AppOptions* opts, AudioAnalyzer* analyzer, int sample_rate) {
+    TrackCache* cache = track_cache_open(opts->replay_path, opts->audio_file);
+    if (cache && (track_cache_get_sample_rate(cache) != sample_rate ||
+                  track_cache_get_window_size(cache) != FFT_WINDOW_SIZE)) {
+        track_cache_free(cache);
+        cache = NULL;
+    }
+    if (cache) {
+        return cache;
+    }
+    
+    printf("Pré-calculando %s...\n", opts->replay_path);
+    AudioDecoder* decoder = audio_decoder_init_probe(opts->audio_file, &opts->decoder_probe);
+    bool built = decoder && audio_decoder_is_valid(decoder) &&
+                 track_cache_build(opts->replay_path, opts->audio_file, decoder, analyzer,
+                                   sample_rate, FFT_WINDOW_SIZE, SAMPLES_PER_FRAME);
+    audio_decoder_free(decoder);
+    
+    cache = built ? track_cache_open(opts->replay_path, opts->audio_file) : NULL;
+    if (!cache) {
+        fprintf(stderr, "Faixa pré-calculada indisponível, analisando ao vivo\n");
+    }
+    return cache;
+}
+
+// Componentes independentes criados em paralelo na inicialização: cada
+// tarefa roda numa thread enquanto a thread principal cria a janela
+typedef struct {
+    const char* audio_file;
+    const AudioDecoderProbe* probe;
+    AudioDecoder* decoder;
+    AudioDecoder* vis_decoder;
+    AudioAnalyzer* analyzer;
+    AudioPlayer* player;
+} StartupTasks;
+
+// Decodificador da reprodução (abertura e detecção do formato)
+static int open_decoder_task(void* data) {
+    StartupTasks* tasks = data;
+    tasks->decoder = audio_decoder_init_probe(tasks->audio_file, tasks->probe);
+    return 0;
+}
+
+// Decodificador da análise (mesmo arquivo, detecção independente)
+static int open_vis_decoder_task(void* data) {
+    StartupTasks* tasks = data;
+    tasks->vis_decoder = audio_decoder_init_probe(tasks->audio_file, tasks->probe);
+    return 0;
+}
+
+// Analisador: planejamento da FFT, bandas e tabelas de cor
+static int init_analyzer_task(void* data) {
+    StartupTasks* tasks = data;
+    tasks->analyzer = audio_analyzer_init(AUDIO_DECODER_SAMPLE_RATE, FFT_WINDOW_SIZE, COLOR_MAPPER_DEFAULT_RESOLUTION);
+    return 0;
+}
+
+// Dispositivo de áudio (o subsistema já foi iniciado pela thread principal)
+static int open_player_task(void* data) {
+    StartupTasks* tasks = data;
+    tasks->player = audio_player_init(AUDIO_DECODER_SAMPLE_RATE, 1);  // Mono
+    return 0;
+}
+
+// Inicia uma tarefa numa thread (sem thread, executa na chamadora)
+// Retorna: a thread a aguardar com SDL_WaitThread (NULL se já terminou)
+static SDL_Thread* start_startup_task(SDL_ThreadFunction task, const char* name, StartupTasks* tasks) {
+    SDL_Thread* thread = SDL_CreateThread(task, name, tasks);
+    if (!thread) {
+        task(tasks);
+    }
+    return thread;
+}
+
+// Libera o que as tarefas de inicialização criaram
+static void free_startup_tasks(StartupTasks* tasks) {
+    audio_analyzer_free(tasks->analyzer);
+    audio_player_free(tasks->player);
+    audio_decoder_free(tasks->vis_decoder);
+    audio_decoder_free(tasks->decoder);
+}
+
+// Executa a visualização (ou a exportação) com os componentes da sessão
+// probe: teste de latência (sem janela; mede cada quadro até o último clique)
+static int run_session(const AppOptions* opts, LatencyProbe* probe) {
+    uint64_t startup_ns = frame_clock_now_ns();
+    bool exporting = opts->export_path != NULL;
+    
+    // A saída do decodificador tem taxa fixa: nada depende da detecção do arquivo
+    int sample_rate = AUDIO_DECODER_SAMPLE_RATE;
+    
+    StartupTasks tasks;
+    memset(&tasks, 0, sizeof(tasks));
+    tasks.audio_file = opts->audio_file;
+    tasks.probe = &opts->decoder_probe;
+    
+    // Na exportação a saída padrão pode ser o próprio vídeo: nada de printf
+    if (!exporting) {
+        printf("Inicializando decodificadores, analisador FFT e áudio em paralelo...\n");
+        
+        // SDL_Init não pode rodar em duas threads ao mesmo tempo: o áudio é
+        // iniciado aqui, antes de a janela iniciar o vídeo (só a abertura do
+        // dispositivo fica na thread da tarefa)
+        if (!SDL_WasInit(SDL_INIT_AUDIO) && SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+            fprintf(stderr, "Erro ao inicializar SDL Audio: %s\n", SDL_GetError());
+            return 1;
+        }
+    }
+    
+    SDL_Thread* threads[4];
+    int num_threads = 0;
+    threads[num_threads++] = start_startup_task(open_decoder_task, "soundwave-decoder", &tasks);
+    threads[num_threads++] = start_startup_task(init_analyzer_task, "soundwave-fft", &tasks);
+    if (!exporting) {
+        threads[num_threads++] = start_startup_task(open_vis_decoder_task, "soundwave-vis-decoder", &tasks);
+        threads[num_threads++] = start_startup_task(open_player_task, "soundwave-device", &tasks);
+    }
+    
+    // Janela e renderer na thread principal, enquanto as tarefas rodam; um
+    // quadro vazio já é apresentado para a janela não aparecer sem conteúdo
+    Visualizer* vis = NULL;
+    if (!exporting) {
+        printf("Inicializando visualizador...\n");
+        vis = probe ? visualizer_init_headless(WINDOW_WIDTH, WINDOW_HEIGHT) :
+            visualizer_init(WINDOW_WIDTH, WINDOW_HEIGHT, "SoundWave - Visualização de Áudio");
+        if (vis) {
+            visualizer_clear(vis);
+            visualizer_present(vis);
+        }
+    }
+    
+    for (int i = 0; i < num_threads; i++) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    
+    if (!tasks.decoder || !audio_decoder_is_valid(tasks.decoder)) {
+        fprintf(stderr, "Erro ao inicializar decodificador de áudio\n");
+        visualizer_free(vis);
+        free_startup_tasks(&tasks);
+        return 1;
+    }
+    if (!tasks.analyzer) {
         fprintf(stderr, "Erro ao inicializar analisador FFT\n");
-        audio_player_free(player);
-        audio_decoder_free(vis_decoder);
-        audio_decoder_free(decoder);
+        visualizer_free(vis);
+        free_startup_tasks(&tasks);
         return 1;
     }
     
-    // Inicializa visualizador
-    printf("Inicializando visualizador...\n");
-    Visualizer* vis = visualizer_init(WINDOW_WIDTH, WINDOW_HEIGHT, "SoundWave - Visualização de Áudio");
-    if (!vis) {
-        fprintf(stderr, "Erro ao inicializar visualizador\n");
-        fft_analyzer_free(fft);
-        audio_player_free(player);
-        audio_decoder_free(vis_decoder);
-        audio_decoder_free(decoder);
+    // Exportação: um único decodificador, sem áudio nem janela
+    if (exporting) {
+        int status = run_export(opts, tasks.decoder, tasks.analyzer, sample_rate);
+        free_startup_tasks(&tasks);
+        return status;
+    }
+    
+    if (!tasks.vis_decoder || !audio_decoder_is_valid(tasks.vis_decoder) || !tasks.player || !vis) {
+        if (!tasks.vis_decoder || !audio_decoder_is_valid(tasks.vis_decoder)) {
+            fprintf(stderr, "Erro ao inicializar decodificador de visualização\n");
+        }
+        if (!tasks.player) {
+            fprintf(stderr, "Erro ao inicializar player de áudio\n");
+        }
+        if (!vis) {
+            fprintf(stderr, "Erro ao inicializar visualizador\n");
+        }
+        visualizer_free(vis);
+        free_startup_tasks(&tasks);
         return 1;
     }
     
-    // Buffers
-    int16_t* audio_buffer = malloc(SAMPLES_PER_FRAME * sizeof(int16_t));
-    int16_t* fft_buffer = malloc(FFT_WINDOW_SIZE * sizeof(int16_t));
-    double* frequencies = malloc((FFT_WINDOW_SIZE / 2 + 1) * sizeof(double));
-    RGBColor* colors = malloc(SAMPLES_PER_FRAME * sizeof(RGBColor));
+    AudioDecoder* decoder = tasks.decoder;
+    AudioDecoder* vis_decoder = tasks.vis_decoder;
+    AudioPlayer* player = tasks.player;
+    AudioAnalyzer* analyzer = tasks.analyzer;
+    printf("Taxa de amostragem: %d Hz\n", sample_rate);
+    printf("Inicialização em %.0f ms\n", (frame_clock_now_ns() - startup_ns) / 1e6);
+    
+    // Replay: quadros lidos da faixa pré-calculada em vez da FFT
+    TrackCache* track_cache = opts->replay_path ? open_track_cache(opts, analyzer, sample_rate) : NULL;
+    
+    apply_visualizer_options(vis, opts, sample_rate);
     
-    if (!audio_buffer || !fft_buffer || !frequencies || !colors) {
-        fprintf(stderr, "Erro ao alocar buffers\n");
-        if (colors) free(colors);
-        if (frequencies) free(frequencies);
-        if (fft_buffer) free(fft_buffer);
-        if (audio_buffer) free(audio_buffer);
+    // Pipeline: threads de áudio e análise; esta thread só renderiza
+    // Instrumentação por etapa (sem ela, o programa roda sem HUD)
+    PerfStats* stats = perf_stats_init();
+    if (!stats) {
+        fprintf(stderr, "Instrumentação indisponível\n");
+    }
+    
+    // Publicação para outros processos (sem ela, só a janela recebe os quadros)
+    FramePublisher* publisher = NULL;
+    if (opts->publish_name) {
+        publisher = frame_publisher_init(opts->publish_name, sample_rate, FFT_WINDOW_SIZE);
+        if (publisher) {
+            printf("Publicando quadros de análise em %s\n", opts->publish_name);
+        } else {
+            fprintf(stderr, "Publicação em memória compartilhada indisponível\n");
+        }
+    }
+    
+    AudioPipeline* pipeline = audio_pipeline_init(decoder, vis_decoder, player, analyzer,
+                                                  sample_rate, SAMPLES_PER_FRAME);
+    audio_pipeline_set_perf_stats(pipeline, stats);
+    audio_pipeline_set_publisher(pipeline, publisher);
+    audio_pipeline_set_track_cache(pipeline, track_cache);
+    if (!pipeline || !audio_pipeline_start(pipeline)) {
+        fprintf(stderr, "Erro ao iniciar pipeline de áudio\n");
+        audio_pipeline_free(pipeline);
+        frame_publisher_free(publisher);
+        perf_stats_free(stats);
         visualizer_free(vis);
-        fft_analyzer_free(fft);
+        track_cache_free(track_cache);
+        audio_analyzer_free(analyzer);
         audio_player_free(player);
         audio_decoder_free(vis_decoder);
         audio_decoder_free(decoder);
         return 1;
     }
     
-    // Buffer circular para acumular samples para FFT
-    int16_t* fft_circular = malloc(FFT_WINDOW_SIZE * sizeof(int16_t));
-    int fft_circular_pos = 0;
-    bool fft_buffer_ready = false;
+    printf("Iniciando visualização...\n");
+    printf("Pressione ESC ou Q para sair\n");
     
-    if (!fft_circular) {
-        fprintf(stderr, "Erro ao alocar buffer circular FFT\n");
-        free(colors);
-        free(frequencies);
-        free(fft_buffer);
-        free(audio_buffer);
+    // Ritmo dos quadros: vsync do monitor ou prazos fixos no relógio monotônico
+    int vsync_rate = opts->vsync ? visualizer_get_vsync_rate(vis) : 0;
+    if (opts->vsync && vsync_rate <= 0) {
+        fprintf(stderr, "Vsync indisponível, usando %d FPS\n", opts->fps);
+    }
+    FrameScheduler* scheduler = vsync_rate > 0 ?
+        frame_scheduler_init(vsync_rate, FRAME_PACING_DISPLAY) :
+        frame_scheduler_init(opts->fps > 0 ? opts->fps : TARGET_FPS, FRAME_PACING_FIXED);
+    if (!scheduler) {
+        fprintf(stderr, "Erro ao criar agendador de quadros\n");
+        audio_pipeline_free(pipeline);
+        frame_publisher_free(publisher);
+        perf_stats_free(stats);
         visualizer_free(vis);
-        fft_analyzer_free(fft);
+        track_cache_free(track_cache);
+        audio_analyzer_free(analyzer);
         audio_player_free(player);
         audio_decoder_free(vis_decoder);
         audio_decoder_free(decoder);
         return 1;
     }
     
-    // Pré-carrega buffer de áudio antes de começar (cerca de 500ms)
-    printf("Pré-carregando buffer de áudio...\n");
-    const int preload_samples = sample_rate / 2;  // 500ms
-    int16_t* preload_buffer = malloc(preload_samples * sizeof(int16_t));
-    int preload_read = audio_decoder_read(decoder, preload_buffer, preload_samples);
-    if (preload_read > 0) {
-        audio_player_queue(player, preload_buffer, preload_read);
-        // Sincroniza decoder de visualização (lê os mesmos samples)
-        int16_t* vis_preload = malloc(preload_samples * sizeof(int16_t));
-        audio_decoder_read(vis_decoder, vis_preload, preload_read);
-        free(vis_preload);
-    }
-    free(preload_buffer);
+    // Qualidade adaptativa: orçamento de um quadro no ritmo escolhido
+    // (sem governador a qualidade fica fixa no nível 0)
+    double budget_ms = frame_scheduler_get_period_ns(scheduler) / 1000000.0;
+    QualityGovernor* governor = opts->fixed_quality ? NULL : quality_governor_init(budget_ms, vsync_rate > 0);
+    AppOptions active = *opts;
+    int base_particles = visualizer_get_particle_capacity(vis);
     
-    // Variáveis para sincronização
-    uint64_t vis_decoder_position = preload_read;  // Posição atual do decoder de visualização
+    // Gravação da sessão: opções, semente e um registro por quadro desenhado
+    FrameTraceWriter* trace_writer = NULL;
+    if (opts->trace_record_path) {
+        FrameTraceConfig trace_config;
+        trace_config_from_options(opts, sample_rate, &trace_config);
+        trace_writer = frame_trace_writer_open(opts->trace_record_path, &trace_config);
+        if (trace_writer) {
+            printf("Gravando trace em %s\n", opts->trace_record_path);
+        } else {
+            fprintf(stderr, "Gravação do trace indisponível\n");
+        }
+    }
     
-    printf("Iniciando visualização...\n");
-    printf("Pressione ESC ou Q para sair\n");
+    // Fim da inicialização: daqui em diante cada alocação vai para o heap e é contada
+    mem_seal_session();
     
-    // Loop principal
+    // Loop de renderização: desenha sempre o último quadro de análise publicado
     bool running = true;
-    clock_t last_frame_time = clock();
-    clock_t last_audio_time = clock();
-    const double target_fps = 60.0;
-    const double frame_time = 1.0 / target_fps;
+    bool show_hud = opts->hud && stats;
+    char hud_text[1024] = "";
+    uint64_t hud_updated = 0;
+    int dropped = 0;
+    bool first_frame_shown = false;
     
-    // Buffer mínimo de áudio (cerca de 200ms) para evitar stuttering
-    const int min_buffer_samples = sample_rate / 5;
-    const double audio_update_interval = 0.01;  // Atualiza áudio a cada 10ms
+    // Alocações em regime: contadas a partir do fim do aquecimento (que
+    // recomeça a cada mudança de qualidade, pois os buffers mudam de tamanho)
+    int warmup = WARMUP_FRAMES;
+    uint64_t steady_allocations = 0;   // Períodos em regime já encerrados
+    uint64_t steady_base = 0;          // Contador no início do período atual
     
     while (running) {
-        clock_t current_time = clock();
-        double elapsed = ((double)(current_time - last_frame_time)) / CLOCKS_PER_SEC;
-        double audio_elapsed = ((double)(current_time - last_audio_time)) / CLOCKS_PER_SEC;
+        // Verifica se deve fechar
+        if (visualizer_should_close(vis)) {
+            running = false;
+            break;
+        }
         
-        // Mantém buffer de áudio cheio (independente do FPS visual)
-        if (audio_elapsed >= audio_update_interval) {
-            int queued = audio_player_get_queued_samples(player);
-            
-            // Enfileira mais samples se o buffer estiver baixo
-            while (queued < min_buffer_samples) {
-                int16_t temp_buffer[1024];
-                int temp_read = audio_decoder_read(decoder, temp_buffer, 1024);
-                if (temp_read > 0) {
-                    audio_player_queue(player, temp_buffer, temp_read);
-                    queued += temp_read;
-                } else {
-                    // Fim do áudio, reinicia
-                    printf("Fim do áudio. Reiniciando...\n");
-                    audio_player_clear(player);
-                    audio_decoder_rewind(decoder);
-                    // Pré-carrega novamente
-                    preload_buffer = malloc(preload_samples * sizeof(int16_t));
-                    preload_read = audio_decoder_read(decoder, preload_buffer, preload_samples);
-                    if (preload_read > 0) {
-                        audio_player_queue(player, preload_buffer, preload_read);
-                        // Sincroniza decoder de visualização
-                        int16_t* vis_preload = malloc(preload_samples * sizeof(int16_t));
-                        audio_decoder_read(vis_decoder, vis_preload, preload_read);
-                        free(vis_preload);
-                        vis_decoder_position = preload_read;
-                    }
-                    free(preload_buffer);
-                    fft_circular_pos = 0;
-                    fft_buffer_ready = false;
-                    queued = audio_player_get_queued_samples(player);
+        // H alterna o HUD; P grava as estatísticas
+        int key;
+        while ((key = visualizer_poll_key(vis)) != 0) {
+            if (key == SDLK_h && stats) {
+                show_hud = !show_hud;
+            } else if (key == SDLK_p && stats) {
+                if (perf_stats_write_csv(stats, PERF_CSV_PATH) && perf_stats_write_trace(stats, PERF_TRACE_PATH)) {
+                    printf("Estatísticas gravadas em %s e %s\n", PERF_CSV_PATH, PERF_TRACE_PATH);
                 }
             }
-            last_audio_time = current_time;
         }
         
-        // Controle de FPS visual
-        if (elapsed < frame_time) {
-            continue;
+        bool fresh = false;
+        const AnalysisFrame* frame = audio_pipeline_latest_frame(pipeline, &fresh);
+        uint64_t played = audio_player_get_played_samples(player);
+        
+        // Defasagem A/V: fim do bloco exibido menos a posição reproduzida
+        if (frame && stats) {
+            int64_t offset = (int64_t)frame->position - (int64_t)played;
+            perf_stats_set_av_offset(stats, offset * 1000.0 / sample_rate);
         }
-        last_frame_time = current_time;
         
-        // Verifica se deve fechar
-        if (visualizer_should_close(vis)) {
+        // Teste de latência: registra o relógio de reprodução a cada quadro
+        if (probe && !latency_probe_record(probe, frame_clock_now_ns(), played, frame)) {
             running = false;
             break;
         }
         
-        // Sincroniza decoder de visualização com a posição do áudio reproduzido
-        uint64_t current_played = audio_player_get_played_samples(player);
-        uint64_t samples_to_sync = current_played - vis_decoder_position;
-        
-        // Se a visualização está atrás do áudio, avança o decoder
-        if (samples_to_sync > SAMPLES_PER_FRAME * 2) {
-            // Avança lendo e descartando samples até sincronizar
-            int16_t* sync_buffer = malloc(SAMPLES_PER_FRAME * sizeof(int16_t));
-            while (samples_to_sync > SAMPLES_PER_FRAME && vis_decoder_position < current_played) {
-                int sync_read = audio_decoder_read(vis_decoder, sync_buffer, SAMPLES_PER_FRAME);
-                if (sync_read > 0) {
-                    vis_decoder_position += sync_read;
-                    samples_to_sync = current_played - vis_decoder_position;
-                } else {
-                    break;
-                }
-            }
-            free(sync_buffer);
+        // O texto do HUD muda poucas vezes por segundo (ordenar as janelas custa)
+        if (show_hud && frame_clock_now_ns() - hud_updated >= HUD_REFRESH_NS) {
+            uint64_t allocations = steady_allocations +
+                (warmup == 0 ? mem_get_heap_allocations() - steady_base : 0);
+            perf_stats_format_hud(stats, hud_text, sizeof(hud_text));
+            size_t used = strlen(hud_text);
+            snprintf(hud_text + used, sizeof(hud_text) - used, "quality %d/%d  heap allocs %llu\n",
+                     quality_governor_get_level(governor), QUALITY_LEVELS - 1,
+                     (unsigned long long)allocations);
+            hud_updated = frame_clock_now_ns();
         }
         
-        // Lê samples do decoder de visualização (sincronizado com áudio)
-        int samples_read = audio_decoder_read(vis_decoder, audio_buffer, SAMPLES_PER_FRAME);
+        // Instantes relativos ao início da sessão (os mesmos no replay do trace)
+        uint64_t frame_start = frame_clock_now_ns();
+        uint64_t now = frame_start - startup_ns;
+        draw_analysis_frame(vis, &active, frame, fresh, now, stats, show_hud ? hud_text : NULL);
+        double frame_ms = (frame_clock_now_ns() - frame_start) / 1000000.0;
         
-        if (samples_read == 0) {
-            // Fim do áudio, reinicia ambos decoders
-            audio_decoder_rewind(decoder);
-            audio_decoder_rewind(vis_decoder);
-            vis_decoder_position = 0;
-            fft_circular_pos = 0;
-            fft_buffer_ready = false;
-            continue;
+        // Trace: o que entrou no quadro, com a qualidade em vigor no desenho
+        if (trace_writer) {
+            const QualitySettings* quality = quality_governor_get_settings(governor);
+            FrameTraceEntry entry;
+            memset(&entry, 0, sizeof(entry));
+            entry.time_ns = now;
+            entry.played = played;
+            entry.fresh = fresh;
+            entry.particle_capacity = visualizer_get_particle_capacity(vis);
+            entry.line_scale = quality->line_scale;
+            entry.waveform_step = quality->waveform_step;
+            entry.bars = active.bars;
+            if (!frame_trace_writer_add(trace_writer, &entry, frame)) {
+                fprintf(stderr, "Erro ao gravar trace: %s\n", opts->trace_record_path);
+                frame_trace_writer_close(trace_writer);
+                trace_writer = NULL;
+            }
         }
         
-        // Atualiza posição do decoder de visualização
-        vis_decoder_position += samples_read;
-        
-        // Acumula samples no buffer circular para FFT
-        for (int i = 0; i < samples_read; i++) {
-            fft_circular[fft_circular_pos] = audio_buffer[i];
-            fft_circular_pos = (fft_circular_pos + 1) % FFT_WINDOW_SIZE;
-            
-            if (fft_circular_pos == 0) {
-                fft_buffer_ready = true;
-            }
+        // Tempo até o primeiro quadro com áudio (visível a cada troca de faixa)
+        if (frame && !first_frame_shown) {
+            printf("Primeiro quadro em %.0f ms\n", (frame_clock_now_ns() - startup_ns) / 1e6);
+            first_frame_shown = true;
         }
         
-        // Analisa frequências quando temos uma janela completa
-        double dominant_freq = 0.0;
-        if (fft_buffer_ready || fft_circular_pos >= FFT_WINDOW_SIZE) {
-            // Copia buffer circular para análise (últimos FFT_WINDOW_SIZE samples)
-            for (int i = 0; i < FFT_WINDOW_SIZE; i++) {
-                int idx = (fft_circular_pos + i) % FFT_WINDOW_SIZE;
-                fft_buffer[i] = fft_circular[idx];
-            }
-            
-            dominant_freq = fft_analyzer_analyze(fft, fft_buffer, frequencies);
+        // Ajusta a qualidade pelo tempo de trabalho e pelos descartes anteriores
+        if (quality_governor_update(governor, frame_ms, dropped)) {
+            int level = quality_governor_get_level(governor);
+            apply_quality_level(vis, pipeline, quality_governor_get_settings(governor),
+                                opts, &active, base_particles);
+            printf("Qualidade ajustada para o nível %d\n", level);
             
-            // Calcula energias das bandas
-            double low_energy = fft_analyzer_get_band_energy(fft, frequencies, 20.0, 200.0);
-            double mid_energy = fft_analyzer_get_band_energy(fft, frequencies, 200.0, 2000.0);
-            double high_energy = fft_analyzer_get_band_energy(fft, frequencies, 2000.0, 20000.0);
-            
-            // Gera cores para cada sample baseado na frequência dominante
-            RGBColor base_color = color_mapper_frequency_to_rgb(dominant_freq);
-            
-            // Varia a cor baseada nas bandas para criar efeito mais interessante
-            for (int i = 0; i < samples_read; i++) {
-                // Modula a cor baseada na amplitude do sample
-                double amplitude = fabs((double)audio_buffer[i] / 32768.0);
-                
-                // Mistura cor baseada em frequência com cor baseada em bandas
-                RGBColor band_color = color_mapper_bands_to_rgb(low_energy, mid_energy, high_energy);
-                
-                colors[i].r = (uint8_t)(base_color.r * 0.7 + band_color.r * 0.3 * amplitude);
-                colors[i].g = (uint8_t)(base_color.g * 0.7 + band_color.g * 0.3 * amplitude);
-                colors[i].b = (uint8_t)(base_color.b * 0.7 + band_color.b * 0.3 * amplitude);
-            }
-        } else {
-            // Ainda não temos janela completa, usa cor padrão
-            RGBColor default_color = {128, 128, 255};
-            for (int i = 0; i < samples_read; i++) {
-                colors[i] = default_color;
+            if (warmup == 0) {
+                steady_allocations += mem_get_heap_allocations() - steady_base;
             }
+            warmup = WARMUP_FRAMES;
         }
         
-        // Limpa tela
-        visualizer_clear(vis);
+        if (warmup > 0 && --warmup == 0) {
+            steady_base = mem_get_heap_allocations();
+        }
         
-        // Desenha múltiplas camadas de visualização
-        if (fft_buffer_ready || fft_circular_pos >= FFT_WINDOW_SIZE) {
-            // 1. Waveform fluida/ambient
-            visualizer_draw_fluid_waveform(vis, audio_buffer, samples_read, frequencies, colors);
-            
-            // 2. Partículas
-            visualizer_update_particles(vis, frequencies, FFT_WINDOW_SIZE / 2 + 1);
+        // Dorme até o próximo prazo; prazos perdidos são descartados, não recuperados
+        dropped = frame_scheduler_wait(scheduler);
+        if (dropped > 0) {
+            perf_stats_count(stats, PERF_COUNTER_DROPPED, dropped);
+        }
+    }
+    
+    if (frame_scheduler_get_dropped(scheduler) > 0) {
+        printf("Quadros descartados: %llu\n", (unsigned long long)frame_scheduler_get_dropped(scheduler));
+    }
+    if (warmup == 0) {
+        steady_allocations += mem_get_heap_allocations() - steady_base;
+    }
+    printf("Alocações no heap em regime: %llu\n", (unsigned long long)steady_allocations);
+    
+    int status = 0;
+    if (probe && !latency_probe_report(probe, stats, LATENCY_CSV_PATH)) {
+        status = 1;
+    }
+    if (trace_writer) {
+        if (frame_trace_writer_close(trace_writer)) {
+            printf("Trace gravado em %s\n", opts->trace_record_path);
         } else {
-            // Fallback: waveform simples enquanto carrega
-            visualizer_draw_waveform_scroll(vis, audio_buffer, samples_read, colors);
+            fprintf(stderr, "Erro ao gravar trace: %s\n", opts->trace_record_path);
+            status = 1;
         }
-        
-        // Atualiza tela
-        visualizer_present(vis);
     }
     
-    // Limpeza
+    // Limpeza (encerra as threads antes de liberar os componentes)
     printf("Encerrando...\n");
-    free(fft_circular);
-    free(colors);
-    free(frequencies);
-    free(fft_buffer);
-    free(audio_buffer);
+    quality_governor_free(governor);
+    frame_scheduler_free(scheduler);
+    audio_pipeline_free(pipeline);
+    frame_publisher_free(publisher);
+    perf_stats_free(stats);
     visualizer_free(vis);
-    fft_analyzer_free(fft);
+    track_cache_free(track_cache);
+    audio_analyzer_free(analyzer);
     audio_player_free(player);
     audio_decoder_free(vis_decoder);
     audio_decoder_free(decoder);
     
-    return 0;
+    return status;
+}
+
+// Cria um arquivo vazio e exclusivo para a faixa de cliques em $TMPDIR (ou
+// /tmp), sem sobrescrever nada do usuário; o FFmpeg detecta o WAV pelo conteúdo
+// path: recebe o caminho criado
+static bool create_latency_track(char* path, size_t size) {
+    const char* dir = getenv("TMPDIR");
+    if (!dir || dir[0] == '\0') dir = "/tmp";
+    
+    int length = snprintf(path, size, "%s/%s", dir, LATENCY_TRACK_TEMPLATE);
+    if (length < 0 || (size_t)length >= size) {
+        return false;
+    }
+    
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        fprintf(stderr, "Erro ao criar faixa de cliques em %s\n", dir);
+        return false;
+    }
+    close(fd);
+    return true;
+}
+
+// Mede a sincronia A/V com uma faixa de cliques gerada (--latency-test)
+static int run_latency_test(const AppOptions* opts) {
+    // Sem placa de som: o driver dummy consome a fila em tempo real
+    // (SDL_AUDIODRIVER=disk, definido antes, também serve)
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+    
+    int fps = opts->fps > 0 ? opts->fps : TARGET_FPS;
+    LatencyProbe* probe = latency_probe_init(LATENCY_SAMPLE_RATE, opts->latency_seconds,
+                                             (int)((opts->latency_seconds + 5.0) * fps));
+    char track_path[4096];
+    bool created = probe && create_latency_track(track_path, sizeof(track_path));
+    if (!created || !latency_probe_write_track(probe, track_path)) {
+        fprintf(stderr, "Erro ao preparar o teste de latência\n");
+        if (created) remove(track_path);
+        latency_probe_free(probe);
+        return 1;
+    }
+    
+    AppOptions session = *opts;
+    session.audio_file = track_path;
+    session.export_path = NULL;
+    session.vsync = false;
+    int status = run_session(&session, probe);
+    
+    remove(track_path);
+    latency_probe_free(probe);
+    return status;
+}
+
+// Opções da sessão gravada num trace (--threads continua valendo no replay)
+static void options_from_trace_config(const FrameTraceConfig* config, const AppOptions* opts,
+                                      AppOptions* session) {
+    memset(session, 0, sizeof(*session));
+    session->render_threads = opts->render_threads;
+    session->particle_seed = config->particle_seed;
+    session->particles = config->particles;
+    session->particle_blend = (VisualizerBlend)config->particle_blend;
+    session->bars = config->bars;
+    session->bar_scale = (BarScale)config->bar_scale;
+    session->spectrogram = config->spectrogram;
+    session->trails = config->trails;
+    session->glow = config->glow;
+    session->force_software = config->software;
+    session->history_seconds = config->history_seconds;
+    for (int layer = 0; layer < VISUALIZER_LAYER_COUNT; layer++) {
+        session->layer_rates[layer] = config->layer_rates[layer];
+    }
+}
+
+// FNV-1a dos pixels: o mesmo trace tem que dar sempre o mesmo quadro final
+static uint64_t hash_pixels(const uint32_t* pixels, size_t count) {
+    uint64_t h = 1469598103934665603ULL;
+    const unsigned char* bytes = (const unsigned char*)pixels;
+    for (size_t i = 0; i < count * sizeof(uint32_t); i++) {
+        h = (h ^ bytes[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+// Repete um trace gravado (--trace-replay): as mesmas chamadas ao
+// visualizador, com os instantes gravados, sem áudio, janela nem espera
+// entre quadros; as etapas do desenho são medidas como na sessão ao vivo
+static int run_trace_replay(const AppOptions* opts) {
+    FrameTrace* trace = frame_trace_open(opts->trace_replay_path);
+    if (!trace) {
+        fprintf(stderr, "Erro ao abrir trace: %s\n", opts->trace_replay_path);
+        return 1;
+    }
+    
+    const FrameTraceConfig* config = frame_trace_get_config(trace);
+    if (config->fft_size != FFT_WINDOW_SIZE) {
+        fprintf(stderr, "Trace gravado com janela FFT %d (esperado %d)\n", config->fft_size, FFT_WINDOW_SIZE);
+        frame_trace_free(trace);
+        return 1;
+    }
+    
+    AppOptions session;
+    options_from_trace_config(config, opts, &session);
+    
+    // Framebuffer em CPU: o resultado não depende da GPU nem do vsync
+    Visualizer* vis = visualizer_init_headless(config->width, config->height);
+    AudioAnalyzer* analyzer = audio_analyzer_init(config->sample_rate, config->fft_size, COLOR_MAPPER_DEFAULT_RESOLUTION);
+    AnalysisFrame* frame = mem_calloc(1, sizeof(AnalysisFrame));
+    PerfStats* stats = perf_stats_init();
+    if (!vis || !analyzer || !frame || !stats) {
+        fprintf(stderr, "Erro ao preparar replay do trace\n");
+        perf_stats_free(stats);
+        if (frame) mem_free(frame);
+        audio_analyzer_free(analyzer);
+        visualizer_free(vis);
+        frame_trace_free(trace);
+        return 1;
+    }
+    apply_visualizer_options(vis, &session, config->sample_rate);
+    
+    // Qualidade em vigor: mudanças do governador são refeitas no mesmo quadro
+    int particles = visualizer_get_particle_capacity(vis);
+    float line_scale = 1.0f;
+    int waveform_step = 1;
+    
+    fprintf(stderr, "Repetindo trace %s (%dx%d)...\n", opts->trace_replay_path, config->width, config->height);
+    
+    FrameTraceEntry entry;
+    uint64_t frames = 0;
+    uint64_t start = frame_clock_now_ns();
+    
+    while (frame_trace_next(trace, &entry, frame)) {
+        if (entry.particle_capacity > 0 && entry.particle_capacity != particles) {
+            visualizer_set_particle_capacity(vis, entry.particle_capacity);
+            particles = entry.particle_capacity;
+        }
+        if (entry.line_scale != line_scale || entry.waveform_step != waveform_step) {
+            visualizer_set_waveform_detail(vis, entry.line_scale, entry.waveform_step);
+            line_scale = entry.line_scale;
+            waveform_step = entry.waveform_step;
+        }
+        session.bars = entry.bars;
+        
+        // Cores refeitas só quando o quadro de análise muda (trabalho da
+        // thread de análise na sessão, fora das etapas do desenho)
+        if (entry.new_analysis) {
+            audio_analyzer_fill_colors(analyzer, frame);
+        }
+        if (entry.has_frame) {
+            int64_t offset = (int64_t)frame->position - (int64_t)entry.played;
+            perf_stats_set_av_offset(stats, offset * 1000.0 / config->sample_rate);
+        }
+        
+        draw_analysis_frame(vis, &session, entry.has_frame ? frame : NULL, entry.fresh, entry.time_ns, stats, NULL);
+        frames++;
+    }
+    
+    double elapsed = (frame_clock_now_ns() - start) / 1e9;
+    printf("Trace repetido: %llu quadros em %.2f s (%.0f quadros/s)\n",
+           (unsigned long long)frames, elapsed, elapsed > 0.0 ? frames / elapsed : 0.0);
+    
+    // Etapas do desenho (as da análise não rodam no replay)
+    for (int stage = PERF_STAGE_SPECTROGRAM; stage <= PERF_STAGE_FRAME; stage++) {
+        PerfSummary summary;
+        perf_stats_summary(stats, (PerfStage)stage, &summary);
+        if (summary.count > 0) {
+            printf("  %-12s p50 %8.1f us  p99 %8.1f us  max %8.1f us\n",
+                   perf_stats_stage_name((PerfStage)stage), summary.p50, summary.p99, summary.max);
+        }
+    }
+    
+    const uint32_t* pixels = visualizer_get_pixels(vis);
+    if (pixels) {
+        printf("Hash do último quadro: %016llx\n",
+               (unsigned long long)hash_pixels(pixels, (size_t)config->width * config->height));
+    }
+    
+    int status = frames > 0 ? 0 : 1;
+    if (frames == 0) {
+        fprintf(stderr, "Trace sem quadros: %s\n", opts->trace_replay_path);
+    } else if (perf_stats_write_csv(stats, PERF_CSV_PATH)) {
+        printf("Estatísticas gravadas em %s\n", PERF_CSV_PATH);
+    }
+    
+    perf_stats_free(stats);
+    mem_free(frame);
+    audio_analyzer_free(analyzer);
+    visualizer_free(vis);
+    frame_trace_free(trace);
+    return status;
 }
 
+int main(int argc, char* argv[]) {
+    AppOptions opts;
+    if (!parse_options(argc, argv, &opts)) {
+        return 1;
+    }
+    
+    // Lote: cada thread aloca por faixa, sem arena de sessão
+    if (opts.batch) {
+        return run_batch(&opts);
+    }
+    
+    // Arena da sessão: os buffers de todos os componentes são criados numa
+    // região contígua; depois da inicialização só o heap é usado (e contado)
+    Arena* arena = arena_init(SESSION_ARENA_BYTES);
+    if (!arena) {
+        fprintf(stderr, "Arena da sessão indisponível, usando o heap\n");
+    }
+    mem_set_session_arena(arena);
+    
+    int status;
+    if (opts.trace_replay_path) {
+        status = run_trace_replay(&opts);
+    } else if (opts.latency_seconds > 0.0) {
+        status = run_latency_test(&opts);
+    } else {
+        status = run_session(&opts, NULL);
+    }
+    
+    // Só depois de liberar todos os componentes (os blocos são da arena)
+    arena_free(arena);
+    return status;
+}
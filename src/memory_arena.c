@@ -0,0 +1,184 @@
+#include "memory_arena.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+// Alinhamento de cada bloco (suficiente para SSE2 e qualquer tipo escalar)
+#define ARENA_ALIGN 16
+
+// Cabeçalho antes de cada bloco: tamanho pedido (para mem_realloc)
+#define ARENA_HEADER 16
+
+struct Arena {
+    uint8_t* block;      // Retornado pelo malloc
+    uint8_t* base;       // Início alinhado
+    size_t capacity;
+    atomic_size_t used;
+};
+
+// Arena que recebe as alocações (NULL = heap) e arena cujos blocos o
+// mem_free deve ignorar (continua registrada depois de mem_seal_session)
+static _Atomic(Arena*) session_arena = NULL;
+static _Atomic(Arena*) owner_arena = NULL;
+
+static atomic_uint_fast64_t heap_allocations = 0;
+static atomic_bool full_warned = false;
+
+Arena* arena_init(size_t capacity) {
+    if (capacity == 0) {
+        return NULL;
+    }
+    
+    Arena* arena = malloc(sizeof(Arena));
+    if (!arena) {
+        return NULL;
+    }
+    
+    arena->block = malloc(capacity + ARENA_ALIGN);
+    if (!arena->block) {
+        fprintf(stderr, "Erro ao reservar arena de %zu bytes\n", capacity);
+        free(arena);
+        return NULL;
+    }
+    
+    uintptr_t aligned = ((uintptr_t)arena->block + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1);
+    arena->base = (uint8_t*)aligned;
+    arena->capacity = capacity;
+    atomic_init(&arena->used, 0);
+    return arena;
+}
+
+void arena_free(Arena* arena) {
+    if (!arena) return;
+    
+    // Deixa de ser a arena da sessão
+    Arena* expected = arena;
+    atomic_compare_exchange_strong(&session_arena, &expected, NULL);
+    expected = arena;
+    atomic_compare_exchange_strong(&owner_arena, &expected, NULL);
+    
+    free(arena->block);
+    free(arena);
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    if (!arena) return NULL;
+    
+    size_t total = ARENA_HEADER + ((size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1));
+    if (total < size) return NULL;
+    
+    // Reserva com compare-and-swap: cada thread recebe um trecho exclusivo e
+    // um pedido que não cabe não consome espaço
+    size_t offset = atomic_load(&arena->used);
+    do {
+        if (total > arena->capacity - offset) {
+            return NULL;
+        }
+    } while (!atomic_compare_exchange_weak(&arena->used, &offset, offset + total));
+
+    uint8_t* header = arena->base + offset;
+    memcpy(header, &size, sizeof(size));
+    return header + ARENA_HEADER;
+}
+
+bool arena_owns(const Arena* arena, const void* ptr) {
+    if (!arena || !ptr) return false;
+    const uint8_t* p = ptr;
+    return p >= arena->base && p < arena->base + arena->capacity;
+}
+
+size_t arena_get_used(const Arena* arena) {
+    if (!arena) return 0;
+    return atomic_load((atomic_size_t*)&arena->used);
+}
+
+size_t arena_get_capacity(const Arena* arena) {
+    if (!arena) return 0;
+    return arena->capacity;
+}
+
+// Tamanho pedido de um bloco da arena
+static size_t arena_block_size(const void* ptr) {
+    size_t size;
+    memcpy(&size, (const uint8_t*)ptr - ARENA_HEADER, sizeof(size));
+    return size;
+}
+
+void* mem_alloc(size_t size) {
+    Arena* arena = atomic_load(&session_arena);
+    if (arena) {
+        void* ptr = arena_alloc(arena, size);
+        if (ptr) {
+            return ptr;
+        }
+        if (!atomic_exchange(&full_warned, true)) {
+            fprintf(stderr, "Arena da sessão cheia (%zu bytes), usando o heap\n",
+                    arena_get_capacity(arena));
+        }
+    }
+    
+    atomic_fetch_add_explicit(&heap_allocations, 1, memory_order_relaxed);
+    return malloc(size);
+}
+
+void* mem_calloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    
+    // A arena não vem zerada
+    void* ptr = mem_alloc(count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void* mem_realloc(void* ptr, size_t size) {
+    if (!ptr) {
+        return mem_alloc(size);
+    }
+    
+    // Bloco da arena: não cresce no lugar, copia para um novo
+    if (arena_owns(atomic_load(&owner_arena), ptr)) {
+        size_t old_size = arena_block_size(ptr);
+        if (size <= old_size) {
+            return ptr;
+        }
+        void* grown = mem_alloc(size);
+        if (grown) {
+            memcpy(grown, ptr, old_size);
+        }
+        return grown;
+    }
+    
+    atomic_fetch_add_explicit(&heap_allocations, 1, memory_order_relaxed);
+    return realloc(ptr, size);
+}
+
+void mem_free(void* ptr) {
+    if (!ptr) return;
+    
+    // Blocos da arena voltam todos juntos em arena_free
+    if (arena_owns(atomic_load(&owner_arena), ptr)) {
+        return;
+    }
+    free(ptr);
+}
+
+void mem_set_session_arena(Arena* arena) {
+    atomic_store(&session_arena, arena);
+    if (arena) {
+        atomic_store(&owner_arena, arena);
+        atomic_store(&full_warned, false);
+    }
+}
+
+void mem_seal_session(void) {
+    atomic_store(&session_arena, NULL);
+}
+
+uint64_t mem_get_heap_allocations(void) {
+    return atomic_load_explicit(&heap_allocations, memory_order_relaxed);
+}
@@ -0,0 +1,52 @@
+#ifndef MEMORY_ARENA_H
+#define MEMORY_ARENA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Região contígua com alocação por incremento (sem free individual; tudo
+// é devolvido de uma vez em arena_free). Alocações são seguras entre threads.
+typedef struct Arena Arena;
+
+// Cria uma arena
+// capacity: bytes reservados (páginas não usadas não ocupam memória física)
+Arena* arena_init(size_t capacity);
+
+// Libera a arena e tudo que foi alocado nela
+void arena_free(Arena* arena);
+
+// Aloca size bytes alinhados a 16
+// Retorna: NULL se a arena não tiver espaço
+void* arena_alloc(Arena* arena, size_t size);
+
+// Verifica se ptr foi alocado nesta arena
+bool arena_owns(const Arena* arena, const void* ptr);
+
+// Bytes já alocados / reservados
+size_t arena_get_used(const Arena* arena);
+size_t arena_get_capacity(const Arena* arena);
+
+// ---- Alocação do programa ----
+// Todos os módulos alocam por estas funções (mesma semântica de malloc,
+// calloc, realloc e free). Com uma arena de sessão ativa, os buffers saem
+// dela; fora disso vão para o heap e são contados.
+
+void* mem_alloc(size_t size);
+void* mem_calloc(size_t count, size_t size);
+void* mem_realloc(void* ptr, size_t size);
+void mem_free(void* ptr);
+
+// Passa a alocar os buffers da sessão na arena (chamar antes de criar os
+// componentes); se a arena encher, o restante vai para o heap
+// arena: NULL = volta a alocar no heap
+void mem_set_session_arena(Arena* arena);
+
+// Encerra a fase de inicialização: novas alocações vão para o heap (e são
+// contadas); blocos já alocados na arena continuam válidos até arena_free
+void mem_seal_session(void);
+
+// Retorna o total de alocações feitas no heap (cada realloc no heap conta como uma)
+uint64_t mem_get_heap_allocations(void);
+
+#endif // MEMORY_ARENA_H
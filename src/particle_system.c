@@ -0,0 +1,246 @@
+#include "particle_system.h"
+#include <stdlib.h>
+#include <string.h>
+#include "memory_arena.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Parâmetros da simulação (por quadro)
+#define PARTICLE_GRAVITY 0.2f
+#define PARTICLE_DECAY 0.02f
+#define PARTICLE_BOUNCE -0.8f
+
+struct ParticleSystem {
+    int capacity;
+    int count;
+    
+    // Arrays paralelos (um bloco único, cada array alinhado a 16 bytes)
+    float* block;
+    float* x;
+    float* y;
+    float* vx;
+    float* vy;
+    float* life;
+    float* size;
+    RGBColor* color;
+    
+    uint64_t rng_state;
+};
+
+// Aloca os arrays para 'capacity' partículas num único bloco
+static bool allocate_arrays(ParticleSystem* ps, int capacity) {
+    // Arredonda para múltiplo de 4 para manter cada array alinhado
+    size_t stride = ((size_t)capacity + 3) & ~(size_t)3;
+    float* block = mem_alloc(stride * 6 * sizeof(float));
+    RGBColor* color = mem_alloc((size_t)capacity * sizeof(RGBColor));
+    
+    if (!block || !color) {
+        if (color) mem_free(color);
+        if (block) mem_free(block);
+        return false;
+    }
+    
+    int keep = ps->count < capacity ? ps->count : capacity;
+    float* arrays[6] = {block, block + stride, block + stride * 2,
+                        block + stride * 3, block + stride * 4, block + stride * 5};
+    if (ps->block && keep > 0) {
+        const float* old[6] = {ps->x, ps->y, ps->vx, ps->vy, ps->life, ps->size};
+        for (int a = 0; a < 6; a++) {
+            memcpy(arrays[a], old[a], keep * sizeof(float));
+        }
+        memcpy(color, ps->color, keep * sizeof(RGBColor));
+    }
+    
+    mem_free(ps->block);
+    mem_free(ps->color);
+    ps->block = block;
+    ps->x = arrays[0];
+    ps->y = arrays[1];
+    ps->vx = arrays[2];
+    ps->vy = arrays[3];
+    ps->life = arrays[4];
+    ps->size = arrays[5];
+    ps->color = color;
+    ps->capacity = capacity;
+    ps->count = keep;
+    return true;
+}
+
+ParticleSystem* particle_system_init(int capacity, uint64_t seed) {
+    if (capacity <= 0) {
+        return NULL;
+    }
+    
+    ParticleSystem* ps = mem_calloc(1, sizeof(ParticleSystem));
+    if (!ps) {
+        return NULL;
+    }
+    
+    if (!allocate_arrays(ps, capacity)) {
+        mem_free(ps);
+        return NULL;
+    }
+    
+    particle_system_seed(ps, seed);
+    return ps;
+}
+
+void particle_system_free(ParticleSystem* ps) {
+    if (!ps) return;
+    
+    if (ps->color) {
+        mem_free(ps->color);
+    }
+    if (ps->block) {
+        mem_free(ps->block);
+    }
+    
+    mem_free(ps);
+}
+
+bool particle_system_set_capacity(ParticleSystem* ps, int capacity) {
+    if (!ps || capacity <= 0) return false;
+    if (capacity == ps->capacity) return true;
+    return allocate_arrays(ps, capacity);
+}
+
+int particle_system_get_capacity(const ParticleSystem* ps) {
+    if (!ps) return 0;
+    return ps->capacity;
+}
+
+int particle_system_get_count(const ParticleSystem* ps) {
+    if (!ps) return 0;
+    return ps->count;
+}
+
+void particle_system_seed(ParticleSystem* ps, uint64_t seed) {
+    if (!ps) return;
+    // Garante estado inicial diferente de zero para qualquer semente
+    ps->rng_state = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+}
+
+// PCG32 (XSH RR): sem estado global nem trava, ao contrário de rand()
+uint32_t particle_system_random(ParticleSystem* ps) {
+    uint64_t old = ps->rng_state;
+    ps->rng_state = old * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+float particle_system_random_float(ParticleSystem* ps) {
+    // 24 bits superiores → [0, 1) exato em float
+    return (float)(particle_system_random(ps) >> 8) * (1.0f / 16777216.0f);
+}
+
+bool particle_system_spawn(ParticleSystem* ps, float x, float y, float vx, float vy,
+                           float size, RGBColor color) {
+    if (!ps || ps->count >= ps->capacity) return false;
+    
+    int i = ps->count++;
+    ps->x[i] = x;
+    ps->y[i] = y;
+    ps->vx[i] = vx;
+    ps->vy[i] = vy;
+    ps->life[i] = 1.0f;
+    ps->size[i] = size;
+    ps->color[i] = color;
+    return true;
+}
+
+// Integra as partículas [0, count)
+static void integrate(ParticleSystem* ps, float width, float height) {
+    float max_x = width - 1.0f;
+    float max_y = height - 1.0f;
+    int i = 0;
+    
+#if defined(__SSE2__)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 w = _mm_set1_ps(width);
+    const __m128 h = _mm_set1_ps(height);
+    const __m128 mx = _mm_set1_ps(max_x);
+    const __m128 my = _mm_set1_ps(max_y);
+    const __m128 gravity = _mm_set1_ps(PARTICLE_GRAVITY);
+    const __m128 decay = _mm_set1_ps(PARTICLE_DECAY);
+    const __m128 bounce = _mm_set1_ps(PARTICLE_BOUNCE);
+    
+    for (; i + 4 <= ps->count; i += 4) {
+        __m128 x = _mm_loadu_ps(ps->x + i);
+        __m128 y = _mm_loadu_ps(ps->y + i);
+        __m128 vx = _mm_loadu_ps(ps->vx + i);
+        __m128 vy = _mm_loadu_ps(ps->vy + i);
+        
+        x = _mm_add_ps(x, vx);
+        y = _mm_add_ps(y, vy);
+        vy = _mm_add_ps(vy, gravity);
+        
+        // Rebate nas bordas: inverte e amortece a velocidade onde saiu da tela
+        __m128 out_x = _mm_or_ps(_mm_cmplt_ps(x, zero), _mm_cmpge_ps(x, w));
+        __m128 out_y = _mm_or_ps(_mm_cmplt_ps(y, zero), _mm_cmpge_ps(y, h));
+        vx = _mm_or_ps(_mm_and_ps(out_x, _mm_mul_ps(vx, bounce)), _mm_andnot_ps(out_x, vx));
+        vy = _mm_or_ps(_mm_and_ps(out_y, _mm_mul_ps(vy, bounce)), _mm_andnot_ps(out_y, vy));
+        x = _mm_min_ps(_mm_max_ps(x, zero), mx);
+        y = _mm_min_ps(_mm_max_ps(y, zero), my);
+        
+        _mm_storeu_ps(ps->x + i, x);
+        _mm_storeu_ps(ps->y + i, y);
+        _mm_storeu_ps(ps->vx + i, vx);
+        _mm_storeu_ps(ps->vy + i, vy);
+        _mm_storeu_ps(ps->life + i, _mm_sub_ps(_mm_loadu_ps(ps->life + i), decay));
+    }
+#endif
+    
+    for (; i < ps->count; i++) {
+        ps->x[i] += ps->vx[i];
+        ps->y[i] += ps->vy[i];
+        ps->vy[i] += PARTICLE_GRAVITY;
+        ps->life[i] -= PARTICLE_DECAY;
+        
+        if (ps->x[i] < 0.0f || ps->x[i] >= width) ps->vx[i] *= PARTICLE_BOUNCE;
+        if (ps->y[i] < 0.0f || ps->y[i] >= height) ps->vy[i] *= PARTICLE_BOUNCE;
+        
+        if (ps->x[i] < 0.0f) ps->x[i] = 0.0f;
+        if (ps->x[i] > max_x) ps->x[i] = max_x;
+        if (ps->y[i] < 0.0f) ps->y[i] = 0.0f;
+        if (ps->y[i] > max_y) ps->y[i] = max_y;
+    }
+}
+
+void particle_system_update(ParticleSystem* ps, float width, float height) {
+    if (!ps) return;
+    
+    integrate(ps, width, height);
+    
+    // Remove mortas trocando com a última (ordem não é preservada)
+    int i = 0;
+    while (i < ps->count) {
+        if (ps->life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        int last = --ps->count;
+        ps->x[i] = ps->x[last];
+        ps->y[i] = ps->y[last];
+        ps->vx[i] = ps->vx[last];
+        ps->vy[i] = ps->vy[last];
+        ps->life[i] = ps->life[last];
+        ps->size[i] = ps->size[last];
+        ps->color[i] = ps->color[last];
+    }
+}
+
+ParticleView particle_system_view(const ParticleSystem* ps) {
+    ParticleView view = {0};
+    if (!ps) return view;
+    
+    view.x = ps->x;
+    view.y = ps->y;
+    view.life = ps->life;
+    view.size = ps->size;
+    view.color = ps->color;
+    view.count = ps->count;
+    return view;
+}
@@ -0,0 +1,61 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "color_mapper.h"
+
+// Sistema de partículas em estrutura de arrays (float), com integração
+// vetorizada, remoção por troca com a última e gerador PCG32 próprio
+typedef struct ParticleSystem ParticleSystem;
+
+// Visão somente leitura das partículas vivas (arrays paralelos de count elementos)
+typedef struct {
+    const float* x;
+    const float* y;
+    const float* life;   // 1.0 ao nascer, cai até 0
+    const float* size;
+    const RGBColor* color;
+    int count;
+} ParticleView;
+
+// Inicializa o sistema
+// capacity: número máximo de partículas vivas
+// seed: semente do gerador de números aleatórios
+ParticleSystem* particle_system_init(int capacity, uint64_t seed);
+
+// Libera recursos do sistema
+void particle_system_free(ParticleSystem* ps);
+
+// Altera a capacidade (descarta as partículas excedentes)
+// Retorna: false se não houver memória (mantém a capacidade atual)
+bool particle_system_set_capacity(ParticleSystem* ps, int capacity);
+
+// Retorna a capacidade
+int particle_system_get_capacity(const ParticleSystem* ps);
+
+// Retorna o número de partículas vivas
+int particle_system_get_count(const ParticleSystem* ps);
+
+// Reinicia o gerador de números aleatórios
+void particle_system_seed(ParticleSystem* ps, uint64_t seed);
+
+// Próximo número aleatório de 32 bits
+uint32_t particle_system_random(ParticleSystem* ps);
+
+// Número aleatório uniforme em [0, 1)
+float particle_system_random_float(ParticleSystem* ps);
+
+// Cria uma partícula com vida 1.0
+// Retorna: false se o sistema estiver cheio
+bool particle_system_spawn(ParticleSystem* ps, float x, float y, float vx, float vy,
+                           float size, RGBColor color);
+
+// Avança um quadro: integra posição, aplica gravidade, rebate nas bordas
+// de [0, width) x [0, height), reduz a vida e remove as partículas mortas
+void particle_system_update(ParticleSystem* ps, float width, float height);
+
+// Retorna a visão das partículas vivas (válida até a próxima alteração)
+ParticleView particle_system_view(const ParticleSystem* ps);
+
+#endif // PARTICLE_SYSTEM_H
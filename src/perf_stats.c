@@ -0,0 +1,260 @@
+#include "perf_stats.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "frame_scheduler.h"
+#include "memory_arena.h"
+
+// Medições guardadas por etapa (janela das estatísticas e do trace)
+#define PERF_HISTORY 512
+
+// Thread de cada etapa no trace
+typedef enum {
+    PERF_THREAD_AUDIO = 1,
+    PERF_THREAD_ANALYSIS,
+    PERF_THREAD_RENDER
+} PerfThread;
+
+typedef struct {
+    const char* name;
+    PerfThread thread;
+} PerfStageInfo;
+
+static const PerfStageInfo perf_stage_info[PERF_STAGE_COUNT] = {
+    {"decode", PERF_THREAD_AUDIO},
+    {"resync", PERF_THREAD_ANALYSIS},
+    {"fft", PERF_THREAD_ANALYSIS},
+    {"bands", PERF_THREAD_ANALYSIS},
+    {"colors", PERF_THREAD_ANALYSIS},
+    {"spectrogram", PERF_THREAD_RENDER},
+    {"waveform", PERF_THREAD_RENDER},
+    {"bars", PERF_THREAD_RENDER},
+    {"particles", PERF_THREAD_RENDER},
+    {"present", PERF_THREAD_RENDER},
+    {"frame", PERF_THREAD_RENDER}
+};
+
+static const char* perf_counter_names[PERF_COUNTER_COUNT] = {
+    "underruns",
+    "dropped_frames"
+};
+
+// Buffer circular de uma etapa: o escritor grava o slot e depois publica
+// count; leitores podem ver um slot sendo reescrito (só valores inteiros)
+typedef struct {
+    atomic_uint_fast64_t start[PERF_HISTORY];      // ns desde a criação
+    atomic_uint_fast32_t duration[PERF_HISTORY];   // ns (até ~4 s)
+    atomic_uint_fast64_t count;
+} PerfRing;
+
+struct PerfStats {
+    uint64_t origin_ns;
+    PerfRing rings[PERF_STAGE_COUNT];
+    atomic_uint_fast64_t counters[PERF_COUNTER_COUNT];
+    double av_offset_ms;
+};
+
+PerfStats* perf_stats_init(void) {
+    PerfStats* stats = mem_alloc(sizeof(PerfStats));
+    if (!stats) {
+        return NULL;
+    }
+    
+    for (int s = 0; s < PERF_STAGE_COUNT; s++) {
+        PerfRing* ring = &stats->rings[s];
+        for (int i = 0; i < PERF_HISTORY; i++) {
+            atomic_init(&ring->start[i], 0);
+            atomic_init(&ring->duration[i], 0);
+        }
+        atomic_init(&ring->count, 0);
+    }
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        atomic_init(&stats->counters[c], 0);
+    }
+    stats->av_offset_ms = 0.0;
+    stats->origin_ns = frame_clock_now_ns();
+    return stats;
+}
+
+void perf_stats_free(PerfStats* stats) {
+    if (!stats) return;
+    mem_free(stats);
+}
+
+uint64_t perf_stats_begin(const PerfStats* stats) {
+    if (!stats) return 0;
+    return frame_clock_now_ns();
+}
+
+uint64_t perf_stats_end(PerfStats* stats, PerfStage stage, uint64_t start_ns) {
+    if (!stats || stage < 0 || stage >= PERF_STAGE_COUNT) return 0;
+    
+    uint64_t now = frame_clock_now_ns();
+    uint64_t duration = now - start_ns;
+    if (duration > UINT32_MAX) duration = UINT32_MAX;
+    
+    PerfRing* ring = &stats->rings[stage];
+    uint64_t n = atomic_load_explicit(&ring->count, memory_order_relaxed);
+    int slot = (int)(n % PERF_HISTORY);
+    atomic_store_explicit(&ring->start[slot], start_ns - stats->origin_ns, memory_order_relaxed);
+    atomic_store_explicit(&ring->duration[slot], duration, memory_order_relaxed);
+    atomic_store_explicit(&ring->count, n + 1, memory_order_release);
+    return now;
+}
+
+void perf_stats_count(PerfStats* stats, PerfCounter counter, uint64_t n) {
+    if (!stats || counter < 0 || counter >= PERF_COUNTER_COUNT) return;
+    atomic_fetch_add_explicit(&stats->counters[counter], n, memory_order_relaxed);
+}
+
+void perf_stats_set_av_offset(PerfStats* stats, double offset_ms) {
+    if (!stats) return;
+    stats->av_offset_ms = offset_ms;
+}
+
+// Leitura de contador (atomic_load não aceita ponteiro const antes do C17)
+static uint64_t load_counter(const PerfStats* stats, int counter) {
+    return atomic_load((atomic_uint_fast64_t*)&stats->counters[counter]);
+}
+
+uint64_t perf_stats_get_counter(const PerfStats* stats, PerfCounter counter) {
+    if (!stats || counter < 0 || counter >= PERF_COUNTER_COUNT) return 0;
+    return load_counter(stats, counter);
+}
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+void perf_stats_summary(const PerfStats* stats, PerfStage stage, PerfSummary* summary) {
+    if (!summary) return;
+    memset(summary, 0, sizeof(*summary));
+    if (!stats || stage < 0 || stage >= PERF_STAGE_COUNT) return;
+    
+    PerfRing* ring = (PerfRing*)&stats->rings[stage];
+    uint64_t count = atomic_load_explicit(&ring->count, memory_order_acquire);
+    int n = count < PERF_HISTORY ? (int)count : PERF_HISTORY;
+    summary->count = count;
+    if (n == 0) return;
+    
+    uint32_t values[PERF_HISTORY];
+    for (int i = 0; i < n; i++) {
+        values[i] = (uint32_t)atomic_load_explicit(&ring->duration[i], memory_order_relaxed);
+    }
+    qsort(values, n, sizeof(uint32_t), compare_u32);
+    
+    summary->p50 = values[(n - 1) / 2] / 1000.0;
+    summary->p99 = values[(int)((n - 1) * 0.99 + 0.5)] / 1000.0;
+    summary->max = values[n - 1] / 1000.0;
+}
+
+const char* perf_stats_stage_name(PerfStage stage) {
+    if (stage < 0 || stage >= PERF_STAGE_COUNT) return "?";
+    return perf_stage_info[stage].name;
+}
+
+int perf_stats_format_hud(const PerfStats* stats, char* text, size_t size) {
+    if (!stats || !text || size == 0) return 0;
+    
+    size_t used = 0;
+    int lines = 0;
+    int written = snprintf(text, size, "%-12s %7s %7s %7s\n", "stage ms", "p50", "p99", "max");
+    if (written > 0 && (size_t)written < size) {
+        used = written;
+        lines++;
+    }
+    
+    for (int s = 0; s < PERF_STAGE_COUNT && used < size; s++) {
+        PerfSummary summary;
+        perf_stats_summary(stats, (PerfStage)s, &summary);
+        written = snprintf(text + used, size - used, "%-12s %7.2f %7.2f %7.2f\n",
+                           perf_stage_info[s].name, summary.p50 / 1000.0,
+                           summary.p99 / 1000.0, summary.max / 1000.0);
+        if (written < 0 || (size_t)written >= size - used) break;
+        used += written;
+        lines++;
+    }
+    
+    if (used < size) {
+        written = snprintf(text + used, size - used, "underruns %llu  dropped %llu  av %+.1f ms\n",
+                           (unsigned long long)load_counter(stats, PERF_COUNTER_UNDERRUNS),
+                           (unsigned long long)load_counter(stats, PERF_COUNTER_DROPPED),
+                           stats->av_offset_ms);
+        if (written > 0 && (size_t)written < size - used) lines++;
+    }
+    
+    return lines;
+}
+
+bool perf_stats_write_csv(const PerfStats* stats, const char* path) {
+    if (!stats || !path) return false;
+    
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Erro ao criar arquivo de estatísticas: %s\n", path);
+        return false;
+    }
+    
+    fprintf(file, "stage,count,p50_us,p99_us,max_us\n");
+    for (int s = 0; s < PERF_STAGE_COUNT; s++) {
+        PerfSummary summary;
+        perf_stats_summary(stats, (PerfStage)s, &summary);
+        fprintf(file, "%s,%llu,%.1f,%.1f,%.1f\n", perf_stage_info[s].name,
+                (unsigned long long)summary.count, summary.p50, summary.p99, summary.max);
+    }
+    
+    fprintf(file, "\ncounter,value\n");
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        fprintf(file, "%s,%llu\n", perf_counter_names[c],
+                (unsigned long long)load_counter(stats, c));
+    }
+    fprintf(file, "av_offset_ms,%.1f\n", stats->av_offset_ms);
+    
+    return fclose(file) == 0;
+}
+
+bool perf_stats_write_trace(const PerfStats* stats, const char* path) {
+    if (!stats || !path) return false;
+    
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Erro ao criar arquivo de trace: %s\n", path);
+        return false;
+    }
+    
+    // Nomes das threads
+    static const char* thread_names[] = {"", "audio", "analysis", "render"};
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (int t = PERF_THREAD_AUDIO; t <= PERF_THREAD_RENDER; t++) {
+        fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                "\"args\":{\"name\":\"%s\"}},\n", t, thread_names[t]);
+    }
+    
+    // Medições recentes de cada etapa como eventos completos (ph X), em µs
+    for (int s = 0; s < PERF_STAGE_COUNT; s++) {
+        PerfRing* ring = (PerfRing*)&stats->rings[s];
+        uint64_t count = atomic_load_explicit(&ring->count, memory_order_acquire);
+        uint64_t first = count > PERF_HISTORY ? count - PERF_HISTORY : 0;
+        for (uint64_t i = first; i < count; i++) {
+            int slot = (int)(i % PERF_HISTORY);
+            uint64_t start = atomic_load_explicit(&ring->start[slot], memory_order_relaxed);
+            uint32_t duration = (uint32_t)atomic_load_explicit(&ring->duration[slot], memory_order_relaxed);
+            fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f},\n",
+                    perf_stage_info[s].name, perf_stage_info[s].thread, start / 1000.0, duration / 1000.0);
+        }
+    }
+    
+    // Contadores no instante da gravação
+    double now_us = (frame_clock_now_ns() - stats->origin_ns) / 1000.0;
+    fprintf(file, "{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{", now_us);
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        fprintf(file, "\"%s\":%llu,", perf_counter_names[c],
+                (unsigned long long)load_counter(stats, c));
+    }
+    fprintf(file, "\"av_offset_ms\":%.1f}}\n]}\n", stats->av_offset_ms);
+    
+    return fclose(file) == 0;
+}
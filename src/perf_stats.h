@@ -0,0 +1,86 @@
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Etapas medidas (cada etapa é medida sempre pela mesma thread)
+typedef enum {
+    PERF_STAGE_DECODE,        // Leitura do decodificador para a fila (thread de áudio)
+    PERF_STAGE_RESYNC,        // Descarte de blocos para alcançar o áudio (thread de análise)
+    PERF_STAGE_FFT,           // Janela + FFT (thread de análise)
+    PERF_STAGE_BANDS,         // Energias por banda (thread de análise)
+    PERF_STAGE_COLORS,        // Cores por sample (thread de análise)
+    PERF_STAGE_SPECTROGRAM,   // Camadas do visualizador (thread de renderização)
+    PERF_STAGE_WAVEFORM,
+    PERF_STAGE_BARS,
+    PERF_STAGE_PARTICLES,
+    PERF_STAGE_PRESENT,       // Rasterização/upload e present
+    PERF_STAGE_FRAME,         // Quadro inteiro, do início do desenho ao fim do present
+    PERF_STAGE_COUNT
+} PerfStage;
+
+// Contadores de eventos
+typedef enum {
+    PERF_COUNTER_UNDERRUNS,   // Fila de áudio esvaziou durante a reprodução
+    PERF_COUNTER_DROPPED,     // Quadros descartados pelo agendador
+    PERF_COUNTER_COUNT
+} PerfCounter;
+
+// Resumo da janela recente de uma etapa (microssegundos)
+typedef struct {
+    uint64_t count;   // Medições desde o início
+    double p50;
+    double p99;
+    double max;
+} PerfSummary;
+
+// Instrumentação por etapa: cada medição vai para um buffer circular da
+// etapa (sem travas; um escritor por etapa), de onde saem p50/p99/máximo,
+// o HUD e os arquivos CSV / Chrome trace.
+typedef struct PerfStats PerfStats;
+
+// Inicializa a instrumentação (tempos relativos ao instante da criação)
+PerfStats* perf_stats_init(void);
+
+// Libera recursos da instrumentação
+void perf_stats_free(PerfStats* stats);
+
+// Início de uma medição
+// Retorna: instante atual em ns (0 se stats for NULL: medição desligada)
+uint64_t perf_stats_begin(const PerfStats* stats);
+
+// Registra a etapa de start_ns (de perf_stats_begin) até agora
+// Retorna: instante atual, para encadear a próxima etapa
+uint64_t perf_stats_end(PerfStats* stats, PerfStage stage, uint64_t start_ns);
+
+// Soma n ao contador
+void perf_stats_count(PerfStats* stats, PerfCounter counter, uint64_t n);
+
+// Retorna o total do contador
+uint64_t perf_stats_get_counter(const PerfStats* stats, PerfCounter counter);
+
+// Atualiza a defasagem entre o quadro exibido e o áudio reproduzido
+// offset_ms: positivo = imagem adiantada em relação ao som
+void perf_stats_set_av_offset(PerfStats* stats, double offset_ms);
+
+// Resume as medições recentes de uma etapa
+void perf_stats_summary(const PerfStats* stats, PerfStage stage, PerfSummary* summary);
+
+// Retorna o nome da etapa
+const char* perf_stats_stage_name(PerfStage stage);
+
+// Escreve o texto do HUD (uma linha por etapa e uma de contadores)
+// Retorna: número de linhas escritas
+int perf_stats_format_hud(const PerfStats* stats, char* text, size_t size);
+
+// Grava o resumo por etapa e os contadores em CSV
+// Retorna: false se o arquivo não pôde ser escrito
+bool perf_stats_write_csv(const PerfStats* stats, const char* path);
+
+// Grava as medições recentes no formato Chrome trace (chrome://tracing, Perfetto)
+// Retorna: false se o arquivo não pôde ser escrito
+bool perf_stats_write_trace(const PerfStats* stats, const char* path);
+
+#endif // PERF_STATS_H
@@ -0,0 +1,136 @@
+#include "quality_governor.h"
+#include <stdlib.h>
+#include "memory_arena.h"
+
+// Suavização da média do tempo de quadro
+#define GOV_EMA_WEIGHT 0.1
+
+// Desce se a média passar de 90% do orçamento por GOV_OVERLOAD_FRAMES quadros
+#define GOV_OVERLOAD_RATIO 0.9
+#define GOV_OVERLOAD_FRAMES 10
+
+// Desce se houver GOV_DROP_LIMIT descartes em GOV_DROP_WINDOW quadros
+#define GOV_DROP_LIMIT 3
+#define GOV_DROP_WINDOW 60
+
+// Sobe se a média ficar abaixo de 60% do orçamento por GOV_CALM_FRAMES quadros
+#define GOV_CALM_RATIO 0.6
+#define GOV_CALM_FRAMES 180
+#define GOV_MAX_CALM_FRAMES (GOV_CALM_FRAMES * 8)
+
+// Quadros ignorados após uma mudança (a medição ainda reflete o nível anterior)
+#define GOV_SETTLE_FRAMES 30
+
+static const QualitySettings quality_levels[QUALITY_LEVELS] = {
+    {1.00f, 1.0f, 1, 1.00f, 1},
+    {0.60f, 1.0f, 1, 1.00f, 1},
+    {0.35f, 0.6f, 2, 0.50f, 1},
+    {0.15f, 0.4f, 2, 0.50f, 2},
+    {0.05f, 0.3f, 4, 0.25f, 4}
+};
+
+struct QualityGovernor {
+    double budget_ms;
+    bool vsync;
+    int level;
+    
+    double average_ms;
+    int overload_frames;
+    int calm_frames;
+    int calm_required;    // Cresce se uma subida é desfeita logo em seguida
+    int settle_frames;
+    int drops;            // Descartes na janela atual
+    int drop_window;      // Quadros restantes da janela de descartes
+    int since_upgrade;    // Quadros desde a última subida
+};
+
+QualityGovernor* quality_governor_init(double budget_ms, bool vsync) {
+    if (budget_ms <= 0.0) {
+        return NULL;
+    }
+    
+    QualityGovernor* gov = mem_calloc(1, sizeof(QualityGovernor));
+    if (!gov) {
+        return NULL;
+    }
+    
+    gov->budget_ms = budget_ms;
+    gov->vsync = vsync;
+    gov->average_ms = budget_ms * GOV_CALM_RATIO;
+    gov->calm_required = GOV_CALM_FRAMES;
+    gov->drop_window = GOV_DROP_WINDOW;
+    gov->since_upgrade = GOV_MAX_CALM_FRAMES;
+    return gov;
+}
+
+void quality_governor_free(QualityGovernor* gov) {
+    if (!gov) return;
+    mem_free(gov);
+}
+
+static void change_level(QualityGovernor* gov, int level) {
+    gov->level = level;
+    gov->overload_frames = 0;
+    gov->calm_frames = 0;
+    gov->drops = 0;
+    gov->drop_window = GOV_DROP_WINDOW;
+    gov->settle_frames = GOV_SETTLE_FRAMES;
+}
+
+bool quality_governor_update(QualityGovernor* gov, double frame_ms, int dropped) {
+    if (!gov) return false;
+    
+    gov->average_ms += (frame_ms - gov->average_ms) * GOV_EMA_WEIGHT;
+    if (gov->since_upgrade < GOV_MAX_CALM_FRAMES) gov->since_upgrade++;
+    
+    if (gov->settle_frames > 0) {
+        gov->settle_frames--;
+        return false;
+    }
+    
+    // Descartes contados numa janela fixa de quadros
+    gov->drops += dropped;
+    if (--gov->drop_window <= 0) {
+        gov->drops = 0;
+        gov->drop_window = GOV_DROP_WINDOW;
+    }
+    
+    // Com vsync o tempo medido inclui a espera do monitor: só descartes contam
+    bool overloaded = !gov->vsync && gov->average_ms > gov->budget_ms * GOV_OVERLOAD_RATIO;
+    bool calm = dropped == 0 && (gov->vsync || gov->average_ms < gov->budget_ms * GOV_CALM_RATIO);
+    
+    gov->overload_frames = overloaded ? gov->overload_frames + 1 : 0;
+    gov->calm_frames = calm ? gov->calm_frames + 1 : 0;
+    
+    if ((gov->overload_frames >= GOV_OVERLOAD_FRAMES || gov->drops >= GOV_DROP_LIMIT) &&
+        gov->level < QUALITY_LEVELS - 1) {
+        // Subida desfeita logo depois: exige mais folga para tentar de novo
+        if (gov->since_upgrade < gov->calm_required && gov->calm_required < GOV_MAX_CALM_FRAMES) {
+            gov->calm_required *= 2;
+        }
+        change_level(gov, gov->level + 1);
+        return true;
+    }
+    
+    if (gov->calm_frames >= gov->calm_required && gov->level > 0) {
+        gov->since_upgrade = 0;
+        change_level(gov, gov->level - 1);
+        return true;
+    }
+    
+    // Longo período estável no mesmo nível: volta à folga padrão
+    if (gov->calm_frames >= GOV_MAX_CALM_FRAMES) {
+        gov->calm_required = GOV_CALM_FRAMES;
+    }
+    
+    return false;
+}
+
+int quality_governor_get_level(const QualityGovernor* gov) {
+    if (!gov) return 0;
+    return gov->level;
+}
+
+const QualitySettings* quality_governor_get_settings(const QualityGovernor* gov) {
+    return &quality_levels[gov ? gov->level : 0];
+}
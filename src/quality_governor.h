@@ -0,0 +1,45 @@
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include <stdbool.h>
+
+// Níveis de qualidade (0 = completa)
+#define QUALITY_LEVELS 5
+
+// Parâmetros de um nível, relativos à configuração escolhida pelo usuário
+typedef struct {
+    float particle_scale;    // Fração da capacidade de partículas
+    float line_scale;        // Fração da espessura da waveform fluida
+    int waveform_step;       // Usa 1 a cada N samples na waveform fluida
+    float bar_scale;         // Fração do número de barras
+    int analysis_hop;        // Blocos de áudio por quadro de análise (FFT)
+} QualitySettings;
+
+// Ajusta a qualidade para manter o tempo de quadro dentro do orçamento:
+// desce um nível quando a média recente estoura o orçamento (ou há quadros
+// descartados) e sobe só depois de um período longo com folga (histerese).
+// Após cada mudança espera a medição assentar antes de decidir de novo.
+typedef struct QualityGovernor QualityGovernor;
+
+// Inicializa o governador
+// budget_ms: orçamento de um quadro (ex: 1000 / fps)
+// vsync: o present espera o monitor (o tempo medido inclui a espera e não
+//        indica carga; só quadros descartados reduzem a qualidade)
+QualityGovernor* quality_governor_init(double budget_ms, bool vsync);
+
+// Libera recursos do governador
+void quality_governor_free(QualityGovernor* gov);
+
+// Informa a medição de um quadro
+// frame_ms: tempo de trabalho do quadro (desenho + present)
+// dropped: quadros descartados antes deste
+// Retorna: true se o nível mudou
+bool quality_governor_update(QualityGovernor* gov, double frame_ms, int dropped);
+
+// Retorna o nível atual (0 = qualidade completa)
+int quality_governor_get_level(const QualityGovernor* gov);
+
+// Retorna os parâmetros do nível atual
+const QualitySettings* quality_governor_get_settings(const QualityGovernor* gov);
+
+#endif // QUALITY_GOVERNOR_H
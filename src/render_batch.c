@@ -0,0 +1,401 @@
+#include "render_batch.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <SDL2/SDL.h>
+#include "memory_arena.h"
+
+// SDL_RenderGeometry existe a partir do SDL 2.0.18
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define BATCH_HAVE_GEOMETRY 1
+#else
+#define BATCH_HAVE_GEOMETRY 0
+#endif
+
+// Espessura até a qual a polilinha é desenhada como linha simples no fallback
+#define BATCH_THIN_LINE 1.5f
+
+struct RenderBatch {
+    BatchPoint* points;
+    int num_points;
+    int points_capacity;
+    
+    BatchPolyline* polylines;
+    int num_polylines;
+    int polylines_capacity;
+    
+    BatchRect* rects;
+    int num_rects;
+    int rects_capacity;
+    
+#if BATCH_HAVE_GEOMETRY
+    // Buffers de vértices/índices montados a cada envio
+    SDL_Vertex* vertices;
+    int vertices_capacity;
+    int* indices;
+    int indices_capacity;
+#endif
+    
+    // Buffers do fallback (linhas e retângulos agrupados por cor)
+    SDL_Point* line_points;
+    int line_points_capacity;
+    SDL_Rect* fill_rects;
+    int fill_rects_capacity;
+};
+
+// Garante capacidade para 'needed' elementos (cresce em potências de 2)
+static bool grow_array(void** array, int* capacity, int needed, size_t elem_size) {
+    if (needed <= *capacity) {
+        return true;
+    }
+    
+    int new_capacity = *capacity > 0 ? *capacity : 64;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    
+    void* grown = mem_realloc(*array, (size_t)new_capacity * elem_size);
+    if (!grown) {
+        return false;
+    }
+    
+    *array = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+RenderBatch* render_batch_init(int point_capacity) {
+    RenderBatch* batch = mem_calloc(1, sizeof(RenderBatch));
+    if (!batch) {
+        return NULL;
+    }
+    
+    if (point_capacity < 64) point_capacity = 64;
+    
+    // Pré-aloca o caso comum para evitar realocações no loop
+    bool ok = grow_array((void**)&batch->points, &batch->points_capacity,
+                         point_capacity, sizeof(BatchPoint)) &&
+              grow_array((void**)&batch->polylines, &batch->polylines_capacity,
+                         16, sizeof(BatchPolyline)) &&
+              grow_array((void**)&batch->rects, &batch->rects_capacity,
+                         64, sizeof(BatchRect));
+#if BATCH_HAVE_GEOMETRY
+    ok = ok && grow_array((void**)&batch->vertices, &batch->vertices_capacity,
+                          point_capacity * 2, sizeof(SDL_Vertex)) &&
+               grow_array((void**)&batch->indices, &batch->indices_capacity,
+                          point_capacity * 6, sizeof(int));
+#endif
+    
+    if (!ok) {
+        render_batch_free(batch);
+        return NULL;
+    }
+    
+    return batch;
+}
+
+void render_batch_free(RenderBatch* batch) {
+    if (!batch) return;
+    
+    if (batch->fill_rects) {
+        mem_free(batch->fill_rects);
+    }
+    if (batch->line_points) {
+        mem_free(batch->line_points);
+    }
+#if BATCH_HAVE_GEOMETRY
+    if (batch->indices) {
+        mem_free(batch->indices);
+    }
+    if (batch->vertices) {
+        mem_free(batch->vertices);
+    }
+#endif
+    if (batch->rects) {
+        mem_free(batch->rects);
+    }
+    if (batch->polylines) {
+        mem_free(batch->polylines);
+    }
+    if (batch->points) {
+        mem_free(batch->points);
+    }
+    
+    mem_free(batch);
+}
+
+void render_batch_clear(RenderBatch* batch) {
+    if (!batch) return;
+    batch->num_points = 0;
+    batch->num_polylines = 0;
+    batch->num_rects = 0;
+}
+
+void render_batch_begin_polyline(RenderBatch* batch) {
+    if (!batch) return;
+    
+    if (!grow_array((void**)&batch->polylines, &batch->polylines_capacity,
+                    batch->num_polylines + 1, sizeof(BatchPolyline))) {
+        return;
+    }
+    
+    BatchPolyline* line = &batch->polylines[batch->num_polylines++];
+    line->first = batch->num_points;
+    line->count = 0;
+}
+
+bool render_batch_add_point(RenderBatch* batch, float x, float y, float thickness, RGBColor color) {
+    if (!batch) return false;
+    
+    if (batch->num_polylines == 0) {
+        render_batch_begin_polyline(batch);
+        if (batch->num_polylines == 0) return false;
+    }
+    
+    if (!grow_array((void**)&batch->points, &batch->points_capacity,
+                    batch->num_points + 1, sizeof(BatchPoint))) {
+        return false;
+    }
+    
+    BatchPoint* p = &batch->points[batch->num_points++];
+    p->x = x;
+    p->y = y;
+    p->thickness = thickness;
+    p->color = color;
+    batch->polylines[batch->num_polylines - 1].count++;
+    return true;
+}
+
+bool render_batch_add_rect(RenderBatch* batch, float x, float y, float w, float h, RGBColor color) {
+    if (!batch) return false;
+    
+    if (!grow_array((void**)&batch->rects, &batch->rects_capacity,
+                    batch->num_rects + 1, sizeof(BatchRect))) {
+        return false;
+    }
+    
+    BatchRect* r = &batch->rects[batch->num_rects++];
+    r->x = x;
+    r->y = y;
+    r->w = w;
+    r->h = h;
+    r->color = color;
+    return true;
+}
+
+static bool same_color(RGBColor a, RGBColor b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+#if BATCH_HAVE_GEOMETRY
+static inline void set_vertex(SDL_Vertex* v, float x, float y, RGBColor c) {
+    v->position.x = x;
+    v->position.y = y;
+    v->color.r = c.r;
+    v->color.g = c.g;
+    v->color.b = c.b;
+    v->color.a = 255;
+    v->tex_coord.x = 0.0f;
+    v->tex_coord.y = 0.0f;
+}
+
+// Monta todas as polilinhas (faixas de triângulos) e retângulos num único
+// buffer de vértices/índices e envia com uma chamada SDL_RenderGeometry
+// Retorna: false se o renderer não aceitou a geometria
+static bool submit_geometry(RenderBatch* batch, SDL_Renderer* renderer) {
+    int needed_vertices = batch->num_points * 2 + batch->num_rects * 4;
+    int needed_indices = batch->num_points * 6 + batch->num_rects * 6;
+    
+    if (!grow_array((void**)&batch->vertices, &batch->vertices_capacity,
+                    needed_vertices, sizeof(SDL_Vertex)) ||
+        !grow_array((void**)&batch->indices, &batch->indices_capacity,
+                    needed_indices, sizeof(int))) {
+        return false;
+    }
+    
+    SDL_Vertex* v = batch->vertices;
+    int* idx = batch->indices;
+    int nv = 0;
+    int ni = 0;
+    
+    for (int l = 0; l < batch->num_polylines; l++) {
+        const BatchPolyline* line = &batch->polylines[l];
+        if (line->count < 2) continue;
+        const BatchPoint* p = batch->points + line->first;
+        int base = nv;
+        
+        for (int i = 0; i < line->count; i++) {
+            // Normal na média dos segmentos vizinhos (junta suave, sem miter)
+            const BatchPoint* prev = &p[i > 0 ? i - 1 : i];
+            const BatchPoint* next = &p[i + 1 < line->count ? i + 1 : i];
+            float tx = next->x - prev->x;
+            float ty = next->y - prev->y;
+            float len = sqrtf(tx * tx + ty * ty);
+            if (len < 1e-6f) {
+                tx = 1.0f;
+                ty = 0.0f;
+                len = 1.0f;
+            }
+            float half = p[i].thickness * 0.5f / len;
+            float nx = -ty * half;
+            float ny = tx * half;
+            
+            set_vertex(&v[nv++], p[i].x + nx, p[i].y + ny, p[i].color);
+            set_vertex(&v[nv++], p[i].x - nx, p[i].y - ny, p[i].color);
+        }
+        
+        for (int i = 0; i < line->count - 1; i++) {
+            int a = base + i * 2;
+            idx[ni++] = a;
+            idx[ni++] = a + 1;
+            idx[ni++] = a + 2;
+            idx[ni++] = a + 1;
+            idx[ni++] = a + 3;
+            idx[ni++] = a + 2;
+        }
+    }
+    
+    for (int r = 0; r < batch->num_rects; r++) {
+        const BatchRect* rect = &batch->rects[r];
+        int a = nv;
+        set_vertex(&v[nv++], rect->x, rect->y, rect->color);
+        set_vertex(&v[nv++], rect->x + rect->w, rect->y, rect->color);
+        set_vertex(&v[nv++], rect->x + rect->w, rect->y + rect->h, rect->color);
+        set_vertex(&v[nv++], rect->x, rect->y + rect->h, rect->color);
+        idx[ni++] = a;
+        idx[ni++] = a + 1;
+        idx[ni++] = a + 2;
+        idx[ni++] = a;
+        idx[ni++] = a + 2;
+        idx[ni++] = a + 3;
+    }
+    
+    if (ni == 0) {
+        return true;
+    }
+    return SDL_RenderGeometry(renderer, NULL, v, nv, idx, ni) == 0;
+}
+#endif
+
+// Envia os retângulos acumulados em fill_rects com uma cor
+static void flush_fill_rects(SDL_Renderer* renderer, const SDL_Rect* rects, int count, RGBColor color) {
+    if (count <= 0) return;
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
+    SDL_RenderFillRects(renderer, rects, count);
+}
+
+// Envia a polilinha acumulada em line_points com uma cor
+static void flush_line_points(SDL_Renderer* renderer, const SDL_Point* points, int count, RGBColor color) {
+    if (count <= 1) return;
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
+    SDL_RenderDrawLines(renderer, points, count);
+}
+
+// Fallback sem SDL_RenderGeometry: linhas finas viram SDL_RenderDrawLines e
+// segmentos grossos viram retângulos, ambos agrupados em trechos de mesma cor
+static void submit_fallback(RenderBatch* batch, SDL_Renderer* renderer) {
+    for (int l = 0; l < batch->num_polylines; l++) {
+        const BatchPolyline* line = &batch->polylines[l];
+        if (line->count < 2) continue;
+        const BatchPoint* p = batch->points + line->first;
+        
+        if (!grow_array((void**)&batch->line_points, &batch->line_points_capacity,
+                        line->count, sizeof(SDL_Point)) ||
+            !grow_array((void**)&batch->fill_rects, &batch->fill_rects_capacity,
+                        line->count, sizeof(SDL_Rect))) {
+            return;
+        }
+        
+        int run_points = 0;
+        int run_rects = 0;
+        RGBColor run_color = p[0].color;
+        
+        for (int i = 0; i < line->count - 1; i++) {
+            const BatchPoint* a = &p[i];
+            const BatchPoint* b = &p[i + 1];
+            
+            if (!same_color(a->color, run_color)) {
+                flush_line_points(renderer, batch->line_points, run_points, run_color);
+                flush_fill_rects(renderer, batch->fill_rects, run_rects, run_color);
+                run_points = 0;
+                run_rects = 0;
+                run_color = a->color;
+            }
+            
+            if (a->thickness <= BATCH_THIN_LINE) {
+                if (run_points == 0) {
+                    batch->line_points[run_points++] = (SDL_Point){(int)a->x, (int)a->y};
+                }
+                batch->line_points[run_points++] = (SDL_Point){(int)b->x, (int)b->y};
+            } else {
+                // Segmento grosso interrompe a polilinha: o próximo fino
+                // recomeça em a, sem ligar o último ponto por cima do vão
+                flush_line_points(renderer, batch->line_points, run_points, run_color);
+                run_points = 0;
+                
+                // Retângulo que cobre o segmento com a espessura pedida
+                int half = (int)(a->thickness * 0.5f);
+                int x1 = (int)a->x;
+                int x2 = (int)b->x;
+                int y_min = (int)(a->y < b->y ? a->y : b->y) - half;
+                int y_max = (int)(a->y > b->y ? a->y : b->y) + half;
+                int w = x2 - x1;
+                if (w < 1) w = 1;
+                batch->fill_rects[run_rects++] = (SDL_Rect){x1, y_min, w, y_max - y_min + 1};
+            }
+        }
+        
+        flush_line_points(renderer, batch->line_points, run_points, run_color);
+        flush_fill_rects(renderer, batch->fill_rects, run_rects, run_color);
+    }
+    
+    if (batch->num_rects > 0) {
+        if (!grow_array((void**)&batch->fill_rects, &batch->fill_rects_capacity,
+                        batch->num_rects, sizeof(SDL_Rect))) {
+            return;
+        }
+        
+        int run = 0;
+        RGBColor run_color = batch->rects[0].color;
+        for (int r = 0; r < batch->num_rects; r++) {
+            const BatchRect* rect = &batch->rects[r];
+            if (!same_color(rect->color, run_color)) {
+                flush_fill_rects(renderer, batch->fill_rects, run, run_color);
+                run = 0;
+                run_color = rect->color;
+            }
+            batch->fill_rects[run++] = (SDL_Rect){(int)rect->x, (int)rect->y,
+                                                  (int)rect->w, (int)rect->h};
+        }
+        flush_fill_rects(renderer, batch->fill_rects, run, run_color);
+    }
+}
+
+void render_batch_submit(RenderBatch* batch, SDL_Renderer* renderer) {
+    if (!batch || !renderer) return;
+    
+#if BATCH_HAVE_GEOMETRY
+    if (!submit_geometry(batch, renderer)) {
+        submit_fallback(batch, renderer);
+    }
+#else
+    submit_fallback(batch, renderer);
+#endif
+    
+    render_batch_clear(batch);
+}
+
+const BatchPoint* render_batch_get_points(const RenderBatch* batch, int* count) {
+    if (count) *count = batch ? batch->num_points : 0;
+    return batch ? batch->points : NULL;
+}
+
+const BatchPolyline* render_batch_get_polylines(const RenderBatch* batch, int* count) {
+    if (count) *count = batch ? batch->num_polylines : 0;
+    return batch ? batch->polylines : NULL;
+}
+
+const BatchRect* render_batch_get_rects(const RenderBatch* batch, int* count) {
+    if (count) *count = batch ? batch->num_rects : 0;
+    return batch ? batch->rects : NULL;
+}
@@ -0,0 +1,61 @@
+#ifndef RENDER_BATCH_H
+#define RENDER_BATCH_H
+
+#include <stdbool.h>
+#include "color_mapper.h"
+
+struct SDL_Renderer;
+
+// Ponto de uma polilinha: posição, espessura (px) e cor no vértice
+typedef struct {
+    float x, y;
+    float thickness;
+    RGBColor color;
+} BatchPoint;
+
+// Polilinha: intervalo [first, first + count) do array de pontos
+typedef struct {
+    int first;
+    int count;
+} BatchPolyline;
+
+// Retângulo preenchido de cor sólida
+typedef struct {
+    float x, y, w, h;
+    RGBColor color;
+} BatchRect;
+
+// Acumula as primitivas de uma camada e as envia ao renderer numa única
+// chamada (SDL_RenderGeometry) ou em lotes de linhas/retângulos em SDL antigo
+typedef struct RenderBatch RenderBatch;
+
+// Inicializa um lote com capacidade inicial para point_capacity pontos
+// (os buffers crescem sob demanda)
+RenderBatch* render_batch_init(int point_capacity);
+
+// Libera recursos do lote
+void render_batch_free(RenderBatch* batch);
+
+// Descarta todas as primitivas acumuladas (mantém a memória)
+void render_batch_clear(RenderBatch* batch);
+
+// Inicia uma nova polilinha; os próximos pontos são adicionados a ela
+void render_batch_begin_polyline(RenderBatch* batch);
+
+// Adiciona um ponto à polilinha atual
+// Retorna: false se não houver memória
+bool render_batch_add_point(RenderBatch* batch, float x, float y, float thickness, RGBColor color);
+
+// Adiciona um retângulo preenchido
+// Retorna: false se não houver memória
+bool render_batch_add_rect(RenderBatch* batch, float x, float y, float w, float h, RGBColor color);
+
+// Envia as primitivas ao renderer e limpa o lote
+void render_batch_submit(RenderBatch* batch, struct SDL_Renderer* renderer);
+
+// Acesso somente leitura às primitivas acumuladas (para outros backends)
+const BatchPoint* render_batch_get_points(const RenderBatch* batch, int* count);
+const BatchPolyline* render_batch_get_polylines(const RenderBatch* batch, int* count);
+const BatchRect* render_batch_get_rects(const RenderBatch* batch, int* count);
+
+#endif // RENDER_BATCH_H
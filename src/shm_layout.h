@@ -0,0 +1,74 @@
+#ifndef SHM_LAYOUT_H
+#define SHM_LAYOUT_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Layout da memória compartilhada com os quadros de análise publicados
+// (frame_publisher escreve, client/soundwave_client lê). Só tipos de
+// tamanho fixo: produtor e leitores podem ser compilados separadamente.
+//
+// Um cabeçalho seguido de um anel de SHM_SLOTS quadros. Cada slot tem um
+// seqlock: o produtor torna seq ímpar, escreve o quadro e o torna par de
+// novo; o leitor copia o slot e descarta a cópia se seq mudou no meio.
+// Leitores só mapeiam para leitura e nunca bloqueiam o produtor.
+
+// Nome padrão do objeto (shm_open)
+#define SHM_DEFAULT_NAME "/soundwave"
+
+#define SHM_MAGIC 0x46415753u   // "SWAF"
+#define SHM_VERSION 1
+
+// Quadros guardados no anel (~190 ms a 86 quadros/s)
+#define SHM_SLOTS 16
+
+// Bins do espectro (janela FFT de até 8192 samples)
+#define SHM_MAX_BINS 4097
+
+// Bandas com ataque (mesmos bits de ANALYSIS_ONSET_*)
+#define SHM_ONSET_LOW (1u << 0)
+#define SHM_ONSET_MID (1u << 1)
+#define SHM_ONSET_HIGH (1u << 2)
+
+// Produtor e leitores em processos diferentes: os atômicos precisam ser
+// implementados sem travas (operam direto na memória compartilhada)
+_Static_assert(ATOMIC_INT_LOCK_FREE == 2, "atômicos de 32 bits precisam ser lock-free");
+_Static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "atômicos de 64 bits precisam ser lock-free");
+
+// Um quadro de análise
+typedef struct {
+    uint64_t frame;            // Número do quadro (1, 2, ...; o slot é frame % SHM_SLOTS)
+    uint64_t timestamp_ns;     // CLOCK_MONOTONIC na publicação
+    uint64_t position;         // Posição no arquivo (samples) ao fim do bloco analisado
+    float dominant_freq;       // Hz
+    float low_energy;          // 20-200 Hz
+    float mid_energy;          // 200-2000 Hz
+    float high_energy;         // 2000-20000 Hz
+    uint32_t onsets;           // SHM_ONSET_*
+    uint32_t spectrum_ready;   // 0 até a primeira janela FFT completa
+    uint32_t num_bins;         // Bins válidos em spectrum
+    uint32_t reserved;
+    float spectrum[SHM_MAX_BINS];  // Magnitudes (bin i = i * sample_rate / window_size Hz)
+} ShmFrame;
+
+typedef struct {
+    _Atomic uint32_t seq;      // Par = estável, ímpar = sendo escrito
+    uint32_t reserved;
+    ShmFrame data;
+} ShmSlot;
+
+typedef struct {
+    _Atomic uint32_t magic;    // SHM_MAGIC depois que o cabeçalho está pronto
+    uint32_t version;
+    uint32_t num_slots;
+    uint32_t max_bins;
+    uint32_t slot_size;        // sizeof(ShmSlot) no produtor
+    uint32_t sample_rate;
+    uint32_t window_size;
+    _Atomic uint32_t alive;    // 0 depois que o produtor encerrou
+    _Atomic uint64_t latest;   // Último quadro completo (0 = nenhum)
+    uint64_t reserved[3];      // Completa 64 bytes
+    ShmSlot slots[SHM_SLOTS];
+} ShmHeader;
+
+#endif // SHM_LAYOUT_H
@@ -0,0 +1,694 @@
+#include "soft_rasterizer.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "memory_arena.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+typedef enum {
+    RASTER_CMD_CLEAR,
+    RASTER_CMD_FADE,
+    RASTER_CMD_RECT,
+    RASTER_CMD_LINE,
+    RASTER_CMD_DISC,
+    RASTER_CMD_IMAGE
+} RasterCommandType;
+
+// Comando gravado; x0..x1 / y0..y1 é a caixa envolvente em pixels
+// (intervalo semiaberto), usada para descartar comandos fora da faixa
+typedef struct {
+    RasterCommandType type;
+    SoftBlendMode blend;
+    int x0, y0, x1, y1;
+    float ax, ay, bx, by;   // Pontas do segmento / centro do disco / canto do retângulo
+    float radius;           // Meia espessura ou raio
+    uint32_t color_a;
+    uint32_t color_b;
+    float alpha;            // Opacidade (ou fração mantida no FADE)
+    const uint32_t* image;  // Pixel da imagem em (x0, y0) e largura da linha (IMAGE)
+    int image_stride;
+} RasterCommand;
+
+struct SoftRasterizer {
+    int width;
+    int height;
+    uint32_t* pixels;
+    
+    RasterCommand* commands;
+    int num_commands;
+    int commands_capacity;
+    
+    // Rasterização paralela em faixas horizontais
+    ThreadPool* pool;
+    int band_height;
+    int num_bands;
+    int* bin_offsets;    // Início de cada faixa em bin_indices (num_bands + 1)
+    int* bin_cursor;     // Posição de escrita por faixa durante a distribuição
+    int* bin_indices;    // Índices dos comandos de cada faixa, em ordem
+    int bin_capacity;
+};
+
+// Faixas por thread: mais faixas que threads equilibra faixas de custo desigual
+#define RASTER_BANDS_PER_THREAD 4
+#define RASTER_MIN_BAND_HEIGHT 8
+
+SoftRasterizer* soft_rasterizer_init(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return NULL;
+    }
+    
+    SoftRasterizer* raster = mem_alloc(sizeof(SoftRasterizer));
+    if (!raster) {
+        return NULL;
+    }
+    
+    raster->width = width;
+    raster->height = height;
+    raster->num_commands = 0;
+    raster->commands_capacity = 4096;
+    raster->pool = NULL;
+    raster->band_height = height;
+    raster->num_bands = 1;
+    raster->bin_offsets = NULL;
+    raster->bin_cursor = NULL;
+    raster->bin_indices = NULL;
+    raster->bin_capacity = 0;
+    raster->pixels = mem_calloc((size_t)width * height, sizeof(uint32_t));
+    raster->commands = mem_alloc(raster->commands_capacity * sizeof(RasterCommand));
+    
+    if (!raster->pixels || !raster->commands) {
+        if (raster->commands) mem_free(raster->commands);
+        if (raster->pixels) mem_free(raster->pixels);
+        mem_free(raster);
+        return NULL;
+    }
+    
+    return raster;
+}
+
+void soft_rasterizer_free(SoftRasterizer* raster) {
+    if (!raster) return;
+    
+    if (raster->bin_indices) {
+        mem_free(raster->bin_indices);
+    }
+    if (raster->bin_cursor) {
+        mem_free(raster->bin_cursor);
+    }
+    if (raster->bin_offsets) {
+        mem_free(raster->bin_offsets);
+    }
+    if (raster->commands) {
+        mem_free(raster->commands);
+    }
+    if (raster->pixels) {
+        mem_free(raster->pixels);
+    }
+    
+    mem_free(raster);
+}
+
+// ---- Mistura de pixels ----
+// Os quatro bytes do pixel recebem a mesma operação, então o código não
+// depende da ordem dos canais. a: opacidade em [0, 256].
+
+static inline uint32_t blend_alpha(uint32_t dst, uint32_t src, uint32_t a) {
+    uint32_t rb = ((src & 0x00FF00FFu) * a + (dst & 0x00FF00FFu) * (256 - a)) >> 8;
+    uint32_t ag = (((src >> 8) & 0x00FF00FFu) * a + ((dst >> 8) & 0x00FF00FFu) * (256 - a)) >> 8;
+    return (rb & 0x00FF00FFu) | ((ag & 0x00FF00FFu) << 8);
+}
+
+static inline uint32_t blend_add(uint32_t dst, uint32_t src, uint32_t a) {
+    uint32_t rb = (dst & 0x00FF00FFu) + ((((src & 0x00FF00FFu) * a) >> 8) & 0x00FF00FFu);
+    uint32_t ag = ((dst >> 8) & 0x00FF00FFu) + (((((src >> 8) & 0x00FF00FFu) * a) >> 8) & 0x00FF00FFu);
+    // Satura cada canal em 255
+    uint32_t rb_sat = rb & 0x01000100u;
+    uint32_t ag_sat = ag & 0x01000100u;
+    rb = (rb | (rb_sat - (rb_sat >> 8))) & 0x00FF00FFu;
+    ag = (ag | (ag_sat - (ag_sat >> 8))) & 0x00FF00FFu;
+    return rb | (ag << 8);
+}
+
+static inline void blend_pixel(uint32_t* dst, uint32_t src, uint32_t a, SoftBlendMode blend) {
+    if (a == 0) return;
+    if (blend == SOFT_BLEND_ADD) {
+        *dst = blend_add(*dst, src, a);
+    } else if (a >= 256) {
+        *dst = src;
+    } else {
+        *dst = blend_alpha(*dst, src, a);
+    }
+}
+
+static inline uint32_t alpha_to_fixed(float alpha) {
+    if (alpha <= 0.0f) return 0;
+    if (alpha >= 1.0f) return 256;
+    return (uint32_t)(alpha * 256.0f);
+}
+
+// ---- Preenchimento de spans (SSE2 quando disponível) ----
+
+static void span_fill(uint32_t* row, int count, uint32_t color) {
+    int i = 0;
+#if defined(__SSE2__)
+    __m128i c = _mm_set1_epi32((int32_t)color);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i*)(row + i), c);
+    }
+#endif
+    for (; i < count; i++) {
+        row[i] = color;
+    }
+}
+
+static void span_add(uint32_t* row, int count, uint32_t color, uint32_t a) {
+    // Pré-multiplica a cor pela opacidade e soma com saturação
+    uint32_t scaled = blend_add(0, color, a);
+    int i = 0;
+#if defined(__SSE2__)
+    __m128i c = _mm_set1_epi32((int32_t)scaled);
+    for (; i + 4 <= count; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)(row + i));
+        _mm_storeu_si128((__m128i*)(row + i), _mm_adds_epu8(d, c));
+    }
+#endif
+    for (; i < count; i++) {
+        row[i] = blend_add(row[i], scaled, 256);
+    }
+}
+
+static void span_blend(uint32_t* row, int count, uint32_t color, uint32_t a) {
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32((int32_t)color), zero);
+    __m128i src_a = _mm_mullo_epi16(src, _mm_set1_epi16((int16_t)a));
+    __m128i inv_a = _mm_set1_epi16((int16_t)(256 - a));
+    for (; i + 4 <= count; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)(row + i));
+        __m128i lo = _mm_unpacklo_epi8(d, zero);
+        __m128i hi = _mm_unpackhi_epi8(d, zero);
+        // (src * a + dst * (256 - a)) >> 8, sem sinal em 16 bits
+        lo = _mm_srli_epi16(_mm_add_epi16(src_a, _mm_mullo_epi16(lo, inv_a)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(src_a, _mm_mullo_epi16(hi, inv_a)), 8);
+        _mm_storeu_si128((__m128i*)(row + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < count; i++) {
+        row[i] = blend_alpha(row[i], color, a);
+    }
+}
+
+static void span_scale(uint32_t* row, int count, uint32_t keep) {
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i k = _mm_set1_epi16((int16_t)keep);
+    for (; i + 4 <= count; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)(row + i));
+        __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), k), 8);
+        __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), k), 8);
+        _mm_storeu_si128((__m128i*)(row + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < count; i++) {
+        uint32_t rb = (((row[i] & 0x00FF00FFu) * keep) >> 8) & 0x00FF00FFu;
+        uint32_t ag = ((((row[i] >> 8) & 0x00FF00FFu) * keep) >> 8) & 0x00FF00FFu;
+        row[i] = rb | (ag << 8);
+    }
+}
+
+static void span_apply(uint32_t* row, int count, uint32_t color, uint32_t a, SoftBlendMode blend) {
+    if (count <= 0 || a == 0) return;
+    if (blend == SOFT_BLEND_ADD) {
+        span_add(row, count, color, a);
+    } else if (a >= 256) {
+        span_fill(row, count, color);
+    } else {
+        span_blend(row, count, color, a);
+    }
+}
+
+// ---- Gravação de comandos ----
+
+static RasterCommand* push_command(SoftRasterizer* raster, RasterCommandType type) {
+    if (raster->num_commands >= raster->commands_capacity) {
+        int new_capacity = raster->commands_capacity * 2;
+        RasterCommand* grown = mem_realloc(raster->commands, new_capacity * sizeof(RasterCommand));
+        if (!grown) {
+            return NULL;
+        }
+        raster->commands = grown;
+        raster->commands_capacity = new_capacity;
+    }
+    
+    RasterCommand* cmd = &raster->commands[raster->num_commands++];
+    memset(cmd, 0, sizeof(RasterCommand));
+    cmd->type = type;
+    cmd->x1 = raster->width;
+    cmd->y1 = raster->height;
+    return cmd;
+}
+
+// Limita a caixa envolvente ao framebuffer; descarta o comando se ficar vazia
+static void clip_command_bounds(SoftRasterizer* raster, RasterCommand* cmd,
+                                float min_x, float min_y, float max_x, float max_y) {
+    cmd->x0 = (int)floorf(min_x);
+    cmd->y0 = (int)floorf(min_y);
+    cmd->x1 = (int)ceilf(max_x) + 1;
+    cmd->y1 = (int)ceilf(max_y) + 1;
+    
+    if (cmd->x0 < 0) cmd->x0 = 0;
+    if (cmd->y0 < 0) cmd->y0 = 0;
+    if (cmd->x1 > raster->width) cmd->x1 = raster->width;
+    if (cmd->y1 > raster->height) cmd->y1 = raster->height;
+    
+    if (cmd->x0 >= cmd->x1 || cmd->y0 >= cmd->y1) {
+        raster->num_commands--;
+    }
+}
+
+void soft_rasterizer_clear(SoftRasterizer* raster, RGBColor color) {
+    if (!raster) return;
+    
+    // Um clear torna inúteis os comandos anteriores
+    raster->num_commands = 0;
+    RasterCommand* cmd = push_command(raster, RASTER_CMD_CLEAR);
+    if (!cmd) return;
+    cmd->color_a = COLOR_RGBA32(color.r, color.g, color.b, 255);
+}
+
+void soft_rasterizer_fade(SoftRasterizer* raster, float keep) {
+    if (!raster) return;
+    
+    RasterCommand* cmd = push_command(raster, RASTER_CMD_FADE);
+    if (!cmd) return;
+    cmd->alpha = keep;
+}
+
+void soft_rasterizer_fill_rect(SoftRasterizer* raster, float x, float y, float w, float h,
+                               RGBColor color, float alpha, SoftBlendMode blend) {
+    if (!raster || w <= 0.0f || h <= 0.0f) return;
+    
+    RasterCommand* cmd = push_command(raster, RASTER_CMD_RECT);
+    if (!cmd) return;
+    cmd->blend = blend;
+    cmd->color_a = COLOR_RGBA32(color.r, color.g, color.b, 255);
+    cmd->alpha = alpha;
+    
+    // Retângulos são alinhados a pixels inteiros
+    cmd->x0 = (int)lroundf(x);
+    cmd->y0 = (int)lroundf(y);
+    cmd->x1 = (int)lroundf(x + w);
+    cmd->y1 = (int)lroundf(y + h);
+    if (cmd->x0 < 0) cmd->x0 = 0;
+    if (cmd->y0 < 0) cmd->y0 = 0;
+    if (cmd->x1 > raster->width) cmd->x1 = raster->width;
+    if (cmd->y1 > raster->height) cmd->y1 = raster->height;
+    if (cmd->x0 >= cmd->x1 || cmd->y0 >= cmd->y1) {
+        raster->num_commands--;
+    }
+}
+
+void soft_rasterizer_draw_line(SoftRasterizer* raster, float x1, float y1, float x2, float y2,
+                               float thickness, RGBColor color1, RGBColor color2,
+                               float alpha, SoftBlendMode blend) {
+    if (!raster || thickness <= 0.0f) return;
+    
+    RasterCommand* cmd = push_command(raster, RASTER_CMD_LINE);
+    if (!cmd) return;
+    cmd->blend = blend;
+    cmd->ax = x1;
+    cmd->ay = y1;
+    cmd->bx = x2;
+    cmd->by = y2;
+    cmd->radius = thickness * 0.5f;
+    cmd->color_a = COLOR_RGBA32(color1.r, color1.g, color1.b, 255);
+    cmd->color_b = COLOR_RGBA32(color2.r, color2.g, color2.b, 255);
+    cmd->alpha = alpha;
+    
+    float margin = cmd->radius + 1.0f;
+    clip_command_bounds(raster, cmd,
+                        fminf(x1, x2) - margin, fminf(y1, y2) - margin,
+                        fmaxf(x1, x2) + margin, fmaxf(y1, y2) + margin);
+}
+
+void soft_rasterizer_draw_disc(SoftRasterizer* raster, float x, float y, float radius,
+                               RGBColor color, float alpha, SoftBlendMode blend) {
+    if (!raster || radius <= 0.0f) return;
+    
+    RasterCommand* cmd = push_command(raster, RASTER_CMD_DISC);
+    if (!cmd) return;
+    cmd->blend = blend;
+    cmd->ax = x;
+    cmd->ay = y;
+    cmd->radius = radius;
+    cmd->color_a = COLOR_RGBA32(color.r, color.g, color.b, 255);
+    cmd->alpha = alpha;
+    
+    clip_command_bounds(raster, cmd, x - radius - 1.0f, y - radius - 1.0f,
+                        x + radius + 1.0f, y + radius + 1.0f);
+}
+
+void soft_rasterizer_draw_image(SoftRasterizer* raster, const uint32_t* pixels, int width, int height,
+                                int stride, int x, int y) {
+    if (!raster || !pixels || width <= 0 || height <= 0) return;
+    
+    RasterCommand* cmd = push_command(raster, RASTER_CMD_IMAGE);
+    if (!cmd) return;
+    cmd->x0 = x > 0 ? x : 0;
+    cmd->y0 = y > 0 ? y : 0;
+    cmd->x1 = x + width < raster->width ? x + width : raster->width;
+    cmd->y1 = y + height < raster->height ? y + height : raster->height;
+    if (cmd->x0 >= cmd->x1 || cmd->y0 >= cmd->y1) {
+        raster->num_commands--;
+        return;
+    }
+    
+    // Guarda o ponteiro já deslocado para o canto visível
+    cmd->image = pixels + (size_t)(cmd->y0 - y) * stride + (cmd->x0 - x);
+    cmd->image_stride = stride;
+}
+
+void soft_rasterizer_draw_batch(SoftRasterizer* raster, const RenderBatch* batch,
+                                float thickness_scale, float alpha, SoftBlendMode blend) {
+    if (!raster || !batch) return;
+    
+    int num_points = 0;
+    int num_lines = 0;
+    int num_rects = 0;
+    const BatchPoint* points = render_batch_get_points(batch, &num_points);
+    const BatchPolyline* lines = render_batch_get_polylines(batch, &num_lines);
+    const BatchRect* rects = render_batch_get_rects(batch, &num_rects);
+    
+    for (int l = 0; l < num_lines; l++) {
+        const BatchPoint* p = points + lines[l].first;
+        for (int i = 0; i + 1 < lines[l].count; i++) {
+            float thickness = (p[i].thickness + p[i + 1].thickness) * 0.5f * thickness_scale;
+            soft_rasterizer_draw_line(raster, p[i].x, p[i].y, p[i + 1].x, p[i + 1].y,
+                                      thickness, p[i].color, p[i + 1].color, alpha, blend);
+        }
+    }
+    
+    for (int r = 0; r < num_rects; r++) {
+        soft_rasterizer_fill_rect(raster, rects[r].x, rects[r].y, rects[r].w, rects[r].h,
+                                  rects[r].color, alpha, blend);
+    }
+}
+
+// ---- Execução ----
+
+static inline uint32_t lerp_color(uint32_t a, uint32_t b, float t) {
+    return blend_alpha(a, b, (uint32_t)(t * 256.0f));
+}
+
+// Intervalo [lo, hi] em x de uma linha horizontal (altura py) dentro da
+// cápsula de raio r em torno do segmento AB (a cápsula é convexa)
+static bool capsule_row_span(const RasterCommand* cmd, float py, float r, float* lo, float* hi) {
+    float min_x = INFINITY;
+    float max_x = -INFINITY;
+    float r2 = r * r;
+    
+    // Discos nas pontas
+    float dya = py - cmd->ay;
+    if (dya * dya <= r2) {
+        float w = sqrtf(r2 - dya * dya);
+        min_x = fminf(min_x, cmd->ax - w);
+        max_x = fmaxf(max_x, cmd->ax + w);
+    }
+    float dyb = py - cmd->by;
+    if (dyb * dyb <= r2) {
+        float w = sqrtf(r2 - dyb * dyb);
+        min_x = fminf(min_x, cmd->bx - w);
+        max_x = fmaxf(max_x, cmd->bx + w);
+    }
+    
+    // Faixa ao longo do segmento: 0 <= u <= len e |v| <= r, ambos lineares em x
+    float dx = cmd->bx - cmd->ax;
+    float dy = cmd->by - cmd->ay;
+    float len = sqrtf(dx * dx + dy * dy);
+    if (len > 1e-6f) {
+        dx /= len;
+        dy /= len;
+        float s_lo = -INFINITY;
+        float s_hi = INFINITY;
+        // u(x) = dx * (x - ax) + dy * dya, v(x) = -dy * (x - ax) + dx * dya
+        float coefs[2] = {dx, -dy};
+        float consts[2] = {dy * dya, dx * dya};
+        float lows[2] = {0.0f, -r};
+        float highs[2] = {len, r};
+        bool empty = false;
+        
+        for (int k = 0; k < 2 && !empty; k++) {
+            if (fabsf(coefs[k]) > 1e-6f) {
+                float a = (lows[k] - consts[k]) / coefs[k] + cmd->ax;
+                float b = (highs[k] - consts[k]) / coefs[k] + cmd->ax;
+                s_lo = fmaxf(s_lo, fminf(a, b));
+                s_hi = fminf(s_hi, fmaxf(a, b));
+            } else if (consts[k] < lows[k] || consts[k] > highs[k]) {
+                empty = true;
+            }
+        }
+        
+        if (!empty && s_lo <= s_hi) {
+            min_x = fminf(min_x, s_lo);
+            max_x = fmaxf(max_x, s_hi);
+        }
+    }
+    
+    *lo = min_x;
+    *hi = max_x;
+    return min_x <= max_x;
+}
+
+static void execute_line(SoftRasterizer* raster, const RasterCommand* cmd, int y_begin, int y_end) {
+    float dx = cmd->bx - cmd->ax;
+    float dy = cmd->by - cmd->ay;
+    float len2 = dx * dx + dy * dy;
+    float inv_len2 = len2 > 1e-12f ? 1.0f / len2 : 0.0f;
+    float outer = cmd->radius + 1.0f;
+    float alpha = cmd->alpha;
+    bool solid = cmd->color_a == cmd->color_b;
+    
+    for (int y = y_begin; y < y_end; y++) {
+        float py = (float)y + 0.5f;
+        float lo, hi;
+        if (!capsule_row_span(cmd, py, outer, &lo, &hi)) continue;
+        
+        int x_start = (int)floorf(lo);
+        int x_end = (int)ceilf(hi);
+        if (x_start < cmd->x0) x_start = cmd->x0;
+        if (x_end > cmd->x1) x_end = cmd->x1;
+        
+        uint32_t* row = raster->pixels + (size_t)y * raster->width;
+        for (int x = x_start; x < x_end; x++) {
+            float px = (float)x + 0.5f - cmd->ax;
+            float qy = py - cmd->ay;
+            float t = (px * dx + qy * dy) * inv_len2;
+            if (t < 0.0f) t = 0.0f;
+            if (t > 1.0f) t = 1.0f;
+            float ex = px - t * dx;
+            float ey = qy - t * dy;
+            float dist = sqrtf(ex * ex + ey * ey);
+            
+            // Cobertura antialiased: 1 dentro, rampa de 1 px na borda
+            float coverage = cmd->radius + 0.5f - dist;
+            if (coverage <= 0.0f) continue;
+            if (coverage > 1.0f) coverage = 1.0f;
+            
+            uint32_t color = solid ? cmd->color_a : lerp_color(cmd->color_a, cmd->color_b, t);
+            blend_pixel(&row[x], color, alpha_to_fixed(coverage * alpha), cmd->blend);
+        }
+    }
+}
+
+static void execute_disc(SoftRasterizer* raster, const RasterCommand* cmd, int y_begin, int y_end) {
+    float radius = cmd->radius;
+    
+    // Discos menores que um pixel viram um único pixel
+    if (radius < 0.75f) {
+        int x = (int)floorf(cmd->ax);
+        int y = (int)floorf(cmd->ay);
+        if (y >= y_begin && y < y_end && x >= 0 && x < raster->width) {
+            blend_pixel(&raster->pixels[(size_t)y * raster->width + x], cmd->color_a,
+                        alpha_to_fixed(cmd->alpha), cmd->blend);
+        }
+        return;
+    }
+    
+    float inv_r2 = 1.0f / (radius * radius);
+    for (int y = y_begin; y < y_end; y++) {
+        float dy = (float)y + 0.5f - cmd->ay;
+        if (dy * dy >= radius * radius) continue;
+        
+        uint32_t* row = raster->pixels + (size_t)y * raster->width;
+        for (int x = cmd->x0; x < cmd->x1; x++) {
+            float dx = (float)x + 0.5f - cmd->ax;
+            float d2 = (dx * dx + dy * dy) * inv_r2;
+            if (d2 >= 1.0f) continue;
+            
+            // Queda suave: 1 - (d / r)^2
+            blend_pixel(&row[x], cmd->color_a, alpha_to_fixed((1.0f - d2) * cmd->alpha), cmd->blend);
+        }
+    }
+}
+
+// Executa um comando restrito às linhas [y_begin, y_end)
+static void execute_command(SoftRasterizer* raster, const RasterCommand* cmd, int y_begin, int y_end) {
+    int y0 = cmd->y0 > y_begin ? cmd->y0 : y_begin;
+    int y1 = cmd->y1 < y_end ? cmd->y1 : y_end;
+    if (y0 >= y1) return;
+    
+    switch (cmd->type) {
+        case RASTER_CMD_CLEAR:
+            for (int y = y0; y < y1; y++) {
+                span_fill(raster->pixels + (size_t)y * raster->width, raster->width, cmd->color_a);
+            }
+            break;
+        case RASTER_CMD_FADE: {
+            uint32_t keep = alpha_to_fixed(cmd->alpha);
+            for (int y = y0; y < y1; y++) {
+                span_scale(raster->pixels + (size_t)y * raster->width, raster->width, keep);
+            }
+            break;
+        }
+        case RASTER_CMD_RECT: {
+            uint32_t a = alpha_to_fixed(cmd->alpha);
+            for (int y = y0; y < y1; y++) {
+                uint32_t* row = raster->pixels + (size_t)y * raster->width;
+                span_apply(row + cmd->x0, cmd->x1 - cmd->x0, cmd->color_a, a, cmd->blend);
+            }
+            break;
+        }
+        case RASTER_CMD_LINE:
+            execute_line(raster, cmd, y0, y1);
+            break;
+        case RASTER_CMD_DISC:
+            execute_disc(raster, cmd, y0, y1);
+            break;
+        case RASTER_CMD_IMAGE: {
+            size_t row_bytes = (size_t)(cmd->x1 - cmd->x0) * sizeof(uint32_t);
+            for (int y = y0; y < y1; y++) {
+                memcpy(raster->pixels + (size_t)y * raster->width + cmd->x0,
+                       cmd->image + (size_t)(y - cmd->y0) * cmd->image_stride, row_bytes);
+            }
+            break;
+        }
+    }
+}
+
+// Distribui os comandos nas faixas que eles tocam (ordenação por contagem,
+// preservando a ordem de desenho dentro de cada faixa)
+static bool bin_commands(SoftRasterizer* raster) {
+    int bands = raster->num_bands;
+    int bh = raster->band_height;
+    
+    memset(raster->bin_offsets, 0, (bands + 1) * sizeof(int));
+    int total = 0;
+    for (int c = 0; c < raster->num_commands; c++) {
+        const RasterCommand* cmd = &raster->commands[c];
+        int b1 = (cmd->y1 - 1) / bh;
+        for (int b = cmd->y0 / bh; b <= b1; b++) {
+            raster->bin_offsets[b + 1]++;
+        }
+        total += b1 - cmd->y0 / bh + 1;
+    }
+    
+    if (total > raster->bin_capacity) {
+        int new_capacity = raster->bin_capacity > 0 ? raster->bin_capacity : 4096;
+        while (new_capacity < total) new_capacity *= 2;
+        int* grown = mem_realloc(raster->bin_indices, new_capacity * sizeof(int));
+        if (!grown) {
+            return false;
+        }
+        raster->bin_indices = grown;
+        raster->bin_capacity = new_capacity;
+    }
+    
+    for (int b = 0; b < bands; b++) {
+        raster->bin_offsets[b + 1] += raster->bin_offsets[b];
+        raster->bin_cursor[b] = raster->bin_offsets[b];
+    }
+    
+    for (int c = 0; c < raster->num_commands; c++) {
+        const RasterCommand* cmd = &raster->commands[c];
+        int b1 = (cmd->y1 - 1) / bh;
+        for (int b = cmd->y0 / bh; b <= b1; b++) {
+            raster->bin_indices[raster->bin_cursor[b]++] = c;
+        }
+    }
+    
+    return true;
+}
+
+// Tarefa do pool: rasteriza uma faixa com os comandos distribuídos para ela
+static void rasterize_band(void* arg, int band) {
+    SoftRasterizer* raster = arg;
+    int y_begin = band * raster->band_height;
+    int y_end = y_begin + raster->band_height;
+    if (y_end > raster->height) y_end = raster->height;
+    
+    for (int i = raster->bin_offsets[band]; i < raster->bin_offsets[band + 1]; i++) {
+        execute_command(raster, &raster->commands[raster->bin_indices[i]], y_begin, y_end);
+    }
+}
+
+void soft_rasterizer_set_thread_pool(SoftRasterizer* raster, ThreadPool* pool) {
+    if (!raster) return;
+    
+    int bands = 1;
+    if (pool) {
+        bands = (thread_pool_get_size(pool) + 1) * RASTER_BANDS_PER_THREAD;
+        if (raster->height / bands < RASTER_MIN_BAND_HEIGHT) {
+            bands = raster->height / RASTER_MIN_BAND_HEIGHT;
+        }
+        if (bands < 1) bands = 1;
+    }
+    
+    int* offsets = mem_alloc((bands + 1) * sizeof(int));
+    int* cursor = mem_alloc(bands * sizeof(int));
+    if (!offsets || !cursor) {
+        if (cursor) mem_free(cursor);
+        if (offsets) mem_free(offsets);
+        return;
+    }
+    
+    if (raster->bin_offsets) mem_free(raster->bin_offsets);
+    if (raster->bin_cursor) mem_free(raster->bin_cursor);
+    raster->bin_offsets = offsets;
+    raster->bin_cursor = cursor;
+    raster->pool = pool;
+    raster->band_height = (raster->height + bands - 1) / bands;
+    raster->num_bands = (raster->height + raster->band_height - 1) / raster->band_height;
+}
+
+void soft_rasterizer_flush(SoftRasterizer* raster) {
+    if (!raster) return;
+    
+    if (raster->pool && raster->num_bands > 1 && bin_commands(raster)) {
+        thread_pool_parallel_for(raster->pool, raster->num_bands, rasterize_band, raster);
+    } else {
+        for (int c = 0; c < raster->num_commands; c++) {
+            execute_command(raster, &raster->commands[c], 0, raster->height);
+        }
+    }
+    raster->num_commands = 0;
+}
+
+const uint32_t* soft_rasterizer_get_pixels(const SoftRasterizer* raster) {
+    if (!raster) return NULL;
+    return raster->pixels;
+}
+
+int soft_rasterizer_get_width(const SoftRasterizer* raster) {
+    if (!raster) return 0;
+    return raster->width;
+}
+
+int soft_rasterizer_get_height(const SoftRasterizer* raster) {
+    if (!raster) return 0;
+    return raster->height;
+}
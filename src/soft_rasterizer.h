@@ -0,0 +1,78 @@
+#ifndef SOFT_RASTERIZER_H
+#define SOFT_RASTERIZER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "color_mapper.h"
+#include "render_batch.h"
+#include "thread_pool.h"
+
+// Modos de mistura do rasterizador
+typedef enum {
+    SOFT_BLEND_REPLACE,  // Substitui o destino (bordas antialiased usam ALPHA)
+    SOFT_BLEND_ALPHA,    // dst = dst + (src - dst) * alpha
+    SOFT_BLEND_ADD       // dst = min(255, dst + src * alpha)
+} SoftBlendMode;
+
+// Rasterizador em CPU sobre um framebuffer RGBA32 (SDL_PIXELFORMAT_RGBA32).
+// As chamadas de desenho apenas gravam comandos; soft_rasterizer_flush
+// executa todos eles sobre o framebuffer.
+typedef struct SoftRasterizer SoftRasterizer;
+
+// Inicializa o rasterizador
+// width, height: tamanho do framebuffer em pixels
+SoftRasterizer* soft_rasterizer_init(int width, int height);
+
+// Libera recursos do rasterizador
+void soft_rasterizer_free(SoftRasterizer* raster);
+
+// Preenche o framebuffer inteiro com uma cor
+void soft_rasterizer_clear(SoftRasterizer* raster, RGBColor color);
+
+// Escurece o quadro anterior (rastro): pixel = pixel * keep
+// keep: fração mantida em [0, 1]
+void soft_rasterizer_fade(SoftRasterizer* raster, float keep);
+
+// Preenche um retângulo
+void soft_rasterizer_fill_rect(SoftRasterizer* raster, float x, float y, float w, float h,
+                               RGBColor color, float alpha, SoftBlendMode blend);
+
+// Desenha um segmento grosso com antialiasing e cor interpolada entre as pontas
+void soft_rasterizer_draw_line(SoftRasterizer* raster, float x1, float y1, float x2, float y2,
+                               float thickness, RGBColor color1, RGBColor color2,
+                               float alpha, SoftBlendMode blend);
+
+// Desenha um disco suave (intensidade cai do centro para a borda)
+void soft_rasterizer_draw_disc(SoftRasterizer* raster, float x, float y, float radius,
+                               RGBColor color, float alpha, SoftBlendMode blend);
+
+// Copia uma imagem RGBA32 opaca, sem escala, com o canto em (x, y)
+// stride: pixels entre o início de linhas consecutivas da imagem
+// (a imagem é lida em soft_rasterizer_flush e deve continuar válida até lá)
+void soft_rasterizer_draw_image(SoftRasterizer* raster, const uint32_t* pixels, int width, int height,
+                                int stride, int x, int y);
+
+// Desenha todas as primitivas de um RenderBatch
+// thickness_scale: multiplica a espessura das polilinhas (ex: 3.0 para brilho)
+void soft_rasterizer_draw_batch(SoftRasterizer* raster, const RenderBatch* batch,
+                                float thickness_scale, float alpha, SoftBlendMode blend);
+
+// Divide a rasterização em faixas horizontais executadas em paralelo
+// pool: pool de threads (NULL = rasteriza tudo na thread chamadora)
+void soft_rasterizer_set_thread_pool(SoftRasterizer* raster, ThreadPool* pool);
+
+// Executa os comandos gravados sobre o framebuffer e descarta a lista.
+// Com pool, os comandos são distribuídos uma vez por faixa e cada faixa é
+// rasterizada por uma thread (faixas não se sobrepõem, sem travas).
+void soft_rasterizer_flush(SoftRasterizer* raster);
+
+// Retorna o framebuffer (linhas contíguas de width pixels)
+const uint32_t* soft_rasterizer_get_pixels(const SoftRasterizer* raster);
+
+// Retorna a largura do framebuffer
+int soft_rasterizer_get_width(const SoftRasterizer* raster);
+
+// Retorna a altura do framebuffer
+int soft_rasterizer_get_height(const SoftRasterizer* raster);
+
+#endif // SOFT_RASTERIZER_H
@@ -0,0 +1,169 @@
+#include "spectrogram.h"
+#include "color_mapper.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "memory_arena.h"
+
+// Entradas da tabela de intensidade (dB normalizado → cor)
+#define SPECTROGRAM_PALETTE_SIZE 256
+
+// Coluna da imagem: bins [bin_lo, bin_hi) reduzidos pelo máximo ou, se a
+// coluna for mais estreita que um bin, interpolação em bin_pos
+typedef struct {
+    int bin_lo;
+    int bin_hi;
+    float bin_pos;
+} SpectrogramColumn;
+
+struct Spectrogram {
+    int columns;
+    int rows;
+    int head;
+    uint32_t* pixels;
+    
+    SpectrogramColumn* map;
+    int num_bins;          // Bins esperados (0 = formato ainda não definido)
+    double reference;      // Magnitude de fundo de escala (0 dB)
+    
+    uint32_t palette[SPECTROGRAM_PALETTE_SIZE];
+};
+
+// Escuro → violeta → vermelho → amarelo claro conforme a intensidade
+static void build_palette(uint32_t* palette) {
+    for (int i = 0; i < SPECTROGRAM_PALETTE_SIZE; i++) {
+        double t = (double)i / (SPECTROGRAM_PALETTE_SIZE - 1);
+        double hue = 270.0 - t * 330.0;
+        if (hue < 0.0) hue += 360.0;
+        double saturation = t > 0.8 ? 1.0 - (t - 0.8) * 3.0 : 1.0;
+        RGBColor c = color_mapper_hsv_to_rgb(hue, saturation, pow(t, 0.7));
+        palette[i] = COLOR_RGBA32(c.r, c.g, c.b, 255);
+    }
+}
+
+Spectrogram* spectrogram_init(int columns, int rows) {
+    if (columns <= 0 || rows <= 0) {
+        return NULL;
+    }
+    
+    Spectrogram* sg = mem_calloc(1, sizeof(Spectrogram));
+    if (!sg) {
+        return NULL;
+    }
+    
+    sg->columns = columns;
+    sg->rows = rows;
+    sg->pixels = mem_alloc((size_t)columns * rows * sizeof(uint32_t));
+    sg->map = mem_alloc(columns * sizeof(SpectrogramColumn));
+    if (!sg->pixels || !sg->map) {
+        spectrogram_free(sg);
+        return NULL;
+    }
+    
+    build_palette(sg->palette);
+    spectrogram_clear(sg);
+    return sg;
+}
+
+void spectrogram_free(Spectrogram* sg) {
+    if (!sg) return;
+    
+    if (sg->map) {
+        mem_free(sg->map);
+    }
+    if (sg->pixels) {
+        mem_free(sg->pixels);
+    }
+    mem_free(sg);
+}
+
+bool spectrogram_set_format(Spectrogram* sg, int sample_rate, int fft_size) {
+    if (!sg || sample_rate <= 0 || fft_size < 2) return false;
+    
+    int num_bins = fft_size / 2 + 1;
+    double bin_hz = (double)sample_rate / fft_size;
+    double max_freq = sample_rate / 2.0 < SPECTROGRAM_MAX_FREQ ? sample_rate / 2.0 : SPECTROGRAM_MAX_FREQ;
+    double ratio = max_freq / SPECTROGRAM_MIN_FREQ;
+    
+    for (int c = 0; c < sg->columns; c++) {
+        // Bordas e centro da coluna na escala logarítmica, em bins
+        double lo = SPECTROGRAM_MIN_FREQ * pow(ratio, (double)c / sg->columns) / bin_hz;
+        double hi = SPECTROGRAM_MIN_FREQ * pow(ratio, (double)(c + 1) / sg->columns) / bin_hz;
+        double center = SPECTROGRAM_MIN_FREQ * pow(ratio, (c + 0.5) / sg->columns) / bin_hz;
+        
+        SpectrogramColumn* col = &sg->map[c];
+        col->bin_lo = (int)ceil(lo);
+        col->bin_hi = (int)ceil(hi);
+        if (col->bin_hi > num_bins) col->bin_hi = num_bins;
+        col->bin_pos = (float)(center < num_bins - 1 ? center : num_bins - 1);
+    }
+    
+    // Senoide de fundo de escala com janela de Hann: |X| * 2 = fft_size / 2
+    sg->reference = fft_size / 2.0;
+    sg->num_bins = num_bins;
+    return true;
+}
+
+void spectrogram_clear(Spectrogram* sg) {
+    if (!sg) return;
+    
+    for (size_t i = 0; i < (size_t)sg->columns * sg->rows; i++) {
+        sg->pixels[i] = sg->palette[0];
+    }
+    sg->head = 0;
+}
+
+bool spectrogram_push(Spectrogram* sg, const double* magnitudes, int num_bins) {
+    if (!sg || !magnitudes || sg->num_bins == 0 || num_bins != sg->num_bins) return false;
+    
+    // A linha nova substitui a mais antiga (a anterior à mais recente no anel)
+    sg->head = sg->head > 0 ? sg->head - 1 : sg->rows - 1;
+    uint32_t* row = sg->pixels + (size_t)sg->head * sg->columns;
+    
+    const double scale = (SPECTROGRAM_PALETTE_SIZE - 1) / SPECTROGRAM_RANGE_DB;
+    const double floor_magnitude = sg->reference * pow(10.0, -SPECTROGRAM_RANGE_DB / 20.0);
+    
+    for (int c = 0; c < sg->columns; c++) {
+        const SpectrogramColumn* col = &sg->map[c];
+        double m;
+        if (col->bin_hi - col->bin_lo > 1) {
+            m = magnitudes[col->bin_lo];
+            for (int b = col->bin_lo + 1; b < col->bin_hi; b++) {
+                if (magnitudes[b] > m) m = magnitudes[b];
+            }
+        } else {
+            int b = (int)col->bin_pos;
+            float t = col->bin_pos - b;
+            m = b + 1 < num_bins ? magnitudes[b] * (1.0f - t) + magnitudes[b + 1] * t : magnitudes[b];
+        }
+        
+        int index = 0;
+        if (m > floor_magnitude) {
+            double db = 20.0 * log10(m / sg->reference);
+            index = (int)((db + SPECTROGRAM_RANGE_DB) * scale);
+            if (index > SPECTROGRAM_PALETTE_SIZE - 1) index = SPECTROGRAM_PALETTE_SIZE - 1;
+        }
+        row[c] = sg->palette[index];
+    }
+    return true;
+}
+
+const uint32_t* spectrogram_get_pixels(const Spectrogram* sg) {
+    if (!sg) return NULL;
+    return sg->pixels;
+}
+
+int spectrogram_get_head(const Spectrogram* sg) {
+    if (!sg) return 0;
+    return sg->head;
+}
+
+int spectrogram_get_columns(const Spectrogram* sg) {
+    if (!sg) return 0;
+    return sg->columns;
+}
+
+int spectrogram_get_rows(const Spectrogram* sg) {
+    if (!sg) return 0;
+    return sg->rows;
+}
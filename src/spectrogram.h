@@ -0,0 +1,55 @@
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Faixa de frequências exibida (eixo logarítmico)
+#define SPECTROGRAM_MIN_FREQ 20.0
+#define SPECTROGRAM_MAX_FREQ 20000.0
+
+// Faixa dinâmica exibida, em dB abaixo do fundo de escala
+#define SPECTROGRAM_RANGE_DB 90.0
+
+// Espectrograma (waterfall) numa imagem RGBA32 usada como anel de linhas:
+// cada espectro novo vira exatamente uma linha (colunas em frequência
+// logarítmica, cor por tabela de intensidade) escrita sobre a mais antiga.
+// A rolagem é só o deslocamento do início do anel; nada é copiado.
+typedef struct Spectrogram Spectrogram;
+
+// Inicializa o espectrograma
+// columns: colunas de frequência (largura da imagem)
+// rows: linhas de histórico (altura da imagem)
+Spectrogram* spectrogram_init(int columns, int rows);
+
+// Libera recursos do espectrograma
+void spectrogram_free(Spectrogram* sg);
+
+// Recalcula o mapa coluna → bins para o formato da FFT
+// sample_rate: taxa de amostragem do áudio
+// fft_size: tamanho da janela FFT (o espectro tem fft_size / 2 + 1 bins)
+// Retorna: false se os parâmetros forem inválidos (mantém o mapa atual)
+bool spectrogram_set_format(Spectrogram* sg, int sample_rate, int fft_size);
+
+// Apaga o histórico (todas as linhas ficam pretas)
+void spectrogram_clear(Spectrogram* sg);
+
+// Adiciona um espectro como a linha mais recente
+// magnitudes: magnitudes da FFT (num_bins = fft_size / 2 + 1)
+// Retorna: false se a linha não foi gravada (num_bins diferente do formato)
+bool spectrogram_push(Spectrogram* sg, const double* magnitudes, int num_bins);
+
+// Retorna a imagem do anel (rows linhas contíguas de columns pixels)
+const uint32_t* spectrogram_get_pixels(const Spectrogram* sg);
+
+// Retorna o índice da linha mais recente na imagem
+// (as linhas seguintes, com volta ao início, são cada vez mais antigas)
+int spectrogram_get_head(const Spectrogram* sg);
+
+// Retorna a largura da imagem (colunas)
+int spectrogram_get_columns(const Spectrogram* sg);
+
+// Retorna a altura da imagem (linhas)
+int spectrogram_get_rows(const Spectrogram* sg);
+
+#endif // SPECTROGRAM_H
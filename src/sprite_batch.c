@@ -0,0 +1,253 @@
+#include "sprite_batch.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <SDL2/SDL.h>
+#include "memory_arena.h"
+
+// SDL_RenderGeometry existe a partir do SDL 2.0.18
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define SPRITE_HAVE_GEOMETRY 1
+#else
+#define SPRITE_HAVE_GEOMETRY 0
+#endif
+
+typedef struct {
+    float x, y;
+    float radius;
+    RGBColor color;
+    uint8_t alpha;
+} Sprite;
+
+struct SpriteBatch {
+    SDL_Texture* texture;
+    
+    Sprite* sprites;
+    int num_sprites;
+    int sprites_capacity;
+    
+#if SPRITE_HAVE_GEOMETRY
+    // Buffers de vértices/índices montados a cada envio
+    SDL_Vertex* vertices;
+    int vertices_capacity;
+    int* indices;
+    int indices_capacity;
+#endif
+};
+
+// Garante capacidade para 'needed' elementos (cresce em potências de 2)
+static bool grow_array(void** array, int* capacity, int needed, size_t elem_size) {
+    if (needed <= *capacity) {
+        return true;
+    }
+    
+    int new_capacity = *capacity > 0 ? *capacity : 64;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    
+    void* grown = mem_realloc(*array, (size_t)new_capacity * elem_size);
+    if (!grown) {
+        return false;
+    }
+    
+    *array = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+// Cria a textura do círculo suave: branco com alpha caindo do centro à borda
+static SDL_Texture* create_sprite_texture(SDL_Renderer* renderer, int size) {
+    uint32_t* pixels = mem_alloc((size_t)size * size * sizeof(uint32_t));
+    if (!pixels) {
+        return NULL;
+    }
+    
+    float center = (size - 1) * 0.5f;
+    float inv_radius = 2.0f / size;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            float dx = (x - center) * inv_radius;
+            float dy = (y - center) * inv_radius;
+            float d = 1.0f - (dx * dx + dy * dy);
+            if (d < 0.0f) d = 0.0f;
+            // Queda suave (quadrática) sem borda visível
+            uint8_t a = (uint8_t)(d * d * 255.0f + 0.5f);
+            pixels[y * size + x] = COLOR_RGBA32(255, 255, 255, a);
+        }
+    }
+    
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                                             SDL_TEXTUREACCESS_STATIC, size, size);
+    if (texture && SDL_UpdateTexture(texture, NULL, pixels, size * (int)sizeof(uint32_t)) != 0) {
+        SDL_DestroyTexture(texture);
+        texture = NULL;
+    }
+    
+    mem_free(pixels);
+    return texture;
+}
+
+SpriteBatch* sprite_batch_init(SDL_Renderer* renderer, int sprite_size, int capacity) {
+    if (!renderer || sprite_size <= 0) {
+        return NULL;
+    }
+    
+    SpriteBatch* batch = mem_calloc(1, sizeof(SpriteBatch));
+    if (!batch) {
+        return NULL;
+    }
+    
+    if (capacity < 64) capacity = 64;
+    
+    batch->texture = create_sprite_texture(renderer, sprite_size);
+    bool ok = batch->texture &&
+              grow_array((void**)&batch->sprites, &batch->sprites_capacity,
+                         capacity, sizeof(Sprite));
+#if SPRITE_HAVE_GEOMETRY
+    ok = ok && grow_array((void**)&batch->vertices, &batch->vertices_capacity,
+                          capacity * 4, sizeof(SDL_Vertex)) &&
+               grow_array((void**)&batch->indices, &batch->indices_capacity,
+                          capacity * 6, sizeof(int));
+#endif
+    
+    if (!ok) {
+        fprintf(stderr, "Erro ao criar textura de sprite: %s\n", SDL_GetError());
+        sprite_batch_free(batch);
+        return NULL;
+    }
+    
+    return batch;
+}
+
+void sprite_batch_free(SpriteBatch* batch) {
+    if (!batch) return;
+    
+#if SPRITE_HAVE_GEOMETRY
+    if (batch->indices) {
+        mem_free(batch->indices);
+    }
+    if (batch->vertices) {
+        mem_free(batch->vertices);
+    }
+#endif
+    if (batch->sprites) {
+        mem_free(batch->sprites);
+    }
+    if (batch->texture) {
+        SDL_DestroyTexture(batch->texture);
+    }
+    
+    mem_free(batch);
+}
+
+void sprite_batch_clear(SpriteBatch* batch) {
+    if (!batch) return;
+    batch->num_sprites = 0;
+}
+
+bool sprite_batch_add(SpriteBatch* batch, float x, float y, float radius, RGBColor color, float alpha) {
+    if (!batch || radius <= 0.0f || alpha <= 0.0f) return false;
+    
+    if (!grow_array((void**)&batch->sprites, &batch->sprites_capacity,
+                    batch->num_sprites + 1, sizeof(Sprite))) {
+        return false;
+    }
+    
+    if (alpha > 1.0f) alpha = 1.0f;
+    
+    Sprite* s = &batch->sprites[batch->num_sprites++];
+    s->x = x;
+    s->y = y;
+    s->radius = radius;
+    s->color = color;
+    s->alpha = (uint8_t)(alpha * 255.0f + 0.5f);
+    return true;
+}
+
+#if SPRITE_HAVE_GEOMETRY
+static inline void set_vertex(SDL_Vertex* v, float x, float y, float u, float t, const Sprite* s) {
+    v->position.x = x;
+    v->position.y = y;
+    v->color.r = s->color.r;
+    v->color.g = s->color.g;
+    v->color.b = s->color.b;
+    v->color.a = s->alpha;
+    v->tex_coord.x = u;
+    v->tex_coord.y = t;
+}
+
+// Monta um quad por sprite e envia todos com uma chamada SDL_RenderGeometry
+// Retorna: false se o renderer não aceitou a geometria
+static bool submit_geometry(SpriteBatch* batch, SDL_Renderer* renderer) {
+    if (!grow_array((void**)&batch->vertices, &batch->vertices_capacity,
+                    batch->num_sprites * 4, sizeof(SDL_Vertex)) ||
+        !grow_array((void**)&batch->indices, &batch->indices_capacity,
+                    batch->num_sprites * 6, sizeof(int))) {
+        return false;
+    }
+    
+    SDL_Vertex* v = batch->vertices;
+    int* idx = batch->indices;
+    
+    for (int i = 0; i < batch->num_sprites; i++) {
+        const Sprite* s = &batch->sprites[i];
+        float x1 = s->x - s->radius;
+        float y1 = s->y - s->radius;
+        float x2 = s->x + s->radius;
+        float y2 = s->y + s->radius;
+        int a = i * 4;
+        
+        set_vertex(&v[a], x1, y1, 0.0f, 0.0f, s);
+        set_vertex(&v[a + 1], x2, y1, 1.0f, 0.0f, s);
+        set_vertex(&v[a + 2], x2, y2, 1.0f, 1.0f, s);
+        set_vertex(&v[a + 3], x1, y2, 0.0f, 1.0f, s);
+        
+        int* q = &idx[i * 6];
+        q[0] = a;
+        q[1] = a + 1;
+        q[2] = a + 2;
+        q[3] = a;
+        q[4] = a + 2;
+        q[5] = a + 3;
+    }
+    
+    return SDL_RenderGeometry(renderer, batch->texture, v, batch->num_sprites * 4,
+                              idx, batch->num_sprites * 6) == 0;
+}
+#endif
+
+// Fallback sem SDL_RenderGeometry: uma cópia da textura por sprite
+static void submit_fallback(SpriteBatch* batch, SDL_Renderer* renderer) {
+    for (int i = 0; i < batch->num_sprites; i++) {
+        const Sprite* s = &batch->sprites[i];
+        int size = (int)(s->radius * 2.0f + 0.5f);
+        if (size <= 0) continue;
+        
+        SDL_Rect dst = {(int)(s->x - s->radius), (int)(s->y - s->radius), size, size};
+        SDL_SetTextureColorMod(batch->texture, s->color.r, s->color.g, s->color.b);
+        SDL_SetTextureAlphaMod(batch->texture, s->alpha);
+        SDL_RenderCopy(renderer, batch->texture, NULL, &dst);
+    }
+    
+    SDL_SetTextureColorMod(batch->texture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(batch->texture, 255);
+}
+
+void sprite_batch_submit(SpriteBatch* batch, SDL_Renderer* renderer, bool additive) {
+    if (!batch || !renderer) return;
+    
+    if (batch->num_sprites > 0) {
+        SDL_SetTextureBlendMode(batch->texture, additive ? SDL_BLENDMODE_ADD : SDL_BLENDMODE_BLEND);
+        
+#if SPRITE_HAVE_GEOMETRY
+        if (!submit_geometry(batch, renderer)) {
+            submit_fallback(batch, renderer);
+        }
+#else
+        submit_fallback(batch, renderer);
+#endif
+    }
+    
+    sprite_batch_clear(batch);
+}
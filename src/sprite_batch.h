@@ -0,0 +1,34 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <stdbool.h>
+#include "color_mapper.h"
+
+struct SDL_Renderer;
+
+// Acumula sprites (quads texturizados com um círculo suave pré-calculado,
+// cor e alpha por vértice) e os envia numa única chamada SDL_RenderGeometry
+typedef struct SpriteBatch SpriteBatch;
+
+// Inicializa o lote e cria a textura do sprite no renderer
+// sprite_size: lado da textura do círculo suave em pixels
+// capacity: número inicial de sprites (os buffers crescem sob demanda)
+SpriteBatch* sprite_batch_init(struct SDL_Renderer* renderer, int sprite_size, int capacity);
+
+// Libera recursos do lote (inclusive a textura)
+void sprite_batch_free(SpriteBatch* batch);
+
+// Descarta os sprites acumulados (mantém a memória)
+void sprite_batch_clear(SpriteBatch* batch);
+
+// Adiciona um sprite centrado em (x, y)
+// radius: raio do círculo em pixels
+// alpha: opacidade (mistura normal) ou intensidade (mistura aditiva), em [0, 1]
+// Retorna: false se não houver memória
+bool sprite_batch_add(SpriteBatch* batch, float x, float y, float radius, RGBColor color, float alpha);
+
+// Envia os sprites ao renderer e limpa o lote
+// additive: true = mistura aditiva, false = mistura alpha
+void sprite_batch_submit(SpriteBatch* batch, struct SDL_Renderer* renderer, bool additive);
+
+#endif // SPRITE_BATCH_H
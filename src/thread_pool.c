@@ -0,0 +1,167 @@
+#include "thread_pool.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <SDL2/SDL.h>
+#include "memory_arena.h"
+
+struct ThreadPool {
+    SDL_Thread** threads;
+    int num_threads;
+    
+    SDL_mutex* mutex;
+    SDL_cond* work_cond;   // Sinaliza novo trabalho (ou encerramento)
+    SDL_cond* done_cond;   // Sinaliza que todas as threads terminaram o lote
+    
+    // Lote atual
+    ThreadPoolTask task;
+    void* arg;
+    int count;
+    atomic_int next_index;
+    int active_workers;
+    unsigned int generation;
+    bool quit;
+};
+
+// Consome itens do lote atual até acabarem
+static void run_items(ThreadPool* pool) {
+    for (;;) {
+        int index = atomic_fetch_add(&pool->next_index, 1);
+        if (index >= pool->count) {
+            break;
+        }
+        pool->task(pool->arg, index);
+    }
+}
+
+static int worker_main(void* data) {
+    ThreadPool* pool = data;
+    unsigned int seen_generation = 0;
+    
+    SDL_LockMutex(pool->mutex);
+    for (;;) {
+        while (!pool->quit && pool->generation == seen_generation) {
+            SDL_CondWait(pool->work_cond, pool->mutex);
+        }
+        if (pool->quit) {
+            break;
+        }
+        seen_generation = pool->generation;
+        SDL_UnlockMutex(pool->mutex);
+        
+        run_items(pool);
+        
+        SDL_LockMutex(pool->mutex);
+        pool->active_workers--;
+        if (pool->active_workers == 0) {
+            SDL_CondSignal(pool->done_cond);
+        }
+    }
+    SDL_UnlockMutex(pool->mutex);
+    
+    return 0;
+}
+
+ThreadPool* thread_pool_init(int num_threads) {
+    if (num_threads <= 0) {
+        // A thread chamadora também trabalha
+        num_threads = SDL_GetCPUCount() - 1;
+        if (num_threads < 1) num_threads = 1;
+    }
+    
+    ThreadPool* pool = mem_calloc(1, sizeof(ThreadPool));
+    if (!pool) {
+        return NULL;
+    }
+    
+    atomic_init(&pool->next_index, 0);
+    pool->threads = mem_calloc(num_threads, sizeof(SDL_Thread*));
+    pool->mutex = SDL_CreateMutex();
+    pool->work_cond = SDL_CreateCond();
+    pool->done_cond = SDL_CreateCond();
+    
+    if (!pool->threads || !pool->mutex || !pool->work_cond || !pool->done_cond) {
+        thread_pool_free(pool);
+        return NULL;
+    }
+    
+    for (int i = 0; i < num_threads; i++) {
+        pool->threads[i] = SDL_CreateThread(worker_main, "soundwave-worker", pool);
+        if (!pool->threads[i]) {
+            fprintf(stderr, "Erro ao criar thread de trabalho: %s\n", SDL_GetError());
+            thread_pool_free(pool);
+            return NULL;
+        }
+        pool->num_threads++;
+    }
+    
+    return pool;
+}
+
+void thread_pool_free(ThreadPool* pool) {
+    if (!pool) return;
+    
+    if (pool->mutex) {
+        SDL_LockMutex(pool->mutex);
+        pool->quit = true;
+        if (pool->work_cond) {
+            SDL_CondBroadcast(pool->work_cond);
+        }
+        SDL_UnlockMutex(pool->mutex);
+    }
+    
+    for (int i = 0; i < pool->num_threads; i++) {
+        SDL_WaitThread(pool->threads[i], NULL);
+    }
+    
+    if (pool->done_cond) {
+        SDL_DestroyCond(pool->done_cond);
+    }
+    if (pool->work_cond) {
+        SDL_DestroyCond(pool->work_cond);
+    }
+    if (pool->mutex) {
+        SDL_DestroyMutex(pool->mutex);
+    }
+    if (pool->threads) {
+        mem_free(pool->threads);
+    }
+    
+    mem_free(pool);
+}
+
+int thread_pool_get_size(ThreadPool* pool) {
+    if (!pool) return 0;
+    return pool->num_threads;
+}
+
+void thread_pool_parallel_for(ThreadPool* pool, int count, ThreadPoolTask task, void* arg) {
+    if (!task || count <= 0) return;
+    
+    // Sem pool (ou um único item) executa na thread chamadora
+    if (!pool || pool->num_threads == 0 || count == 1) {
+        for (int i = 0; i < count; i++) {
+            task(arg, i);
+        }
+        return;
+    }
+    
+    SDL_LockMutex(pool->mutex);
+    pool->task = task;
+    pool->arg = arg;
+    pool->count = count;
+    atomic_store(&pool->next_index, 0);
+    pool->active_workers = pool->num_threads;
+    pool->generation++;
+    SDL_CondBroadcast(pool->work_cond);
+    SDL_UnlockMutex(pool->mutex);
+    
+    run_items(pool);
+    
+    SDL_LockMutex(pool->mutex);
+    while (pool->active_workers > 0) {
+        SDL_CondWait(pool->done_cond, pool->mutex);
+    }
+    SDL_UnlockMutex(pool->mutex);
+}
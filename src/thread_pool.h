@@ -0,0 +1,26 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// Tarefa executada para cada índice de um parallel_for
+// arg: ponteiro repassado pelo chamador
+// index: índice do item em [0, count)
+typedef void (*ThreadPoolTask)(void* arg, int index);
+
+// Conjunto fixo de threads de trabalho
+typedef struct ThreadPool ThreadPool;
+
+// Inicializa o pool
+// num_threads: número de threads de trabalho (0 = núcleos disponíveis - 1)
+ThreadPool* thread_pool_init(int num_threads);
+
+// Encerra as threads e libera recursos do pool
+void thread_pool_free(ThreadPool* pool);
+
+// Retorna o número de threads de trabalho (sem contar o chamador)
+int thread_pool_get_size(ThreadPool* pool);
+
+// Executa task(arg, i) para todo i em [0, count) distribuindo os itens entre
+// as threads do pool e a thread chamadora; retorna quando todos terminarem
+void thread_pool_parallel_for(ThreadPool* pool, int count, ThreadPoolTask task, void* arg);
+
+#endif // THREAD_POOL_H
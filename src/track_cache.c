@@ -0,0 +1,479 @@
+// open, fstat e mmap (POSIX)
+#define _POSIX_C_SOURCE 200809L
+
+#include "track_cache.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "memory_arena.h"
+
+#define TRACK_CACHE_VERSION 1
+
+// Faixa de frequências dos bins logarítmicos (até Nyquist)
+#define TRACK_CACHE_MIN_FREQ 20.0f
+
+// Quantização em dB: espectro em passos de 0,5 dB a partir de -40 dB
+// (0 = abaixo do piso) e energias em passos de 0,01 dB
+#define TRACK_CACHE_DB_FLOOR -40.0f
+#define TRACK_CACHE_DB_STEP 0.5f
+#define TRACK_CACHE_ENERGY_DB_STEP 0.01f
+
+// Bytes do início do arquivo de origem usados na identificação
+#define TRACK_CACHE_FINGERPRINT_BYTES 65536
+
+// Limite de quadros cujos ataques são somados numa leitura
+#define TRACK_CACHE_MAX_ONSET_SPAN 64
+
+typedef struct {
+    char magic[4];             // "SWVT"
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t record_size;
+    uint32_t sample_rate;
+    uint32_t window_size;
+    uint32_t hop;
+    uint32_t log_bins;
+    uint32_t wave_points;
+    float min_freq;
+    float db_floor;
+    float db_step;
+    float energy_db_step;
+    uint32_t reserved[3];
+    uint64_t num_frames;
+    uint64_t num_samples;
+    uint64_t source_size;
+    uint64_t source_hash;
+} TrackCacheHeader;
+
+typedef struct {
+    uint16_t dominant_freq;    // Hz
+    uint16_t energies[3];      // Graves, médios, agudos
+    uint8_t onsets;            // ANALYSIS_ONSET_*
+    uint8_t spectrum_ready;
+    uint8_t spectrum[TRACK_CACHE_LOG_BINS];
+    int8_t wave_min[TRACK_CACHE_WAVE_POINTS];
+    int8_t wave_max[TRACK_CACHE_WAVE_POINTS];
+} TrackCacheRecord;
+
+_Static_assert(sizeof(TrackCacheHeader) == 96, "cabeçalho .swv deve ter 96 bytes");
+_Static_assert(TRACK_CACHE_WAVE_POINTS * 2 <= ANALYSIS_MAX_BLOCK, "resumo da waveform maior que um bloco");
+
+struct TrackCacheWriter {
+    FILE* file;
+    char* path;
+    char* partial;
+    TrackCacheHeader header;
+    TrackCacheRecord record;
+    int num_bins;
+    int* bin_map;              // Bin linear -> bin logarítmico (-1 = DC)
+    int* center_bins;          // Bin linear no centro de cada bin logarítmico
+};
+
+struct TrackCache {
+    void* mapped;
+    size_t size;
+    const TrackCacheHeader* header;
+    const TrackCacheRecord* records;
+    int num_bins;
+    int* bin_map;
+    double spectrum_levels[256];   // Magnitude de cada valor quantizado
+};
+
+// Identifica o arquivo de origem: tamanho e FNV-1a do início (sobrevive a
+// cópias entre máquinas, ao contrário da data de modificação)
+static bool source_fingerprint(const char* path, uint64_t* size, uint64_t* hash) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    
+    unsigned char buffer[4096];
+    uint64_t h = 1469598103934665603ULL;
+    size_t total = 0;
+    size_t got;
+    while (total < TRACK_CACHE_FINGERPRINT_BYTES && (got = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        for (size_t i = 0; i < got; i++) {
+            h = (h ^ buffer[i]) * 1099511628211ULL;
+        }
+        total += got;
+    }
+    
+    fseek(file, 0, SEEK_END);
+    long end = ftell(file);
+    fclose(file);
+    if (end < 0) {
+        return false;
+    }
+    
+    *size = (uint64_t)end;
+    *hash = h;
+    return true;
+}
+
+// Mapeia cada bin linear para o bin logarítmico que contém sua frequência
+static void build_bin_map(int* map, int num_bins, int sample_rate, int window_size) {
+    double max_freq = sample_rate / 2.0;
+    double span = log(max_freq / TRACK_CACHE_MIN_FREQ);
+    
+    map[0] = -1;
+    for (int i = 1; i < num_bins; i++) {
+        double freq = (double)i * sample_rate / window_size;
+        int k = freq <= TRACK_CACHE_MIN_FREQ ? 0 :
+                (int)(TRACK_CACHE_LOG_BINS * log(freq / TRACK_CACHE_MIN_FREQ) / span);
+        if (k >= TRACK_CACHE_LOG_BINS) k = TRACK_CACHE_LOG_BINS - 1;
+        map[i] = k;
+    }
+}
+
+static uint8_t quantize_spectrum(double magnitude) {
+    if (magnitude <= 0.0) return 0;
+    double q = (20.0 * log10(magnitude) - TRACK_CACHE_DB_FLOOR) / TRACK_CACHE_DB_STEP;
+    if (q < 1.0) return 0;
+    if (q > 255.0) return 255;
+    return (uint8_t)(q + 0.5);
+}
+
+static uint16_t quantize_energy(double energy) {
+    if (energy <= 0.0) return 0;
+    double q = (20.0 * log10(energy) - TRACK_CACHE_DB_FLOOR) / TRACK_CACHE_ENERGY_DB_STEP;
+    if (q < 1.0) return 0;
+    if (q > 65535.0) return 65535;
+    return (uint16_t)(q + 0.5);
+}
+
+static double dequantize(unsigned int q, float step) {
+    if (q == 0) return 0.0;
+    return pow(10.0, (TRACK_CACHE_DB_FLOOR + q * step) / 20.0);
+}
+
+static char* copy_string(const char* text) {
+    size_t length = strlen(text) + 1;
+    char* copy = mem_alloc(length);
+    if (copy) {
+        memcpy(copy, text, length);
+    }
+    return copy;
+}
+
+static void free_writer(TrackCacheWriter* writer) {
+    if (writer->center_bins) mem_free(writer->center_bins);
+    if (writer->bin_map) mem_free(writer->bin_map);
+    if (writer->partial) mem_free(writer->partial);
+    if (writer->path) mem_free(writer->path);
+    mem_free(writer);
+}
+
+TrackCacheWriter* track_cache_writer_open(const char* path, const char* source_path,
+                                          int sample_rate, int window_size, int hop) {
+    if (!path || !source_path || sample_rate <= 0 || window_size <= 0 ||
+        window_size > ANALYSIS_MAX_WINDOW || hop <= 0 || hop > ANALYSIS_MAX_BLOCK) {
+        return NULL;
+    }
+    
+    TrackCacheWriter* writer = mem_calloc(1, sizeof(TrackCacheWriter));
+    if (!writer) {
+        return NULL;
+    }
+    
+    TrackCacheHeader* header = &writer->header;
+    memcpy(header->magic, "SWVT", 4);
+    header->version = TRACK_CACHE_VERSION;
+    header->header_size = sizeof(TrackCacheHeader);
+    header->record_size = sizeof(TrackCacheRecord);
+    header->sample_rate = (uint32_t)sample_rate;
+    header->window_size = (uint32_t)window_size;
+    header->hop = (uint32_t)hop;
+    header->log_bins = TRACK_CACHE_LOG_BINS;
+    header->wave_points = TRACK_CACHE_WAVE_POINTS;
+    header->min_freq = TRACK_CACHE_MIN_FREQ;
+    header->db_floor = TRACK_CACHE_DB_FLOOR;
+    header->db_step = TRACK_CACHE_DB_STEP;
+    header->energy_db_step = TRACK_CACHE_ENERGY_DB_STEP;
+    
+    if (!source_fingerprint(source_path, &header->source_size, &header->source_hash)) {
+        fprintf(stderr, "Erro ao ler arquivo de origem: %s\n", source_path);
+        free_writer(writer);
+        return NULL;
+    }
+    
+    writer->num_bins = window_size / 2 + 1;
+    writer->bin_map = mem_alloc(writer->num_bins * sizeof(int));
+    writer->center_bins = mem_alloc(TRACK_CACHE_LOG_BINS * sizeof(int));
+    writer->path = copy_string(path);
+    writer->partial = mem_alloc(strlen(path) + 6);
+    if (!writer->bin_map || !writer->center_bins || !writer->path || !writer->partial) {
+        free_writer(writer);
+        return NULL;
+    }
+    
+    build_bin_map(writer->bin_map, writer->num_bins, sample_rate, window_size);
+    
+    // Bins logarítmicos mais estreitos que a resolução da FFT usam o bin
+    // linear mais próximo do seu centro
+    double span = log(sample_rate / 2.0 / TRACK_CACHE_MIN_FREQ);
+    for (int k = 0; k < TRACK_CACHE_LOG_BINS; k++) {
+        double center = TRACK_CACHE_MIN_FREQ * exp(span * (k + 0.5) / TRACK_CACHE_LOG_BINS);
+        int bin = (int)(center * window_size / sample_rate + 0.5);
+        if (bin < 1) bin = 1;
+        if (bin >= writer->num_bins) bin = writer->num_bins - 1;
+        writer->center_bins[k] = bin;
+    }
+    
+    // Cabeçalho provisório: o número de quadros é regravado no fechamento
+    sprintf(writer->partial, "%s.part", path);
+    writer->file = fopen(writer->partial, "wb");
+    if (!writer->file || fwrite(header, sizeof(*header), 1, writer->file) != 1) {
+        fprintf(stderr, "Erro ao criar arquivo de replay: %s\n", writer->partial);
+        if (writer->file) {
+            fclose(writer->file);
+            remove(writer->partial);
+        }
+        free_writer(writer);
+        return NULL;
+    }
+    
+    return writer;
+}
+
+bool track_cache_writer_add(TrackCacheWriter* writer, const AnalysisFrame* frame) {
+    if (!writer || !frame) return false;
+    
+    TrackCacheRecord* record = &writer->record;
+    memset(record, 0, sizeof(*record));
+    record->onsets = (uint8_t)frame->onsets;
+    record->spectrum_ready = frame->spectrum_ready ? 1 : 0;
+    
+    if (frame->spectrum_ready) {
+        double dominant = frame->dominant_freq + 0.5;
+        record->dominant_freq = (uint16_t)(dominant > 65535.0 ? 65535.0 : dominant);
+        record->energies[0] = quantize_energy(frame->low_energy);
+        record->energies[1] = quantize_energy(frame->mid_energy);
+        record->energies[2] = quantize_energy(frame->high_energy);
+        
+        // Pico dos bins lineares de cada bin logarítmico
+        double peaks[TRACK_CACHE_LOG_BINS] = {0};
+        bool filled[TRACK_CACHE_LOG_BINS] = {false};
+        int num_bins = frame->num_bins < writer->num_bins ? frame->num_bins : writer->num_bins;
+        for (int i = 1; i < num_bins; i++) {
+            int k = writer->bin_map[i];
+            if (!filled[k] || frame->frequencies[i] > peaks[k]) {
+                peaks[k] = frame->frequencies[i];
+                filled[k] = true;
+            }
+        }
+        for (int k = 0; k < TRACK_CACHE_LOG_BINS; k++) {
+            double magnitude = filled[k] ? peaks[k] :
+                               (writer->center_bins[k] < num_bins ? frame->frequencies[writer->center_bins[k]] : 0.0);
+            record->spectrum[k] = quantize_spectrum(magnitude);
+        }
+    }
+    
+    // Mínimo e máximo de cada trecho do bloco (8 bits mais significativos)
+    int n = frame->num_samples;
+    for (int p = 0; p < TRACK_CACHE_WAVE_POINTS && n > 0; p++) {
+        int first = (int)((int64_t)p * n / TRACK_CACHE_WAVE_POINTS);
+        int last = (int)((int64_t)(p + 1) * n / TRACK_CACHE_WAVE_POINTS);
+        if (last <= first) last = first + 1;
+        int16_t lo = frame->samples[first];
+        int16_t hi = lo;
+        for (int i = first + 1; i < last && i < n; i++) {
+            if (frame->samples[i] < lo) lo = frame->samples[i];
+            if (frame->samples[i] > hi) hi = frame->samples[i];
+        }
+        record->wave_min[p] = (int8_t)(lo >> 8);
+        record->wave_max[p] = (int8_t)(hi >> 8);
+    }
+    
+    if (fwrite(record, sizeof(*record), 1, writer->file) != 1) {
+        return false;
+    }
+    writer->header.num_frames++;
+    writer->header.num_samples += (uint64_t)(n > 0 ? n : 0);
+    return true;
+}
+
+bool track_cache_writer_close(TrackCacheWriter* writer, bool commit) {
+    if (!writer) return false;
+    
+    bool ok = commit && !ferror(writer->file);
+    if (ok) {
+        ok = fseek(writer->file, 0, SEEK_SET) == 0 &&
+             fwrite(&writer->header, sizeof(writer->header), 1, writer->file) == 1;
+    }
+    ok = fclose(writer->file) == 0 && ok;
+    
+    if (ok && rename(writer->partial, writer->path) != 0) {
+        fprintf(stderr, "Erro ao gravar arquivo de replay: %s\n", writer->path);
+        ok = false;
+    }
+    if (!ok) {
+        remove(writer->partial);
+    }
+    
+    free_writer(writer);
+    return ok;
+}
+
+bool track_cache_build(const char* path, const char* source_path, AudioDecoder* decoder,
+                       AudioAnalyzer* analyzer, int sample_rate, int window_size, int hop) {
+    if (!decoder || !analyzer) return false;
+    
+    TrackCacheWriter* writer = track_cache_writer_open(path, source_path, sample_rate, window_size, hop);
+    AnalysisFrame* frame = mem_alloc(sizeof(AnalysisFrame));
+    int16_t* block = mem_alloc(ANALYSIS_MAX_BLOCK * sizeof(int16_t));
+    if (!writer || !frame || !block) {
+        if (block) mem_free(block);
+        if (frame) mem_free(frame);
+        if (writer) track_cache_writer_close(writer, false);
+        return false;
+    }
+    
+    // Só as medidas são gravadas: as cores são refeitas no replay
+    audio_analyzer_set_colors(analyzer, false);
+    audio_analyzer_reset(analyzer);
+    
+    bool ok = true;
+    int samples_read;
+    while (ok && (samples_read = audio_decoder_read(decoder, block, hop)) > 0) {
+        audio_analyzer_process(analyzer, block, samples_read, frame);
+        ok = track_cache_writer_add(writer, frame);
+    }
+    
+    audio_analyzer_set_colors(analyzer, true);
+    audio_analyzer_reset(analyzer);
+    mem_free(block);
+    mem_free(frame);
+    return track_cache_writer_close(writer, ok);
+}
+
+TrackCache* track_cache_open(const char* path, const char* source_path) {
+    if (!path) return NULL;
+    
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    
+    struct stat st;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(TrackCacheHeader)) {
+        mapped = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return NULL;
+    }
+    
+    // Formato, tamanho e origem precisam bater
+    const TrackCacheHeader* header = mapped;
+    size_t size = (size_t)st.st_size;
+    bool valid = memcmp(header->magic, "SWVT", 4) == 0 &&
+                 header->version == TRACK_CACHE_VERSION &&
+                 header->header_size == sizeof(TrackCacheHeader) &&
+                 header->record_size == sizeof(TrackCacheRecord) &&
+                 header->log_bins == TRACK_CACHE_LOG_BINS &&
+                 header->wave_points == TRACK_CACHE_WAVE_POINTS &&
+                 header->sample_rate > 0 && header->hop > 0 &&
+                 header->window_size > 0 && header->window_size <= ANALYSIS_MAX_WINDOW &&
+                 header->num_frames <= (size - sizeof(TrackCacheHeader)) / sizeof(TrackCacheRecord);
+    
+    if (valid && source_path) {
+        uint64_t source_size, source_hash;
+        valid = source_fingerprint(source_path, &source_size, &source_hash) &&
+                source_size == header->source_size && source_hash == header->source_hash;
+    }
+    
+    TrackCache* cache = valid ? mem_calloc(1, sizeof(TrackCache)) : NULL;
+    if (cache) {
+        cache->num_bins = header->window_size / 2 + 1;
+        cache->bin_map = mem_alloc(cache->num_bins * sizeof(int));
+    }
+    if (!cache || !cache->bin_map) {
+        if (cache) mem_free(cache);
+        munmap(mapped, size);
+        return NULL;
+    }
+    
+    cache->mapped = mapped;
+    cache->size = size;
+    cache->header = header;
+    cache->records = (const TrackCacheRecord*)((const uint8_t*)mapped + sizeof(TrackCacheHeader));
+    build_bin_map(cache->bin_map, cache->num_bins, header->sample_rate, header->window_size);
+    for (int q = 0; q < 256; q++) {
+        cache->spectrum_levels[q] = dequantize(q, header->db_step);
+    }
+    
+    return cache;
+}
+
+void track_cache_free(TrackCache* cache) {
+    if (!cache) return;
+    
+    munmap(cache->mapped, cache->size);
+    mem_free(cache->bin_map);
+    mem_free(cache);
+}
+
+int track_cache_get_sample_rate(const TrackCache* cache) {
+    if (!cache) return 0;
+    return (int)cache->header->sample_rate;
+}
+
+int track_cache_get_window_size(const TrackCache* cache) {
+    if (!cache) return 0;
+    return (int)cache->header->window_size;
+}
+
+uint64_t track_cache_get_num_samples(const TrackCache* cache) {
+    if (!cache) return 0;
+    return cache->header->num_samples;
+}
+
+bool track_cache_read(const TrackCache* cache, uint64_t start, uint64_t end, AnalysisFrame* frame) {
+    if (!cache || !frame) return false;
+    
+    const TrackCacheHeader* header = cache->header;
+    if (header->num_frames == 0 || start >= header->num_samples) {
+        return false;
+    }
+    
+    uint64_t last = (end > start ? end - 1 : start) / header->hop;
+    if (last >= header->num_frames) last = header->num_frames - 1;
+    uint64_t first = start / header->hop;
+    if (first > last) first = last;
+    if (last - first >= TRACK_CACHE_MAX_ONSET_SPAN) first = last - TRACK_CACHE_MAX_ONSET_SPAN + 1;
+    
+    const TrackCacheRecord* record = &cache->records[last];
+    frame->onsets = 0;
+    for (uint64_t k = first; k <= last; k++) {
+        frame->onsets |= cache->records[k].onsets;
+    }
+    
+    frame->spectrum_ready = record->spectrum_ready != 0;
+    frame->dominant_freq = record->dominant_freq;
+    frame->low_energy = dequantize(record->energies[0], header->energy_db_step);
+    frame->mid_energy = dequantize(record->energies[1], header->energy_db_step);
+    frame->high_energy = dequantize(record->energies[2], header->energy_db_step);
+    
+    // Espectro em degraus: cada bin linear recebe o valor do seu bin logarítmico
+    frame->num_bins = cache->num_bins;
+    frame->frequencies[0] = 0.0;
+    for (int i = 1; i < cache->num_bins; i++) {
+        frame->frequencies[i] = cache->spectrum_levels[record->spectrum[cache->bin_map[i]]];
+    }
+    
+    // Waveform: mínimo e máximo de cada trecho, alternados
+    frame->num_samples = TRACK_CACHE_WAVE_POINTS * 2;
+    for (int p = 0; p < TRACK_CACHE_WAVE_POINTS; p++) {
+        frame->samples[2 * p] = (int16_t)(record->wave_min[p] * 256);
+        frame->samples[2 * p + 1] = (int16_t)(record->wave_max[p] * 256);
+    }
+    
+    frame->position = end;
+    return true;
+}
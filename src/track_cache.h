@@ -0,0 +1,75 @@
+#ifndef TRACK_CACHE_H
+#define TRACK_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_decoder.h"
+#include "audio_analyzer.h"
+
+// Faixa pré-calculada (.swv): um registro quantizado por salto de análise,
+// gravado por uma passada de análise e mapeado na memória na reprodução.
+// O replay lê o quadro da posição tocada em vez de rodar a FFT.
+//
+// Formato (versão 1, ordem de bytes nativa/little-endian):
+//   cabeçalho de 96 bytes: "SWVT", versão, tamanhos, taxa de amostragem,
+//     janela FFT, salto, parâmetros da quantização, número de quadros e de
+//     samples, tamanho e hash do início do arquivo de origem
+//   registros de tamanho fixo (o quadro k cobre os samples [k*salto, (k+1)*salto)):
+//     frequência dominante (uint16, Hz), energias das bandas (uint16, dB em
+//     passos de 0,01), ataques, espectro em TRACK_CACHE_LOG_BINS bins
+//     logarítmicos (uint8, dB em passos de 0,5) e resumo da waveform
+//     (mínimo e máximo de TRACK_CACHE_WAVE_POINTS trechos, int8)
+
+#define TRACK_CACHE_LOG_BINS 256
+#define TRACK_CACHE_WAVE_POINTS 64
+
+// ---- Gravação ----
+
+typedef struct TrackCacheWriter TrackCacheWriter;
+
+// Começa a gravar (num arquivo temporário, renomeado no fechamento)
+// source_path: arquivo de áudio de origem (identifica a faixa no replay)
+// hop: samples por quadro (cada quadro adicionado cobre hop samples)
+TrackCacheWriter* track_cache_writer_open(const char* path, const char* source_path,
+                                          int sample_rate, int window_size, int hop);
+
+// Quantiza e acrescenta um quadro de análise (na ordem do arquivo)
+bool track_cache_writer_add(TrackCacheWriter* writer, const AnalysisFrame* frame);
+
+// Finaliza o arquivo e libera o gravador
+// commit: false descarta o que foi gravado
+// Retorna: false se o arquivo não pôde ser gravado
+bool track_cache_writer_close(TrackCacheWriter* writer, bool commit);
+
+// Passada de análise completa: lê o decodificador do início ao fim em blocos
+// de hop samples, analisa e grava cada quadro
+bool track_cache_build(const char* path, const char* source_path, AudioDecoder* decoder,
+                       AudioAnalyzer* analyzer, int sample_rate, int window_size, int hop);
+
+// ---- Leitura ----
+
+typedef struct TrackCache TrackCache;
+
+// Mapeia um arquivo .swv
+// source_path: se não NULL, recusa o arquivo se ele foi gerado de outra faixa
+// Retorna: NULL se o arquivo não existe, é de outra versão ou de outra faixa
+TrackCache* track_cache_open(const char* path, const char* source_path);
+
+// Desmapeia e libera o cache
+void track_cache_free(TrackCache* cache);
+
+// Formato com que a faixa foi analisada
+int track_cache_get_sample_rate(const TrackCache* cache);
+int track_cache_get_window_size(const TrackCache* cache);
+
+// Retorna a duração da faixa em samples
+uint64_t track_cache_get_num_samples(const TrackCache* cache);
+
+// Reconstrói o quadro que termina em end (samples, espectro em bins
+// lineares, bandas, frequência dominante); os ataques de todos os quadros
+// em [start, end) são somados, para não se perderem quando o leitor pula
+// quadros. As cores ficam a cargo de audio_analyzer_fill_colors.
+// Retorna: false se start já passou do fim da faixa
+bool track_cache_read(const TrackCache* cache, uint64_t start, uint64_t end, AnalysisFrame* frame);
+
+#endif // TRACK_CACHE_H
@@ -0,0 +1,90 @@
+#include "triple_buffer.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "memory_arena.h"
+
+// Slots alinhados a uma linha de cache (escritor e leitor não disputam linhas)
+#define TRIPLE_BUFFER_ALIGN 64
+
+// Bit que marca o slot do meio como publicado e ainda não lido
+#define TRIPLE_BUFFER_FRESH 4u
+
+struct TripleBuffer {
+    unsigned char* block;
+    size_t stride;
+    
+    // Índice do slot do meio (bits 0-1) + TRIPLE_BUFFER_FRESH
+    atomic_uint middle;
+    
+    // Slots de cada lado (acessados só pela respectiva thread)
+    unsigned int back;
+    unsigned int front;
+    bool has_front;
+};
+
+TripleBuffer* triple_buffer_init(size_t slot_size) {
+    if (slot_size == 0) {
+        return NULL;
+    }
+    
+    TripleBuffer* tb = mem_alloc(sizeof(TripleBuffer));
+    if (!tb) {
+        return NULL;
+    }
+    
+    tb->stride = (slot_size + TRIPLE_BUFFER_ALIGN - 1) & ~(size_t)(TRIPLE_BUFFER_ALIGN - 1);
+    tb->block = mem_calloc(3, tb->stride);
+    if (!tb->block) {
+        mem_free(tb);
+        return NULL;
+    }
+    
+    tb->back = 0;
+    atomic_init(&tb->middle, 1u);
+    tb->front = 2;
+    tb->has_front = false;
+    return tb;
+}
+
+void triple_buffer_free(TripleBuffer* tb) {
+    if (!tb) return;
+    
+    if (tb->block) {
+        mem_free(tb->block);
+    }
+    
+    mem_free(tb);
+}
+
+void* triple_buffer_write_slot(TripleBuffer* tb) {
+    if (!tb) return NULL;
+    return tb->block + tb->back * tb->stride;
+}
+
+void triple_buffer_publish(TripleBuffer* tb) {
+    if (!tb) return;
+    
+    // Troca trás <-> meio; release torna a escrita do slot visível ao leitor
+    unsigned int old = atomic_exchange_explicit(&tb->middle, tb->back | TRIPLE_BUFFER_FRESH,
+                                                memory_order_acq_rel);
+    tb->back = old & 3u;
+}
+
+const void* triple_buffer_read(TripleBuffer* tb, bool* fresh) {
+    if (fresh) *fresh = false;
+    if (!tb) return NULL;
+    
+    if (atomic_load_explicit(&tb->middle, memory_order_relaxed) & TRIPLE_BUFFER_FRESH) {
+        // Troca frente <-> meio; acquire enxerga a escrita do slot publicado
+        unsigned int old = atomic_exchange_explicit(&tb->middle, tb->front, memory_order_acq_rel);
+        tb->front = old & 3u;
+        tb->has_front = true;
+        if (fresh) *fresh = true;
+    }
+    
+    if (!tb->has_front) {
+        return NULL;
+    }
+    return tb->block + tb->front * tb->stride;
+}
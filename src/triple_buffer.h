@@ -0,0 +1,29 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Buffer triplo sem travas para um escritor e um leitor: o escritor preenche
+// o slot de trás e o publica; o leitor sempre obtém o último slot publicado.
+// Nenhum lado espera pelo outro e nenhum slot é lido enquanto é escrito.
+typedef struct TripleBuffer TripleBuffer;
+
+// Inicializa o buffer com três slots de slot_size bytes (zerados)
+TripleBuffer* triple_buffer_init(size_t slot_size);
+
+// Libera recursos do buffer
+void triple_buffer_free(TripleBuffer* tb);
+
+// Escritor: retorna o slot de trás, exclusivo do escritor até publicar
+void* triple_buffer_write_slot(TripleBuffer* tb);
+
+// Escritor: publica o slot de trás como o mais recente
+void triple_buffer_publish(TripleBuffer* tb);
+
+// Leitor: retorna o slot publicado mais recente (válido até a próxima leitura)
+// fresh: se não NULL, recebe true quando houve publicação desde a última leitura
+// Retorna: NULL se nada foi publicado ainda
+const void* triple_buffer_read(TripleBuffer* tb, bool* fresh);
+
+#endif // TRIPLE_BUFFER_H
@@ -0,0 +1,584 @@
+#include "video_exporter.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <SDL2/SDL.h>
+
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include "memory_arena.h"
+
+// Quadros em trânsito entre a renderização e a thread de codificação
+#define EXPORT_QUEUE_SLOTS 4
+
+// Taxa de bits usada quando o codec não escolhe sozinho
+#define EXPORT_VIDEO_BIT_RATE 8000000
+#define EXPORT_AUDIO_BIT_RATE 192000
+
+typedef struct {
+    uint32_t* pixels;
+    int16_t* audio;
+    int num_audio;
+} ExportSlot;
+
+// Estado da codificação com libavcodec/libavformat
+typedef struct {
+    AVFormatContext* format_ctx;
+    AVCodecContext* video_ctx;
+    AVCodecContext* audio_ctx;
+    AVStream* video_stream;
+    AVStream* audio_stream;
+    AVFrame* video_frame;
+    AVFrame* audio_frame;
+    AVPacket* packet;
+    int64_t video_pts;
+    int64_t audio_pts;
+    
+    // Samples aguardando completar um quadro de áudio do codec
+    int16_t* audio_fifo;
+    int audio_fifo_size;
+    int audio_frame_size;
+} Encoder;
+
+struct VideoExporter {
+    VideoExportFormat format;
+    int width;
+    int height;
+    int fps;
+    int sample_rate;
+    
+    // Saída RAW/Y4M
+    FILE* file;
+    uint8_t* yuv;
+    
+    Encoder enc;
+    
+    // Fila circular: a renderização preenche 'head', a thread consome 'tail'
+    ExportSlot slots[EXPORT_QUEUE_SLOTS];
+    int audio_capacity;
+    int head;
+    int tail;
+    int count;
+    bool closing;
+    SDL_mutex* mutex;
+    SDL_cond* not_empty;
+    SDL_cond* not_full;
+    SDL_Thread* thread;
+    atomic_bool failed;
+};
+
+// Converte RGBA32 para YUV 4:2:0 (BT.601, faixa limitada); croma pela média 2x2
+static void rgba_to_yuv420(const uint32_t* pixels, int width, int height,
+                           uint8_t* y_plane, int y_stride,
+                           uint8_t* u_plane, int u_stride,
+                           uint8_t* v_plane, int v_stride) {
+    for (int y = 0; y < height; y++) {
+        const uint8_t* src = (const uint8_t*)(pixels + (size_t)y * width);
+        uint8_t* dst = y_plane + (size_t)y * y_stride;
+        for (int x = 0; x < width; x++) {
+            int r = src[x * 4];
+            int g = src[x * 4 + 1];
+            int b = src[x * 4 + 2];
+            dst[x] = (uint8_t)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        }
+    }
+    
+    for (int cy = 0; cy < (height + 1) / 2; cy++) {
+        int y0 = cy * 2;
+        int y1 = y0 + 1 < height ? y0 + 1 : y0;
+        const uint8_t* row0 = (const uint8_t*)(pixels + (size_t)y0 * width);
+        const uint8_t* row1 = (const uint8_t*)(pixels + (size_t)y1 * width);
+        uint8_t* u_dst = u_plane + (size_t)cy * u_stride;
+        uint8_t* v_dst = v_plane + (size_t)cy * v_stride;
+        
+        for (int cx = 0; cx < (width + 1) / 2; cx++) {
+            int x0 = cx * 2;
+            int x1 = x0 + 1 < width ? x0 + 1 : x0;
+            int r = row0[x0 * 4] + row0[x1 * 4] + row1[x0 * 4] + row1[x1 * 4];
+            int g = row0[x0 * 4 + 1] + row0[x1 * 4 + 1] + row1[x0 * 4 + 1] + row1[x1 * 4 + 1];
+            int b = row0[x0 * 4 + 2] + row0[x1 * 4 + 2] + row1[x0 * 4 + 2] + row1[x1 * 4 + 2];
+            r = (r + 2) >> 2;
+            g = (g + 2) >> 2;
+            b = (b + 2) >> 2;
+            u_dst[cx] = (uint8_t)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            v_dst[cx] = (uint8_t)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+// Envia um quadro (NULL = esvaziar) e grava todos os pacotes prontos
+static bool encode_and_write(Encoder* enc, AVCodecContext* ctx, AVStream* stream, AVFrame* frame) {
+    if (avcodec_send_frame(ctx, frame) < 0) {
+        fprintf(stderr, "Erro ao enviar quadro ao codificador\n");
+        return false;
+    }
+    
+    for (;;) {
+        int ret = avcodec_receive_packet(ctx, enc->packet);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+            return true;
+        }
+        if (ret < 0) {
+            fprintf(stderr, "Erro ao codificar quadro\n");
+            return false;
+        }
+        
+        av_packet_rescale_ts(enc->packet, ctx->time_base, stream->time_base);
+        enc->packet->stream_index = stream->index;
+        ret = av_interleaved_write_frame(enc->format_ctx, enc->packet);
+        av_packet_unref(enc->packet);
+        if (ret < 0) {
+            fprintf(stderr, "Erro ao gravar pacote\n");
+            return false;
+        }
+    }
+}
+
+// Codifica um quadro de áudio do codec a partir do início do FIFO
+static bool encode_audio_frame(Encoder* enc) {
+    AVFrame* frame = enc->audio_frame;
+    if (av_frame_make_writable(frame) < 0) {
+        return false;
+    }
+    
+    int n = enc->audio_frame_size;
+    const int16_t* src = enc->audio_fifo;
+    if (frame->format == AV_SAMPLE_FMT_FLTP || frame->format == AV_SAMPLE_FMT_FLT) {
+        float* dst = (float*)frame->data[0];
+        for (int i = 0; i < n; i++) {
+            dst[i] = src[i] * (1.0f / 32768.0f);
+        }
+    } else {
+        memcpy(frame->data[0], src, n * sizeof(int16_t));
+    }
+    
+    frame->pts = enc->audio_pts;
+    enc->audio_pts += n;
+    
+    enc->audio_fifo_size -= n;
+    memmove(enc->audio_fifo, enc->audio_fifo + n, enc->audio_fifo_size * sizeof(int16_t));
+    
+    return encode_and_write(enc, enc->audio_ctx, enc->audio_stream, frame);
+}
+
+// Cria o stream de vídeo (H.264 se disponível, senão MPEG-4)
+static bool open_video_stream(VideoExporter* exporter) {
+    Encoder* enc = &exporter->enc;
+    
+    const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+    if (!codec) {
+        codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+    }
+    if (!codec) {
+        fprintf(stderr, "Erro: nenhum codificador de vídeo disponível\n");
+        return false;
+    }
+    
+    enc->video_ctx = avcodec_alloc_context3(codec);
+    if (!enc->video_ctx) {
+        return false;
+    }
+    
+    AVCodecContext* ctx = enc->video_ctx;
+    ctx->width = exporter->width;
+    ctx->height = exporter->height;
+    ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+    ctx->time_base = (AVRational){1, exporter->fps};
+    ctx->framerate = (AVRational){exporter->fps, 1};
+    ctx->gop_size = exporter->fps;
+    ctx->bit_rate = EXPORT_VIDEO_BIT_RATE;
+    ctx->thread_count = 0;  // Threads do codec: automático
+    if (enc->format_ctx->oformat->flags & AVFMT_GLOBALHEADER) {
+        ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+    
+    if (avcodec_open2(ctx, codec, NULL) < 0) {
+        fprintf(stderr, "Erro ao abrir codificador de vídeo\n");
+        return false;
+    }
+    
+    enc->video_stream = avformat_new_stream(enc->format_ctx, NULL);
+    if (!enc->video_stream ||
+        avcodec_parameters_from_context(enc->video_stream->codecpar, ctx) < 0) {
+        return false;
+    }
+    enc->video_stream->time_base = ctx->time_base;
+    
+    enc->video_frame = av_frame_alloc();
+    if (!enc->video_frame) {
+        return false;
+    }
+    enc->video_frame->format = ctx->pix_fmt;
+    enc->video_frame->width = ctx->width;
+    enc->video_frame->height = ctx->height;
+    return av_frame_get_buffer(enc->video_frame, 0) >= 0;
+}
+
+// Cria o stream de áudio AAC mono (opcional: sem codificador, exporta só vídeo)
+static bool open_audio_stream(VideoExporter* exporter) {
+    Encoder* enc = &exporter->enc;
+    
+    const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_AAC);
+    if (!codec) {
+        fprintf(stderr, "Codificador AAC indisponível, exportando sem áudio\n");
+        return true;
+    }
+    
+    enc->audio_ctx = avcodec_alloc_context3(codec);
+    if (!enc->audio_ctx) {
+        return false;
+    }
+    
+    AVCodecContext* ctx = enc->audio_ctx;
+    ctx->sample_rate = exporter->sample_rate;
+    ctx->sample_fmt = codec->sample_fmts ? codec->sample_fmts[0] : AV_SAMPLE_FMT_FLTP;
+    ctx->bit_rate = EXPORT_AUDIO_BIT_RATE;
+    ctx->time_base = (AVRational){1, exporter->sample_rate};
+    
+    // Layout mono (suprime warnings de deprecação, como no decodificador)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    ctx->channels = 1;
+    ctx->channel_layout = AV_CH_LAYOUT_MONO;
+    #pragma GCC diagnostic pop
+    
+    if (enc->format_ctx->oformat->flags & AVFMT_GLOBALHEADER) {
+        ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+    
+    if (ctx->sample_fmt != AV_SAMPLE_FMT_FLTP && ctx->sample_fmt != AV_SAMPLE_FMT_FLT &&
+        ctx->sample_fmt != AV_SAMPLE_FMT_S16 && ctx->sample_fmt != AV_SAMPLE_FMT_S16P) {
+        fprintf(stderr, "Formato de áudio do codificador não suportado\n");
+        return false;
+    }
+    
+    if (avcodec_open2(ctx, codec, NULL) < 0) {
+        fprintf(stderr, "Erro ao abrir codificador de áudio\n");
+        return false;
+    }
+    
+    enc->audio_stream = avformat_new_stream(enc->format_ctx, NULL);
+    if (!enc->audio_stream ||
+        avcodec_parameters_from_context(enc->audio_stream->codecpar, ctx) < 0) {
+        return false;
+    }
+    enc->audio_stream->time_base = ctx->time_base;
+    
+    // Codecs de tamanho variável aceitam qualquer bloco; usa 1024
+    enc->audio_frame_size = ctx->frame_size > 0 ? ctx->frame_size : 1024;
+    enc->audio_fifo = mem_alloc((enc->audio_frame_size + exporter->audio_capacity) * sizeof(int16_t));
+    enc->audio_frame = av_frame_alloc();
+    if (!enc->audio_fifo || !enc->audio_frame) {
+        return false;
+    }
+    
+    AVFrame* frame = enc->audio_frame;
+    frame->format = ctx->sample_fmt;
+    frame->nb_samples = enc->audio_frame_size;
+    frame->sample_rate = ctx->sample_rate;
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    frame->channels = 1;
+    frame->channel_layout = AV_CH_LAYOUT_MONO;
+    #pragma GCC diagnostic pop
+    return av_frame_get_buffer(frame, 0) >= 0;
+}
+
+static void close_encoder(Encoder* enc) {
+    if (enc->audio_fifo) {
+        mem_free(enc->audio_fifo);
+    }
+    if (enc->audio_frame) {
+        av_frame_free(&enc->audio_frame);
+    }
+    if (enc->video_frame) {
+        av_frame_free(&enc->video_frame);
+    }
+    if (enc->packet) {
+        av_packet_free(&enc->packet);
+    }
+    if (enc->audio_ctx) {
+        avcodec_free_context(&enc->audio_ctx);
+    }
+    if (enc->video_ctx) {
+        avcodec_free_context(&enc->video_ctx);
+    }
+    if (enc->format_ctx) {
+        if (enc->format_ctx->pb && !(enc->format_ctx->oformat->flags & AVFMT_NOFILE)) {
+            avio_closep(&enc->format_ctx->pb);
+        }
+        avformat_free_context(enc->format_ctx);
+        enc->format_ctx = NULL;
+    }
+}
+
+static bool open_encoder(VideoExporter* exporter, const char* path) {
+    Encoder* enc = &exporter->enc;
+    
+    if (avformat_alloc_output_context2(&enc->format_ctx, NULL, NULL, path) < 0 || !enc->format_ctx) {
+        fprintf(stderr, "Erro: formato de saída desconhecido para %s\n", path);
+        return false;
+    }
+    
+    enc->packet = av_packet_alloc();
+    if (!enc->packet || !open_video_stream(exporter) || !open_audio_stream(exporter)) {
+        close_encoder(enc);
+        return false;
+    }
+    
+    if (!(enc->format_ctx->oformat->flags & AVFMT_NOFILE) &&
+        avio_open(&enc->format_ctx->pb, path, AVIO_FLAG_WRITE) < 0) {
+        fprintf(stderr, "Erro ao criar arquivo de vídeo: %s\n", path);
+        close_encoder(enc);
+        return false;
+    }
+    
+    if (avformat_write_header(enc->format_ctx, NULL) < 0) {
+        fprintf(stderr, "Erro ao gravar cabeçalho do vídeo\n");
+        close_encoder(enc);
+        return false;
+    }
+    
+    return true;
+}
+
+// Esvazia codificadores e finaliza o contêiner
+static bool finish_encoder(Encoder* enc) {
+    bool ok = true;
+    
+    if (enc->audio_ctx) {
+        // Completa o último quadro de áudio com silêncio
+        if (enc->audio_fifo_size > 0) {
+            memset(enc->audio_fifo + enc->audio_fifo_size, 0,
+                   (enc->audio_frame_size - enc->audio_fifo_size) * sizeof(int16_t));
+            enc->audio_fifo_size = enc->audio_frame_size;
+            ok = encode_audio_frame(enc) && ok;
+        }
+        ok = encode_and_write(enc, enc->audio_ctx, enc->audio_stream, NULL) && ok;
+    }
+    ok = encode_and_write(enc, enc->video_ctx, enc->video_stream, NULL) && ok;
+    
+    if (av_write_trailer(enc->format_ctx) < 0) {
+        ok = false;
+    }
+    return ok;
+}
+
+// Converte/codifica e grava um quadro da fila
+static bool write_slot(VideoExporter* exporter, const ExportSlot* slot) {
+    int w = exporter->width;
+    int h = exporter->height;
+    int cw = (w + 1) / 2;
+    int ch = (h + 1) / 2;
+    
+    switch (exporter->format) {
+        case VIDEO_EXPORT_RAW:
+            return fwrite(slot->pixels, sizeof(uint32_t), (size_t)w * h, exporter->file) == (size_t)w * h;
+        
+        case VIDEO_EXPORT_Y4M: {
+            uint8_t* y_plane = exporter->yuv;
+            uint8_t* u_plane = y_plane + (size_t)w * h;
+            uint8_t* v_plane = u_plane + (size_t)cw * ch;
+            size_t size = (size_t)w * h + (size_t)cw * ch * 2;
+            rgba_to_yuv420(slot->pixels, w, h, y_plane, w, u_plane, cw, v_plane, cw);
+            return fputs("FRAME\n", exporter->file) >= 0 &&
+                   fwrite(exporter->yuv, 1, size, exporter->file) == size;
+        }
+        
+        case VIDEO_EXPORT_ENCODE: {
+            Encoder* enc = &exporter->enc;
+            
+            // Áudio do quadro: acumula até completar quadros do codec
+            if (enc->audio_ctx && slot->num_audio > 0) {
+                memcpy(enc->audio_fifo + enc->audio_fifo_size, slot->audio,
+                       slot->num_audio * sizeof(int16_t));
+                enc->audio_fifo_size += slot->num_audio;
+                while (enc->audio_fifo_size >= enc->audio_frame_size) {
+                    if (!encode_audio_frame(enc)) return false;
+                }
+            }
+            
+            AVFrame* frame = enc->video_frame;
+            if (av_frame_make_writable(frame) < 0) {
+                return false;
+            }
+            rgba_to_yuv420(slot->pixels, w, h,
+                           frame->data[0], frame->linesize[0],
+                           frame->data[1], frame->linesize[1],
+                           frame->data[2], frame->linesize[2]);
+            frame->pts = enc->video_pts++;
+            return encode_and_write(enc, enc->video_ctx, enc->video_stream, frame);
+        }
+    }
+    
+    return false;
+}
+
+// Thread de codificação: consome a fila em ordem até o fechamento
+static int encoder_thread_main(void* data) {
+    VideoExporter* exporter = data;
+    
+    for (;;) {
+        SDL_LockMutex(exporter->mutex);
+        while (exporter->count == 0 && !exporter->closing) {
+            SDL_CondWait(exporter->not_empty, exporter->mutex);
+        }
+        if (exporter->count == 0) {
+            SDL_UnlockMutex(exporter->mutex);
+            break;
+        }
+        ExportSlot* slot = &exporter->slots[exporter->tail];
+        SDL_UnlockMutex(exporter->mutex);
+        
+        // O slot continua ocupado até ser gravado (o produtor não o reutiliza)
+        if (!atomic_load(&exporter->failed) && !write_slot(exporter, slot)) {
+            fprintf(stderr, "Erro ao gravar quadro exportado\n");
+            atomic_store(&exporter->failed, true);
+        }
+        
+        SDL_LockMutex(exporter->mutex);
+        exporter->tail = (exporter->tail + 1) % EXPORT_QUEUE_SLOTS;
+        exporter->count--;
+        SDL_CondSignal(exporter->not_full);
+        SDL_UnlockMutex(exporter->mutex);
+    }
+    
+    return 0;
+}
+
+static void free_exporter(VideoExporter* exporter) {
+    for (int i = 0; i < EXPORT_QUEUE_SLOTS; i++) {
+        if (exporter->slots[i].audio) mem_free(exporter->slots[i].audio);
+        if (exporter->slots[i].pixels) mem_free(exporter->slots[i].pixels);
+    }
+    if (exporter->not_full) SDL_DestroyCond(exporter->not_full);
+    if (exporter->not_empty) SDL_DestroyCond(exporter->not_empty);
+    if (exporter->mutex) SDL_DestroyMutex(exporter->mutex);
+    if (exporter->yuv) mem_free(exporter->yuv);
+    if (exporter->file && exporter->file != stdout) fclose(exporter->file);
+    close_encoder(&exporter->enc);
+    mem_free(exporter);
+}
+
+VideoExporter* video_exporter_open(const char* path, VideoExportFormat format,
+                                   int width, int height, int fps, int sample_rate) {
+    if (!path || width <= 0 || height <= 0 || fps <= 0 || sample_rate <= 0) {
+        return NULL;
+    }
+    
+    VideoExporter* exporter = mem_calloc(1, sizeof(VideoExporter));
+    if (!exporter) {
+        return NULL;
+    }
+    
+    exporter->format = format;
+    exporter->width = width;
+    exporter->height = height;
+    exporter->fps = fps;
+    exporter->sample_rate = sample_rate;
+    exporter->audio_capacity = sample_rate / fps + 1;
+    atomic_init(&exporter->failed, false);
+    
+    exporter->mutex = SDL_CreateMutex();
+    exporter->not_empty = SDL_CreateCond();
+    exporter->not_full = SDL_CreateCond();
+    bool ok = exporter->mutex && exporter->not_empty && exporter->not_full;
+    
+    for (int i = 0; i < EXPORT_QUEUE_SLOTS && ok; i++) {
+        exporter->slots[i].pixels = mem_alloc((size_t)width * height * sizeof(uint32_t));
+        exporter->slots[i].audio = mem_alloc(exporter->audio_capacity * sizeof(int16_t));
+        ok = exporter->slots[i].pixels && exporter->slots[i].audio;
+    }
+    
+    if (ok && format == VIDEO_EXPORT_ENCODE) {
+        if (strcmp(path, "-") == 0) {
+            fprintf(stderr, "Erro: vídeo codificado precisa de um arquivo de saída\n");
+            ok = false;
+        } else {
+            ok = open_encoder(exporter, path);
+        }
+    } else if (ok) {
+        exporter->file = strcmp(path, "-") == 0 ? stdout : fopen(path, "wb");
+        if (!exporter->file) {
+            fprintf(stderr, "Erro ao criar arquivo de vídeo: %s\n", path);
+            ok = false;
+        }
+    }
+    
+    if (ok && format == VIDEO_EXPORT_Y4M) {
+        size_t size = (size_t)width * height + (size_t)((width + 1) / 2) * ((height + 1) / 2) * 2;
+        exporter->yuv = mem_alloc(size);
+        ok = exporter->yuv &&
+             fprintf(exporter->file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps) > 0;
+    }
+    
+    if (ok) {
+        exporter->thread = SDL_CreateThread(encoder_thread_main, "soundwave-encoder", exporter);
+        if (!exporter->thread) {
+            fprintf(stderr, "Erro ao criar thread de codificação: %s\n", SDL_GetError());
+            ok = false;
+        }
+    }
+    
+    if (!ok) {
+        free_exporter(exporter);
+        return NULL;
+    }
+    
+    return exporter;
+}
+
+bool video_exporter_submit(VideoExporter* exporter, const uint32_t* pixels,
+                           const int16_t* audio, int num_audio) {
+    if (!exporter || !pixels || atomic_load(&exporter->failed)) return false;
+    
+    if (!audio || num_audio < 0) num_audio = 0;
+    if (num_audio > exporter->audio_capacity) {
+        fprintf(stderr, "Erro: áudio demais para um quadro (%d samples)\n", num_audio);
+        return false;
+    }
+    
+    SDL_LockMutex(exporter->mutex);
+    while (exporter->count == EXPORT_QUEUE_SLOTS) {
+        SDL_CondWait(exporter->not_full, exporter->mutex);
+    }
+    ExportSlot* slot = &exporter->slots[exporter->head];
+    SDL_UnlockMutex(exporter->mutex);
+    
+    // O slot de 'head' está livre: só esta thread escreve nele
+    memcpy(slot->pixels, pixels, (size_t)exporter->width * exporter->height * sizeof(uint32_t));
+    if (num_audio > 0) {
+        memcpy(slot->audio, audio, num_audio * sizeof(int16_t));
+    }
+    slot->num_audio = num_audio;
+    
+    SDL_LockMutex(exporter->mutex);
+    exporter->head = (exporter->head + 1) % EXPORT_QUEUE_SLOTS;
+    exporter->count++;
+    SDL_CondSignal(exporter->not_empty);
+    SDL_UnlockMutex(exporter->mutex);
+    
+    return true;
+}
+
+bool video_exporter_close(VideoExporter* exporter) {
+    if (!exporter) return false;
+    
+    // Deixa a thread esvaziar a fila e terminar
+    SDL_LockMutex(exporter->mutex);
+    exporter->closing = true;
+    SDL_CondSignal(exporter->not_empty);
+    SDL_UnlockMutex(exporter->mutex);
+    SDL_WaitThread(exporter->thread, NULL);
+    
+    bool ok = !atomic_load(&exporter->failed);
+    if (exporter->format == VIDEO_EXPORT_ENCODE) {
+        ok = finish_encoder(&exporter->enc) && ok;
+    } else if (fflush(exporter->file) != 0) {
+        ok = false;
+    }
+    
+    free_exporter(exporter);
+    return ok;
+}
@@ -0,0 +1,38 @@
+#ifndef VIDEO_EXPORTER_H
+#define VIDEO_EXPORTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Formatos de saída da exportação
+typedef enum {
+    VIDEO_EXPORT_RAW,     // Quadros RGBA32 crus, um após o outro (sem áudio)
+    VIDEO_EXPORT_Y4M,     // YUV4MPEG2 (YUV 4:2:0), legível por ffmpeg/players (sem áudio)
+    VIDEO_EXPORT_ENCODE   // Codificado com libavcodec (H.264 ou MPEG-4 + AAC), contêiner pela extensão
+} VideoExportFormat;
+
+// Exporta quadros renderizados para arquivo ou pipe. A conversão de cor,
+// a codificação e a escrita rodam numa thread própria; o chamador só copia
+// o quadro para uma fila curta (e espera apenas se a fila estiver cheia).
+typedef struct VideoExporter VideoExporter;
+
+// Abre a exportação
+// path: arquivo de saída ("-" = saída padrão, apenas RAW e Y4M)
+// width, height: tamanho dos quadros
+// fps: quadros por segundo
+// sample_rate: taxa do áudio mono enviado junto (usado só em VIDEO_EXPORT_ENCODE)
+VideoExporter* video_exporter_open(const char* path, VideoExportFormat format,
+                                   int width, int height, int fps, int sample_rate);
+
+// Enfileira um quadro e o áudio que ele cobre
+// pixels: quadro RGBA32 (width * height, copiado)
+// audio: samples mono do quadro (pode ser NULL), até sample_rate / fps + 1
+// Retorna: false se a exportação falhou
+bool video_exporter_submit(VideoExporter* exporter, const uint32_t* pixels,
+                           const int16_t* audio, int num_audio);
+
+// Conclui a exportação (esvazia a fila, finaliza o arquivo) e libera recursos
+// Retorna: false se algum quadro não pôde ser escrito
+bool video_exporter_close(VideoExporter* exporter);
+
+#endif // VIDEO_EXPORTER_H
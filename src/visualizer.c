@@ -6,15 +6,42 @@
 #include <stdbool.h>
 #include <math.h>
 #include <time.h>
+#include "render_batch.h"
+#include "soft_rasterizer.h"
+#include "thread_pool.h"
+#include "particle_system.h"
+#include "sprite_batch.h"
+#include "waveform_history.h"
+#include "spectrogram.h"
+#include "bar_layout.h"
+#include "hud_font.h"
+#include "layer_cache.h"
+#include "memory_arena.h"
 
-typedef struct {
-    double x, y;
-    double vx, vy;
-    RGBColor color;
-    double life;
-    double max_life;
-    double size;
-} Particle;
+// Espessura das waveforms de linha simples
+#define VIS_THIN_LINE 1.0f
+
+// Brilho do backend software: passada aditiva larga e fraca sob a linha
+#define VIS_GLOW_SCALE 3.0f
+#define VIS_GLOW_ALPHA 0.25f
+
+// Partículas: capacidade padrão e limite configurável
+// (a geração por quadro escala com capacidade / VIS_DEFAULT_PARTICLES)
+#define VIS_DEFAULT_PARTICLES 1000
+#define VIS_MAX_PARTICLES 100000
+
+// Lado da textura do círculo suave das partículas
+#define VIS_SPRITE_SIZE 32
+
+// Pirâmide do histórico de scroll: o nível k resume 2^k samples por bloco
+#define VIS_HISTORY_LEVELS 24
+
+// Teclas guardadas entre chamadas de visualizer_poll_key
+#define VIS_KEY_QUEUE 16
+
+// Formato de áudio assumido até visualizer_set_audio_format
+#define VIS_DEFAULT_SAMPLE_RATE 44100
+#define VIS_DEFAULT_FFT_SIZE 2048
 
 struct Visualizer {
     SDL_Window* window;
@@ -22,50 +49,77 @@ struct Visualizer {
     int width;
     int height;
     bool should_close;
+    bool headless;   // Sem janela nem renderer (quadros lidos com visualizer_get_pixels)
+    
+    // Teclas pressionadas ainda não consumidas (fila circular)
+    int keys[VIS_KEY_QUEUE];
+    int key_head;
+    int key_count;
+    
+    // Formato do espectro recebido pelas camadas
+    int sample_rate;
+    int fft_size;
     
-    // Buffer para scroll contínuo
-    int16_t* waveform_buffer;
-    RGBColor* color_buffer;
-    int buffer_size;
-    int buffer_pos;
+    // Histórico para scroll contínuo (uma coluna resumida por pixel)
+    WaveformHistory* history;
+    WaveColumn* columns;
+    uint64_t scroll_span;
     bool use_scroll;
     
-    // Sistema de barras de frequência
+    // Sistema de barras de frequência (layout refeito só quando a configuração muda)
+    BarLayout* bar_layout;
+    BarScale bar_scale;
+    float* bar_energies;
     double* bar_heights;
     int max_bars;
     
     // Sistema de partículas
-    Particle* particles;
-    int max_particles;
-    int num_particles;
+    ParticleSystem* particles;
+    SpriteBatch* sprites;
+    VisualizerBlend particle_blend;
+    
+    // Espectrograma: anel de linhas em CPU espelhado numa textura streaming
+    // (uma linha enviada por espectro novo)
+    Spectrogram* spectrogram;
+    SDL_Texture* spectrogram_texture;
+    bool spectrogram_stale;   // Textura desatualizada: reenviar a imagem inteira
+    int spectrogram_pending;  // Linhas novas ainda não enviadas à textura
     
     // Histórico de waveform para efeito fluido
     double* waveform_smooth;
     int smooth_buffer_size;
-};
-
-Visualizer* visualizer_init(int width, int height, const char* title) {
-    Visualizer* vis = malloc(sizeof(Visualizer));
-    if (!vis) {
-        return NULL;
-    }
+    float line_scale;      // Fração da espessura (nível de qualidade)
+    int waveform_step;     // Usa 1 a cada N samples
     
-    vis->width = width;
-    vis->height = height;
-    vis->should_close = false;
-    vis->window = NULL;
-    vis->renderer = NULL;
-    vis->use_scroll = false;
-    vis->waveform_buffer = NULL;
-    vis->color_buffer = NULL;
-    vis->buffer_size = 0;
-    vis->buffer_pos = 0;
+    // Tabelas de cor pré-calculadas
+    ColorMapper* color_mapper;
+    
+    // Lote de primitivas reutilizado pelas camadas (uma submissão por camada)
+    RenderBatch* batch;
+    
+    // Backend software: framebuffer em CPU enviado uma vez por quadro
+    VisualizerBackend backend;
+    SoftRasterizer* raster;
+    SDL_Texture* raster_texture;
+    float trail_persistence;
+    bool glow;
+    
+    // Threads que rasterizam faixas do quadro em paralelo
+    ThreadPool* render_pool;
+    int render_threads;
     
+    // Camadas com taxa própria em texturas alvo (NULL = todas a cada quadro)
+    LayerCache* layers;
+    bool layer_skip;   // Camada atual reutiliza a textura: desenho só avança o estado
+};
+
+// Inicializa o vídeo do SDL e cria janela e renderer
+// Retorna: false (sem nada criado) em caso de erro
+static bool create_window(Visualizer* vis, const char* title) {
     // Inicializa SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         fprintf(stderr, "Erro ao inicializar SDL: %s\n", SDL_GetError());
-        free(vis);
-        return NULL;
+        return false;
     }
     
     // Cria janela
@@ -73,89 +127,216 @@ Visualizer* visualizer_init(int width, int height, const char* title) {
         title,
         SDL_WINDOWPOS_UNDEFINED,
         SDL_WINDOWPOS_UNDEFINED,
-        width,
-        height,
+        vis->width,
+        vis->height,
         SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE
     );
     
     if (!vis->window) {
         fprintf(stderr, "Erro ao criar janela: %s\n", SDL_GetError());
         SDL_Quit();
-        free(vis);
-        return NULL;
+        return false;
     }
     
     // Cria renderer
     vis->renderer = SDL_CreateRenderer(vis->window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     
+    // Sem aceleração, usa o renderer software do SDL
+    if (!vis->renderer) {
+        vis->renderer = SDL_CreateRenderer(vis->window, -1, SDL_RENDERER_SOFTWARE);
+    }
+    
     if (!vis->renderer) {
         fprintf(stderr, "Erro ao criar renderer: %s\n", SDL_GetError());
         SDL_DestroyWindow(vis->window);
         SDL_Quit();
-        free(vis);
+        return false;
+    }
+    
+    return true;
+}
+
+static Visualizer* create_visualizer(int width, int height, const char* title, bool headless) {
+    Visualizer* vis = mem_alloc(sizeof(Visualizer));
+    if (!vis) {
         return NULL;
     }
     
-    // Aloca buffer para scroll contínuo (mantém uma janela de samples)
-    vis->buffer_size = width * 2;  // Mantém 2x a largura da janela em samples
-    vis->waveform_buffer = malloc(vis->buffer_size * sizeof(int16_t));
-    vis->color_buffer = malloc(vis->buffer_size * sizeof(RGBColor));
+    vis->width = width;
+    vis->height = height;
+    vis->should_close = false;
+    vis->headless = headless;
+    vis->key_head = 0;
+    vis->key_count = 0;
+    vis->window = NULL;
+    vis->renderer = NULL;
+    vis->use_scroll = false;
+    vis->history = NULL;
+    vis->columns = NULL;
+    vis->scroll_span = 0;
+    vis->sample_rate = VIS_DEFAULT_SAMPLE_RATE;
+    vis->fft_size = VIS_DEFAULT_FFT_SIZE;
+    vis->spectrogram = NULL;
+    vis->spectrogram_texture = NULL;
+    vis->spectrogram_stale = true;
+    vis->spectrogram_pending = 0;
+    vis->color_mapper = NULL;
+    vis->batch = NULL;
+    vis->backend = VISUALIZER_BACKEND_SDL;
+    vis->raster = NULL;
+    vis->raster_texture = NULL;
+    vis->trail_persistence = 0.0f;
+    vis->glow = false;
+    vis->render_pool = NULL;
+    vis->render_threads = 0;
+    vis->layers = NULL;
+    vis->layer_skip = false;
+    
+    // Janela e renderer (sem janela, tudo é rasterizado em CPU)
+    if (!headless && !create_window(vis, title)) {
+        mem_free(vis);
+        return NULL;
+    }
+    
+    // Histórico para scroll contínuo (padrão: 2x a largura da janela em samples)
+    vis->scroll_span = (uint64_t)width * 2;
+    vis->history = waveform_history_init(width * 4, VIS_HISTORY_LEVELS);
+    vis->columns = mem_alloc(width * sizeof(WaveColumn));
     
     // Aloca buffer para barras de frequência
-    vis->max_bars = 64;
-    vis->bar_heights = malloc(vis->max_bars * sizeof(double));
+    vis->max_bars = BAR_LAYOUT_MAX_BARS;
+    vis->bar_layout = bar_layout_init();
+    vis->bar_scale = BAR_SCALE_LOG;
+    vis->bar_energies = mem_alloc(vis->max_bars * sizeof(float));
+    vis->bar_heights = mem_alloc(vis->max_bars * sizeof(double));
     
-    // Aloca sistema de partículas (aumentado)
-    vis->max_particles = 1000;  // Aumentado de 500 para 1000
-    vis->particles = malloc(vis->max_particles * sizeof(Particle));
-    vis->num_particles = 0;
+    // Aloca sistema de partículas
+    vis->particles = particle_system_init(VIS_DEFAULT_PARTICLES, VISUALIZER_PARTICLE_SEED);
+    vis->sprites = headless ? NULL : sprite_batch_init(vis->renderer, VIS_SPRITE_SIZE, VIS_DEFAULT_PARTICLES);
+    vis->particle_blend = VISUALIZER_BLEND_ADD;
+    
+    // Espectrograma do tamanho da janela (uma coluna por pixel, uma linha por espectro)
+    vis->spectrogram = spectrogram_init(width, height);
+    if (vis->spectrogram) {
+        spectrogram_set_format(vis->spectrogram, vis->sample_rate, vis->fft_size);
+    }
     
     // Aloca buffer para waveform suavizada
     vis->smooth_buffer_size = width;
-    vis->waveform_smooth = malloc(vis->smooth_buffer_size * sizeof(double));
-    
-    if (!vis->waveform_buffer || !vis->color_buffer || !vis->bar_heights || 
-        !vis->particles || !vis->waveform_smooth) {
-        if (vis->waveform_smooth) free(vis->waveform_smooth);
-        if (vis->particles) free(vis->particles);
-        if (vis->bar_heights) free(vis->bar_heights);
-        if (vis->color_buffer) free(vis->color_buffer);
-        if (vis->waveform_buffer) free(vis->waveform_buffer);
-        SDL_DestroyRenderer(vis->renderer);
-        SDL_DestroyWindow(vis->window);
-        SDL_Quit();
-        free(vis);
+    vis->line_scale = 1.0f;
+    vis->waveform_step = 1;
+    vis->waveform_smooth = mem_alloc(vis->smooth_buffer_size * sizeof(double));
+    
+    // Tabelas de cor (paleta padrão)
+    vis->color_mapper = color_mapper_init(COLOR_MAPPER_DEFAULT_RESOLUTION, NULL);
+    
+    // Lote de primitivas dimensionado para uma polilinha de 2 pontos por pixel
+    vis->batch = render_batch_init(width * 2);
+    
+    if (!vis->history || !vis->columns || !vis->bar_layout || !vis->bar_energies || !vis->bar_heights ||
+        !vis->particles || (!headless && !vis->sprites) || !vis->spectrogram ||
+        !vis->waveform_smooth || !vis->color_mapper || !vis->batch) {
+        if (vis->batch) render_batch_free(vis->batch);
+        if (vis->color_mapper) color_mapper_free(vis->color_mapper);
+        if (vis->waveform_smooth) mem_free(vis->waveform_smooth);
+        if (vis->spectrogram) spectrogram_free(vis->spectrogram);
+        if (vis->sprites) sprite_batch_free(vis->sprites);
+        if (vis->particles) particle_system_free(vis->particles);
+        if (vis->bar_heights) mem_free(vis->bar_heights);
+        if (vis->bar_energies) mem_free(vis->bar_energies);
+        if (vis->bar_layout) bar_layout_free(vis->bar_layout);
+        if (vis->columns) mem_free(vis->columns);
+        if (vis->history) waveform_history_free(vis->history);
+        if (!headless) {
+            SDL_DestroyRenderer(vis->renderer);
+            SDL_DestroyWindow(vis->window);
+            SDL_Quit();
+        }
+        mem_free(vis);
         return NULL;
     }
     
     // Inicializa buffers com zeros
-    memset(vis->waveform_buffer, 0, vis->buffer_size * sizeof(int16_t));
-    memset(vis->color_buffer, 0, vis->buffer_size * sizeof(RGBColor));
     memset(vis->bar_heights, 0, vis->max_bars * sizeof(double));
     memset(vis->waveform_smooth, 0, vis->smooth_buffer_size * sizeof(double));
-    vis->buffer_pos = 0;
     vis->use_scroll = true;  // Ativa modo scroll por padrão
     
+    // Sem janela, o quadro só existe no framebuffer do backend software
+    if (headless) {
+        if (!visualizer_set_backend(vis, VISUALIZER_BACKEND_SOFTWARE)) {
+            visualizer_free(vis);
+            return NULL;
+        }
+        return vis;
+    }
+    
+    // No renderer software do SDL cada primitiva é cara: rasteriza em CPU
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(vis->renderer, &info) == 0 && (info.flags & SDL_RENDERER_SOFTWARE)) {
+        visualizer_set_backend(vis, VISUALIZER_BACKEND_SOFTWARE);
+    }
+    
     return vis;
 }
 
+Visualizer* visualizer_init(int width, int height, const char* title) {
+    return create_visualizer(width, height, title, false);
+}
+
+Visualizer* visualizer_init_headless(int width, int height) {
+    return create_visualizer(width, height, NULL, true);
+}
+
 void visualizer_free(Visualizer* vis) {
     if (!vis) return;
     
+    if (vis->layers) {
+        layer_cache_free(vis->layers);
+    }
+    if (vis->raster_texture) {
+        SDL_DestroyTexture(vis->raster_texture);
+    }
+    if (vis->raster) {
+        soft_rasterizer_free(vis->raster);
+    }
+    if (vis->render_pool) {
+        thread_pool_free(vis->render_pool);
+    }
+    if (vis->batch) {
+        render_batch_free(vis->batch);
+    }
+    if (vis->color_mapper) {
+        color_mapper_free(vis->color_mapper);
+    }
     if (vis->waveform_smooth) {
-        free(vis->waveform_smooth);
+        mem_free(vis->waveform_smooth);
+    }
+    if (vis->spectrogram_texture) {
+        SDL_DestroyTexture(vis->spectrogram_texture);
+    }
+    if (vis->spectrogram) {
+        spectrogram_free(vis->spectrogram);
+    }
+    if (vis->sprites) {
+        sprite_batch_free(vis->sprites);
     }
     if (vis->particles) {
-        free(vis->particles);
+        particle_system_free(vis->particles);
     }
     if (vis->bar_heights) {
-        free(vis->bar_heights);
+        mem_free(vis->bar_heights);
+    }
+    if (vis->bar_energies) {
+        mem_free(vis->bar_energies);
+    }
+    if (vis->bar_layout) {
+        bar_layout_free(vis->bar_layout);
     }
-    if (vis->color_buffer) {
-        free(vis->color_buffer);
+    if (vis->columns) {
+        mem_free(vis->columns);
     }
-    if (vis->waveform_buffer) {
-        free(vis->waveform_buffer);
+    if (vis->history) {
+        waveform_history_free(vis->history);
     }
     if (vis->renderer) {
         SDL_DestroyRenderer(vis->renderer);
@@ -164,114 +345,166 @@ void visualizer_free(Visualizer* vis) {
         SDL_DestroyWindow(vis->window);
     }
     
-    SDL_Quit();
-    free(vis);
+    if (!vis->headless) {
+        SDL_Quit();
+    }
+    mem_free(vis);
+}
+
+// Envia o lote da camada ao backend atual
+// glow: camada recebe o brilho aditivo do backend software
+static void submit_layer(Visualizer* vis, bool glow) {
+    if (vis->backend == VISUALIZER_BACKEND_SOFTWARE) {
+        if (glow && vis->glow) {
+            soft_rasterizer_draw_batch(vis->raster, vis->batch, VIS_GLOW_SCALE, VIS_GLOW_ALPHA, SOFT_BLEND_ADD);
+        }
+        soft_rasterizer_draw_batch(vis->raster, vis->batch, 1.0f, 1.0f, SOFT_BLEND_ALPHA);
+        render_batch_clear(vis->batch);
+    } else {
+        render_batch_submit(vis->batch, vis->renderer);
+    }
 }
 
 void visualizer_draw_waveform(Visualizer* vis, const int16_t* samples, int num_samples,
-                               RGBColor* colors) {
-    if (!vis || !samples || num_samples <= 0) {
+                               const RGBColor* colors) {
+    if (!vis || !samples || num_samples <= 0 || vis->layer_skip) {
         return;
     }
     
     // Calcula escala para desenhar a forma de onda
-    double x_scale = (double)vis->width / num_samples;
-    double y_scale = (double)vis->height / 2.0 / 32768.0;
-    int center_y = vis->height / 2;
-    
-    // Desenha a forma de onda como uma linha colorida
-    for (int i = 0; i < num_samples - 1; i++) {
-        int x1 = (int)(i * x_scale);
-        int x2 = (int)((i + 1) * x_scale);
-        
-        // Calcula posições Y com validação de limites
-        int y1 = center_y - (int)(samples[i] * y_scale);
-        int y2 = center_y - (int)(samples[i + 1] * y_scale);
+    float x_scale = (float)vis->width / num_samples;
+    float y_scale = (float)vis->height / 2.0f / 32768.0f;
+    float center_y = (float)(vis->height / 2);
+    float max_y = (float)(vis->height - 1);
+    
+    // Monta a forma de onda como uma única polilinha colorida
+    render_batch_begin_polyline(vis->batch);
+    for (int i = 0; i < num_samples; i++) {
+        float y = center_y - samples[i] * y_scale;
         
         // Garante que Y está dentro dos limites da janela
-        if (y1 < 0) y1 = 0;
-        if (y1 >= vis->height) y1 = vis->height - 1;
-        if (y2 < 0) y2 = 0;
-        if (y2 >= vis->height) y2 = vis->height - 1;
+        if (y < 0.0f) y = 0.0f;
+        if (y > max_y) y = max_y;
         
-        // Escolhe cor
-        RGBColor color;
-        if (colors && i < num_samples) {
-            color = colors[i];
-        } else {
-            // Cor padrão branca se não houver cores
-            color.r = 255;
-            color.g = 255;
-            color.b = 255;
-        }
-        
-        // Desenha linha com a cor especificada
-        SDL_SetRenderDrawColor(vis->renderer, color.r, color.g, color.b, 255);
-        SDL_RenderDrawLine(vis->renderer, x1, y1, x2, y2);
+        // Cor padrão branca se não houver cores
+        RGBColor color = colors ? colors[i] : (RGBColor){255, 255, 255};
+        render_batch_add_point(vis->batch, i * x_scale, y, VIS_THIN_LINE, color);
     }
+    
+    submit_layer(vis, true);
 }
 
 void visualizer_draw_waveform_scroll(Visualizer* vis, const int16_t* samples, int num_samples,
-                                      RGBColor* colors) {
-    if (!vis || !samples || num_samples <= 0) {
+                                      const RGBColor* colors) {
+    if (!vis || num_samples < 0 || (num_samples > 0 && !samples)) {
         return;
     }
     
-    // Adiciona novos samples ao buffer circular
-    for (int i = 0; i < num_samples; i++) {
-        vis->waveform_buffer[vis->buffer_pos] = samples[i];
-        if (colors && i < num_samples) {
-            vis->color_buffer[vis->buffer_pos] = colors[i];
-        } else {
-            vis->color_buffer[vis->buffer_pos] = (RGBColor){255, 255, 255};
+    // Adiciona novos samples ao histórico (nenhum = só redesenha)
+    waveform_history_push(vis->history, samples, colors, num_samples);
+    
+    // Resume o histórico visível em exatamente uma coluna por pixel
+    if (vis->layer_skip) {
+        return;
+    }
+    int valid = waveform_history_get_columns(vis->history, vis->scroll_span, vis->width, vis->columns);
+    if (valid == 0) {
+        return;
+    }
+    
+    float y_scale = (float)vis->height / 2.0f / 32768.0f;
+    float center_y = (float)(vis->height / 2);
+    float half_height = (float)vis->height / 2.0f;
+    
+    // Faixa min/max por coluna e faixa RMS mais clara por cima
+    for (int x = 0; x < vis->width; x++) {
+        const WaveColumn* col = &vis->columns[x];
+        if (!col->valid) continue;
+        
+        float y_top = center_y - col->max * y_scale;
+        float y_bottom = center_y - col->min * y_scale;
+        float h = y_bottom - y_top;
+        if (h < 1.0f) h = 1.0f;
+        render_batch_add_rect(vis->batch, (float)x, y_top, 1.0f, h, col->color);
+        
+        float rms_half = col->rms * half_height;
+        if (rms_half >= 0.5f) {
+            RGBColor light = {
+                (uint8_t)((col->color.r + 255) / 2),
+                (uint8_t)((col->color.g + 255) / 2),
+                (uint8_t)((col->color.b + 255) / 2)
+            };
+            render_batch_add_rect(vis->batch, (float)x, center_y - rms_half, 1.0f, rms_half * 2.0f, light);
         }
-        vis->buffer_pos = (vis->buffer_pos + 1) % vis->buffer_size;
     }
     
-    // Calcula quantos samples visíveis temos
-    int visible_samples = (vis->buffer_pos < vis->width) ? vis->buffer_pos : vis->buffer_size;
-    if (visible_samples == 0) visible_samples = vis->buffer_size;
+    submit_layer(vis, false);
+}
+
+// Rasteriza os comandos do quadro e envia o framebuffer à textura streaming
+static void upload_raster(Visualizer* vis) {
+    soft_rasterizer_flush(vis->raster);
     
-    // Calcula escala
-    double x_scale = (double)vis->width / visible_samples;
-    double y_scale = (double)vis->height / 2.0 / 32768.0;
-    int center_y = vis->height / 2;
+    void* pixels = NULL;
+    int pitch = 0;
+    if (SDL_LockTexture(vis->raster_texture, NULL, &pixels, &pitch) != 0) {
+        return;
+    }
     
-    // Desenha a forma de onda do buffer
-    int start_idx = (vis->buffer_pos - visible_samples + vis->buffer_size) % vis->buffer_size;
+    const uint32_t* src = soft_rasterizer_get_pixels(vis->raster);
+    int width = soft_rasterizer_get_width(vis->raster);
+    int height = soft_rasterizer_get_height(vis->raster);
+    size_t row_bytes = (size_t)width * sizeof(uint32_t);
     
-    for (int i = 0; i < visible_samples - 1; i++) {
-        int idx1 = (start_idx + i) % vis->buffer_size;
-        int idx2 = (start_idx + i + 1) % vis->buffer_size;
-        
-        int x1 = (int)(i * x_scale);
-        int x2 = (int)((i + 1) * x_scale);
-        
-        // Calcula posições Y com validação
-        int y1 = center_y - (int)(vis->waveform_buffer[idx1] * y_scale);
-        int y2 = center_y - (int)(vis->waveform_buffer[idx2] * y_scale);
-        
-        // Garante que Y está dentro dos limites
-        if (y1 < 0) y1 = 0;
-        if (y1 >= vis->height) y1 = vis->height - 1;
-        if (y2 < 0) y2 = 0;
-        if (y2 >= vis->height) y2 = vis->height - 1;
-        
-        // Desenha linha com cor do buffer
-        RGBColor color = vis->color_buffer[idx1];
-        SDL_SetRenderDrawColor(vis->renderer, color.r, color.g, color.b, 255);
-        SDL_RenderDrawLine(vis->renderer, x1, y1, x2, y2);
+    if ((size_t)pitch == row_bytes) {
+        memcpy(pixels, src, row_bytes * height);
+    } else {
+        for (int y = 0; y < height; y++) {
+            memcpy((uint8_t*)pixels + (size_t)y * pitch, src + (size_t)y * width, row_bytes);
+        }
     }
+    
+    SDL_UnlockTexture(vis->raster_texture);
+    SDL_RenderCopy(vis->renderer, vis->raster_texture, NULL, NULL);
 }
 
 void visualizer_present(Visualizer* vis) {
-    if (!vis || !vis->renderer) return;
+    if (!vis) return;
+    
+    // Sem janela, apenas conclui o quadro no framebuffer
+    if (vis->headless) {
+        soft_rasterizer_flush(vis->raster);
+        return;
+    }
+    
+    if (!vis->renderer) return;
+    
+    if (vis->backend == VISUALIZER_BACKEND_SOFTWARE) {
+        upload_raster(vis);
+    }
     
     SDL_RenderPresent(vis->renderer);
 }
 
+const uint32_t* visualizer_get_pixels(Visualizer* vis) {
+    if (!vis || !vis->raster) return NULL;
+    return soft_rasterizer_get_pixels(vis->raster);
+}
+
 void visualizer_clear(Visualizer* vis) {
-    if (!vis || !vis->renderer) return;
+    if (!vis || (!vis->renderer && !vis->headless)) return;
+    
+    layer_cache_next_frame(vis->layers);
+    
+    if (vis->backend == VISUALIZER_BACKEND_SOFTWARE) {
+        // Com rastro, escurece o quadro anterior em vez de limpar
+        if (vis->trail_persistence > 0.0f) {
+            soft_rasterizer_fade(vis->raster, vis->trail_persistence);
+        } else {
+            soft_rasterizer_clear(vis->raster, (RGBColor){0, 0, 0});
+        }
+        return;
+    }
     
     // Limpa com cor preta
     SDL_SetRenderDrawColor(vis->renderer, 0, 0, 0, 255);
@@ -280,6 +513,7 @@ void visualizer_clear(Visualizer* vis) {
 
 bool visualizer_should_close(Visualizer* vis) {
     if (!vis) return true;
+    if (vis->headless) return vis->should_close;
     
     // Processa eventos SDL
     SDL_Event event;
@@ -287,9 +521,17 @@ bool visualizer_should_close(Visualizer* vis) {
         if (event.type == SDL_QUIT) {
             vis->should_close = true;
         }
+        if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+            // Conteúdo das texturas alvo perdido (ex: Direct3D)
+            layer_cache_invalidate(vis->layers, -1);
+        }
         if (event.type == SDL_KEYDOWN) {
             if (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_q) {
                 vis->should_close = true;
+            } else if (!event.key.repeat && vis->key_count < VIS_KEY_QUEUE) {
+                // Outras teclas ficam para visualizer_poll_key
+                vis->keys[(vis->key_head + vis->key_count) % VIS_KEY_QUEUE] = event.key.keysym.sym;
+                vis->key_count++;
             }
         }
     }
@@ -297,6 +539,15 @@ bool visualizer_should_close(Visualizer* vis) {
     return vis->should_close;
 }
 
+int visualizer_poll_key(Visualizer* vis) {
+    if (!vis || vis->key_count == 0) return 0;
+    
+    int key = vis->keys[vis->key_head];
+    vis->key_head = (vis->key_head + 1) % VIS_KEY_QUEUE;
+    vis->key_count--;
+    return key;
+}
+
 int visualizer_get_width(Visualizer* vis) {
     if (!vis) return 0;
     return vis->width;
@@ -307,35 +558,193 @@ int visualizer_get_height(Visualizer* vis) {
     return vis->height;
 }
 
+int visualizer_get_vsync_rate(Visualizer* vis) {
+    if (!vis || !vis->renderer || !vis->window) return 0;
+    
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(vis->renderer, &info) != 0 || !(info.flags & SDL_RENDERER_PRESENTVSYNC)) {
+        return 0;
+    }
+    
+    SDL_DisplayMode mode;
+    if (SDL_GetWindowDisplayMode(vis->window, &mode) != 0) {
+        return 0;
+    }
+    return mode.refresh_rate;
+}
+
+bool visualizer_set_color_palette(Visualizer* vis, const ColorPalette* palette, int resolution) {
+    if (!vis) return false;
+    
+    ColorMapper* mapper = color_mapper_init(resolution, palette);
+    if (!mapper) {
+        return false;
+    }
+    
+    color_mapper_free(vis->color_mapper);
+    vis->color_mapper = mapper;
+    
+    // Cores base das barras vêm das tabelas
+    bar_layout_invalidate(vis->bar_layout);
+    layer_cache_invalidate(vis->layers, -1);
+    return true;
+}
+
+bool visualizer_set_backend(Visualizer* vis, VisualizerBackend backend) {
+    if (!vis) return false;
+    
+    // Sem janela só existe o backend software
+    if (backend == VISUALIZER_BACKEND_SDL && vis->headless) return false;
+    
+    if (backend == VISUALIZER_BACKEND_SOFTWARE && !vis->raster) {
+        SoftRasterizer* raster = soft_rasterizer_init(vis->width, vis->height);
+        SDL_Texture* texture = NULL;
+        if (!vis->headless) {
+            texture = SDL_CreateTexture(vis->renderer, SDL_PIXELFORMAT_RGBA32,
+                                        SDL_TEXTUREACCESS_STREAMING, vis->width, vis->height);
+        }
+        if (!raster || (!vis->headless && !texture)) {
+            fprintf(stderr, "Erro ao criar backend software: %s\n", SDL_GetError());
+            if (texture) SDL_DestroyTexture(texture);
+            if (raster) soft_rasterizer_free(raster);
+            return false;
+        }
+        
+        if (texture) {
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+        }
+        vis->raster = raster;
+        vis->raster_texture = texture;
+        
+        if (!visualizer_set_render_threads(vis, vis->render_threads)) {
+            fprintf(stderr, "Rasterização paralela indisponível, usando uma thread\n");
+        }
+    }
+    
+    // As texturas das camadas não acompanharam o backend software
+    if (backend != vis->backend) {
+        layer_cache_invalidate(vis->layers, -1);
+    }
+    vis->backend = backend;
+    return true;
+}
+
+bool visualizer_set_render_threads(Visualizer* vis, int threads) {
+    if (!vis || threads < 0) return false;
+    
+    vis->render_threads = threads;
+    if (!vis->raster) {
+        // Aplicado quando o backend software for ativado
+        return true;
+    }
+    
+    // O pool tem threads - 1 trabalhadores; a thread de renderização também rasteriza
+    ThreadPool* pool = NULL;
+    if (threads != 1) {
+        pool = thread_pool_init(threads > 1 ? threads - 1 : 0);
+        if (!pool) {
+            return false;
+        }
+    }
+    
+    soft_rasterizer_set_thread_pool(vis->raster, pool);
+    if (vis->render_pool) {
+        thread_pool_free(vis->render_pool);
+    }
+    vis->render_pool = pool;
+    return true;
+}
+
+bool visualizer_set_audio_format(Visualizer* vis, int sample_rate, int fft_size) {
+    if (!vis || !spectrogram_set_format(vis->spectrogram, sample_rate, fft_size)) return false;
+    
+    vis->sample_rate = sample_rate;
+    vis->fft_size = fft_size;
+    layer_cache_invalidate(vis->layers, -1);
+    return true;
+}
+
+void visualizer_set_bar_scale(Visualizer* vis, BarScale scale) {
+    if (!vis) return;
+    if (scale != vis->bar_scale) {
+        layer_cache_invalidate(vis->layers, VISUALIZER_LAYER_BARS);
+    }
+    vis->bar_scale = scale;
+}
+
+bool visualizer_set_scroll_history(Visualizer* vis, uint64_t samples) {
+    if (!vis || samples == 0) return false;
+    if (samples > waveform_history_get_max_span(vis->history, vis->width)) return false;
+    vis->scroll_span = samples;
+    return true;
+}
+
+bool visualizer_set_particle_capacity(Visualizer* vis, int capacity) {
+    if (!vis || capacity <= 0 || capacity > VIS_MAX_PARTICLES) return false;
+    return particle_system_set_capacity(vis->particles, capacity);
+}
+
+int visualizer_get_particle_capacity(Visualizer* vis) {
+    if (!vis) return 0;
+    return particle_system_get_capacity(vis->particles);
+}
+
+void visualizer_set_waveform_detail(Visualizer* vis, float line_scale, int step) {
+    if (!vis) return;
+    if (line_scale < 0.1f) line_scale = 0.1f;
+    if (line_scale > 1.0f) line_scale = 1.0f;
+    vis->line_scale = line_scale;
+    vis->waveform_step = step > 0 ? step : 1;
+}
+
+void visualizer_set_particle_seed(Visualizer* vis, uint64_t seed) {
+    if (!vis) return;
+    particle_system_seed(vis->particles, seed);
+}
+
+void visualizer_set_particle_blend(Visualizer* vis, VisualizerBlend blend) {
+    if (!vis) return;
+    vis->particle_blend = blend;
+}
+
+VisualizerBackend visualizer_get_backend(Visualizer* vis) {
+    if (!vis) return VISUALIZER_BACKEND_SDL;
+    return vis->backend;
+}
+
+void visualizer_set_trails(Visualizer* vis, float persistence) {
+    if (!vis) return;
+    if (persistence < 0.0f) persistence = 0.0f;
+    if (persistence > 1.0f) persistence = 1.0f;
+    vis->trail_persistence = persistence;
+}
+
+void visualizer_set_glow(Visualizer* vis, bool enabled) {
+    if (!vis) return;
+    vis->glow = enabled;
+}
+
 void visualizer_draw_frequency_bars(Visualizer* vis, const double* frequencies, int num_bins, int num_bars) {
     if (!vis || !frequencies || num_bins <= 0 || num_bars <= 0) return;
     if (num_bars > vis->max_bars) num_bars = vis->max_bars;
     
-    // Centraliza as barras no meio da tela
-    int total_bar_width = (int)(vis->width * 0.8);  // Usa 80% da largura
-    int bar_start_x = (vis->width - total_bar_width) / 2;  // Offset para centralizar
-    
-    int bar_width = total_bar_width / num_bars;
-    int bar_spacing = 1;
-    int actual_width = bar_width - bar_spacing;
-    if (actual_width < 1) actual_width = 1;
-    
-    int bins_per_bar = num_bins / num_bars;
-    if (bins_per_bar < 1) bins_per_bar = 1;
+    // Reconstrói faixas, retângulos e cores só se a configuração mudou
+    BarLayoutConfig config = {vis->sample_rate, vis->fft_size, num_bars, vis->width, vis->bar_scale};
+    if (!bar_layout_update(vis->bar_layout, &config, vis->color_mapper) ||
+        !bar_layout_reduce(vis->bar_layout, frequencies, num_bins, vis->bar_energies)) {
+        return;
+    }
     
+    const BarSlot* bars = bar_layout_get_bars(vis->bar_layout);
     const double decay = 0.90;
     const double rise_speed = 0.3;
     
+    // Magnitudes crescem com o tamanho da FFT (escala calibrada para 2048)
+    const double norm = 50.0 * vis->fft_size / VIS_DEFAULT_FFT_SIZE;
+    const float center_y = vis->height * 0.5f;
+    
     for (int i = 0; i < num_bars; i++) {
-        double energy = 0.0;
-        int start = i * bins_per_bar;
-        int end = start + bins_per_bar;
-        if (end > num_bins) end = num_bins;
-        
-        for (int j = start; j < end; j++) {
-            energy += frequencies[j] * frequencies[j];
-        }
-        energy = sqrt(energy / bins_per_bar) / 50.0;
+        double energy = vis->bar_energies[i] / norm;
         if (energy > 1.0) energy = 1.0;
         
         if (energy > vis->bar_heights[i]) {
@@ -343,86 +752,75 @@ void visualizer_draw_frequency_bars(Visualizer* vis, const double* frequencies,
         } else {
             vis->bar_heights[i] *= decay;
         }
+        if (vis->layer_skip) continue;
         
-        int height = (int)(vis->bar_heights[i] * vis->height * 0.85);
-        if (height < 1) height = 1;
-        
-        // Centraliza horizontalmente
-        int x = bar_start_x + i * bar_width + bar_spacing / 2;
-        int center_y = vis->height / 2;
-        int y = center_y - height / 2;
-        
-        int center_bin = (start + end) / 2;
-        double freq = (double)center_bin * 44100.0 / 2048.0;
-        RGBColor color = color_mapper_frequency_to_rgb(freq);
-        
-        // Adiciona mais variação de cores - mistura com cores complementares
-        double hue_shift = (double)i / num_bars * 60.0;  // Variação de 60 graus no HSV
-        RGBColor shifted_color = color_mapper_hsv_to_rgb(
-            (freq < 200 ? 0 : (freq < 2000 ? 120 : 240)) + hue_shift,
-            0.9,
-            0.9
-        );
-        
-        // Mistura cores
-        color.r = (uint8_t)(color.r * 0.6 + shifted_color.r * 0.4);
-        color.g = (uint8_t)(color.g * 0.6 + shifted_color.g * 0.4);
-        color.b = (uint8_t)(color.b * 0.6 + shifted_color.b * 0.4);
+        float height = (float)(int)(vis->bar_heights[i] * vis->height * 0.85);
+        if (height < 1.0f) height = 1.0f;
         
         double brightness = vis->bar_heights[i];
-        color.r = (uint8_t)(color.r * brightness);
-        color.g = (uint8_t)(color.g * brightness);
-        color.b = (uint8_t)(color.b * brightness);
+        RGBColor color = {
+            (uint8_t)(bars[i].color.r * brightness),
+            (uint8_t)(bars[i].color.g * brightness),
+            (uint8_t)(bars[i].color.b * brightness)
+        };
         
-        SDL_Rect rect = {x, y, actual_width, height};
-        SDL_SetRenderDrawColor(vis->renderer, color.r, color.g, color.b, 255);
-        SDL_RenderFillRect(vis->renderer, &rect);
+        // Centralizada verticalmente
+        render_batch_add_rect(vis->batch, bars[i].x, center_y - height * 0.5f, bars[i].width, height, color);
+    }
+    
+    // Todas as barras numa única submissão
+    if (!vis->layer_skip) {
+        submit_layer(vis, false);
     }
 }
 
 void visualizer_draw_fluid_waveform(Visualizer* vis, const int16_t* samples, int num_samples,
-                                     const double* frequencies, RGBColor* colors) {
+                                     const double* frequencies, const RGBColor* colors) {
     if (!vis || !samples || num_samples <= 0) return;
     (void)frequencies;  // Parâmetro não usado ainda, mas pode ser usado no futuro
     
-    double x_scale = (double)vis->width / num_samples;
-    int center_y = vis->height / 2;
+    float x_scale = (float)vis->width / num_samples;
+    float center_y = (float)(vis->height / 2);
     
     // Suaviza a waveform usando média móvel
     for (int i = 0; i < num_samples && i < vis->smooth_buffer_size; i++) {
         double sample = (double)samples[i] / 32768.0;
         vis->waveform_smooth[i] = vis->waveform_smooth[i] * 0.7 + sample * 0.3;
     }
+    if (vis->layer_skip) {
+        return;
+    }
     
-    // Desenha waveform com efeito fluido (linhas suaves com grossura variável)
-    for (int i = 0; i < num_samples - 1; i++) {
-        int x1 = (int)(i * x_scale);
-        int x2 = (int)((i + 1) * x_scale);
-        
-        double y1_val = vis->waveform_smooth[i < vis->smooth_buffer_size ? i : 0];
-        double y2_val = vis->waveform_smooth[(i + 1) < vis->smooth_buffer_size ? (i + 1) : 0];
-        
-        int y1 = center_y - (int)(y1_val * vis->height / 2.0);
-        int y2 = center_y - (int)(y2_val * vis->height / 2.0);
+    // Monta a waveform fluida como uma faixa de triângulos com espessura e
+    // cor por vértice (uma única submissão para a camada inteira)
+    float max_y = (float)(vis->height - 1);
+    render_batch_begin_polyline(vis->batch);
+    
+    // Com passo > 1 a faixa tem menos vértices (o último sample sempre entra)
+    int step = vis->waveform_step;
+    for (int n = 0; n < num_samples + step - 1; n += step) {
+        int i = n < num_samples ? n : num_samples - 1;
+        double y_val = vis->waveform_smooth[i < vis->smooth_buffer_size ? i : 0];
         
-        if (y1 < 0) y1 = 0;
-        if (y1 >= vis->height) y1 = vis->height - 1;
-        if (y2 < 0) y2 = 0;
-        if (y2 >= vis->height) y2 = vis->height - 1;
+        float y = center_y - (float)(y_val * vis->height / 2.0);
+        if (y < 0.0f) y = 0.0f;
+        if (y > max_y) y = max_y;
         
         // Calcula grossura baseada na amplitude (varia de 3 a 10 pixels)
-        double amp = (fabs(y1_val) + fabs(y2_val)) / 2.0;
-        int line_thickness = (int)(3 + amp * 7.0);  // 3 + 0*7 = 3, 3 + 1*7 = 10
-        if (line_thickness > 10) line_thickness = 10;
-        if (line_thickness < 3) line_thickness = 3;
+        double amp = fabs(y_val);
+        float line_thickness = (float)(3.0 + amp * 7.0);
+        if (line_thickness > 10.0f) line_thickness = 10.0f;
+        if (line_thickness < 3.0f) line_thickness = 3.0f;
+        line_thickness *= vis->line_scale;
+        if (line_thickness < 1.0f) line_thickness = 1.0f;
         
         RGBColor color;
-        if (colors && i < num_samples) {
+        if (colors) {
             color = colors[i];
             
             // Adiciona mais variação de cores - rotação de matiz baseada na posição
             double h = ((double)i / num_samples) * 360.0;
-            RGBColor enhanced = color_mapper_hsv_to_rgb(h, 0.8, 0.9);
+            RGBColor enhanced = color_mapper_lut_hsv(vis->color_mapper, h, 0.8, 0.9);
             
             // Mistura cores originais com cores rotacionadas
             color.r = (uint8_t)(color.r * 0.5 + enhanced.r * 0.5);
@@ -436,35 +834,20 @@ void visualizer_draw_fluid_waveform(Visualizer* vis, const int16_t* samples, int
         } else {
             // Cor padrão com variação
             double hue = ((double)i / num_samples) * 240.0;
-            color = color_mapper_hsv_to_rgb(hue, 0.7, 0.8);
+            color = color_mapper_lut_hsv(vis->color_mapper, hue, 0.7, 0.8);
         }
         
-        // Desenha linha com grossura variável
-        SDL_SetRenderDrawColor(vis->renderer, color.r, color.g, color.b, 255);
-        
-        // Desenha múltiplas linhas paralelas para criar grossura
-        for (int t = 0; t < line_thickness; t++) {
-            int offset = t - line_thickness / 2;
-            SDL_RenderDrawLine(vis->renderer, x1, y1 + offset, x2, y2 + offset);
-            // Também desenha perpendicular para preencher melhor
-            if (t > 0 && abs(y2 - y1) > 1) {
-                SDL_RenderDrawLine(vis->renderer, x1 + offset, y1, x1 + offset, y2);
-            }
-        }
+        render_batch_add_point(vis->batch, i * x_scale, y, line_thickness, color);
     }
+    
+    submit_layer(vis, true);
 }
 
 void visualizer_update_particles(Visualizer* vis, const double* frequencies, int num_bins) {
     if (!vis || !frequencies || num_bins <= 0) return;
     
-    // Remove partículas mortas
-    int write_idx = 0;
-    for (int i = 0; i < vis->num_particles; i++) {
-        if (vis->particles[i].life > 0) {
-            vis->particles[write_idx++] = vis->particles[i];
-        }
-    }
-    vis->num_particles = write_idx;
+    ParticleSystem* ps = vis->particles;
+    int capacity = particle_system_get_capacity(ps);
     
     // Gera novas partículas baseadas em frequências altas
     double high_energy = 0.0;
@@ -473,73 +856,260 @@ void visualizer_update_particles(Visualizer* vis, const double* frequencies, int
     }
     high_energy /= (num_bins / 2);
     
-    // Aumenta geração de partículas (mais partículas por frame)
-    if (high_energy > 0.05 && vis->num_particles < vis->max_particles - 10) {
-        int new_particles = (int)(high_energy * 8);  // Aumentado de 3 para 8
-        if (new_particles > 15) new_particles = 15;  // Aumentado de 5 para 15
+    // Geração por quadro proporcional à capacidade (8 e 15 para 1000 partículas)
+    double scale = (double)capacity / VIS_DEFAULT_PARTICLES;
+    int spawn_limit = (int)(15 * scale);
+    if (spawn_limit < 1) spawn_limit = 1;
+    
+    if (high_energy > 0.05 && particle_system_get_count(ps) < capacity - spawn_limit) {
+        int new_particles = (int)(high_energy * 8 * scale);
+        if (new_particles > spawn_limit) new_particles = spawn_limit;
         
-        for (int i = 0; i < new_particles && vis->num_particles < vis->max_particles; i++) {
-            Particle* p = &vis->particles[vis->num_particles++];
-            p->x = (double)(rand() % vis->width);
-            p->y = (double)(rand() % vis->height);
-            p->vx = (double)(rand() % 200 - 100) / 50.0;
-            p->vy = (double)(rand() % 200 - 100) / 50.0;
-            p->life = 1.0;
-            p->max_life = 1.0;
-            p->size = (double)(rand() % 5 + 2);
+        for (int i = 0; i < new_particles; i++) {
+            float x = particle_system_random_float(ps) * vis->width;
+            float y = particle_system_random_float(ps) * vis->height;
+            float vx = particle_system_random_float(ps) * 4.0f - 2.0f;
+            float vy = particle_system_random_float(ps) * 4.0f - 2.0f;
+            float size = 2.0f + (float)(particle_system_random(ps) % 5);
             
             // Cor mais variada - usa toda a gama de frequências
-            int freq_bin = rand() % num_bins;
-            double freq = (double)freq_bin * 44100.0 / 2048.0;
+            int freq_bin = (int)(particle_system_random(ps) % (uint32_t)num_bins);
+            double freq = (double)freq_bin * vis->sample_rate / vis->fft_size;
             
             // Adiciona variação de matiz para mais cores
-            double hue_variation = (double)(rand() % 60) - 30;  // Variação de ±30 graus
-            RGBColor base_color = color_mapper_frequency_to_rgb(freq);
+            double hue_variation = particle_system_random_float(ps) * 60.0 - 30.0;  // Variação de ±30 graus
+            RGBColor base_color = color_mapper_lut_frequency(vis->color_mapper, freq);
             double base_hue = (freq < 200 ? 0 : (freq < 2000 ? 120 : 240));
-            RGBColor varied_color = color_mapper_hsv_to_rgb(base_hue + hue_variation, 0.9, 0.9);
+            RGBColor varied_color = color_mapper_lut_hsv(vis->color_mapper, base_hue + hue_variation, 0.9, 0.9);
             
             // Mistura cores para mais variedade
-            p->color.r = (uint8_t)(base_color.r * 0.6 + varied_color.r * 0.4);
-            p->color.g = (uint8_t)(base_color.g * 0.6 + varied_color.g * 0.4);
-            p->color.b = (uint8_t)(base_color.b * 0.6 + varied_color.b * 0.4);
+            RGBColor color;
+            color.r = (uint8_t)(base_color.r * 0.6 + varied_color.r * 0.4);
+            color.g = (uint8_t)(base_color.g * 0.6 + varied_color.g * 0.4);
+            color.b = (uint8_t)(base_color.b * 0.6 + varied_color.b * 0.4);
+            
+            if (!particle_system_spawn(ps, x, y, vx, vy, size, color)) break;
         }
     }
     
-    // Atualiza partículas existentes
-    for (int i = 0; i < vis->num_particles; i++) {
-        Particle* p = &vis->particles[i];
-        
-        p->x += p->vx;
-        p->y += p->vy;
-        p->vy += 0.2;  // Gravidade suave
-        p->life -= 0.02;
-        
-        // Bounce nas bordas
-        if (p->x < 0 || p->x >= vis->width) p->vx *= -0.8;
-        if (p->y < 0 || p->y >= vis->height) p->vy *= -0.8;
+    // Atualiza partículas existentes (integração, bounce, vida, remoção)
+    particle_system_update(ps, (float)vis->width, (float)vis->height);
+}
+
+void visualizer_draw_particles(Visualizer* vis) {
+    if (!vis || vis->layer_skip) return;
+    
+    ParticleView view = particle_system_view(vis->particles);
+    bool additive = vis->particle_blend == VISUALIZER_BLEND_ADD;
+    
+    if (vis->backend == VISUALIZER_BACKEND_SOFTWARE) {
+        // Discos suaves gravados no rasterizador
+        SoftBlendMode blend = additive ? SOFT_BLEND_ADD : SOFT_BLEND_ALPHA;
+        for (int i = 0; i < view.count; i++) {
+            float alpha = view.life[i];
+            soft_rasterizer_draw_disc(vis->raster, view.x[i], view.y[i], view.size[i] * alpha,
+                                      view.color[i], alpha, blend);
+        }
+        return;
+    }
+    
+    // Um quad texturizado por partícula, todos numa única chamada
+    for (int i = 0; i < view.count; i++) {
+        float alpha = view.life[i];
+        sprite_batch_add(vis->sprites, view.x[i], view.y[i], view.size[i] * alpha,
+                         view.color[i], alpha);
+    }
+    sprite_batch_submit(vis->sprites, vis->renderer, additive);
+}
+
+
+// Copia as linhas [first, first + count) do anel para a textura
+static bool upload_spectrogram_rows(Visualizer* vis, int first, int count) {
+    int columns = spectrogram_get_columns(vis->spectrogram);
+    const uint32_t* image = spectrogram_get_pixels(vis->spectrogram);
+    size_t row_bytes = (size_t)columns * sizeof(uint32_t);
+    
+    SDL_Rect rect = {0, first, columns, count};
+    void* pixels = NULL;
+    int pitch = 0;
+    if (SDL_LockTexture(vis->spectrogram_texture, &rect, &pixels, &pitch) != 0) {
+        return false;
+    }
+    for (int y = 0; y < count; y++) {
+        memcpy((uint8_t*)pixels + (size_t)y * pitch, image + (size_t)(first + y) * columns, row_bytes);
+    }
+    SDL_UnlockTexture(vis->spectrogram_texture);
+    return true;
+}
+
+// Envia à textura as linhas novas desde o último envio (uma por quadro, ou
+// as acumuladas enquanto a camada não foi redesenhada) ou, se a textura
+// estiver desatualizada, a imagem inteira
+static bool upload_spectrogram(Visualizer* vis) {
+    int columns = spectrogram_get_columns(vis->spectrogram);
+    int rows = spectrogram_get_rows(vis->spectrogram);
+    
+    if (!vis->spectrogram_texture) {
+        vis->spectrogram_texture = SDL_CreateTexture(vis->renderer, SDL_PIXELFORMAT_RGBA32,
+                                                     SDL_TEXTUREACCESS_STREAMING, columns, rows);
+        if (!vis->spectrogram_texture) {
+            fprintf(stderr, "Erro ao criar textura do espectrograma: %s\n", SDL_GetError());
+            return false;
+        }
+        SDL_SetTextureBlendMode(vis->spectrogram_texture, SDL_BLENDMODE_NONE);
+        vis->spectrogram_stale = true;
+    }
+    
+    int pending = vis->spectrogram_pending;
+    if (vis->spectrogram_stale || pending >= rows) {
+        if (!upload_spectrogram_rows(vis, 0, rows)) {
+            return false;
+        }
+    } else if (pending > 0) {
+        // Linhas novas: [head, head + pending) no anel, talvez dando a volta
+        int head = spectrogram_get_head(vis->spectrogram);
+        int first = rows - head < pending ? rows - head : pending;
+        if (!upload_spectrogram_rows(vis, head, first) ||
+            (pending > first && !upload_spectrogram_rows(vis, 0, pending - first))) {
+            return false;
+        }
+    }
+    
+    vis->spectrogram_stale = false;
+    vis->spectrogram_pending = 0;
+    return true;
+}
+
+void visualizer_draw_spectrogram(Visualizer* vis, const double* frequencies, int num_bins) {
+    if (!vis) return;
+    
+    // Só linhas gravadas entram no próximo envio
+    if (frequencies && num_bins > 0 && spectrogram_push(vis->spectrogram, frequencies, num_bins)) {
+        vis->spectrogram_pending++;
+    }
+    if (vis->layer_skip) {
+        return;
+    }
+    
+    // Linha mais recente no topo: [head, rows) e depois [0, head) do anel
+    int columns = spectrogram_get_columns(vis->spectrogram);
+    int rows = spectrogram_get_rows(vis->spectrogram);
+    int head = spectrogram_get_head(vis->spectrogram);
+    
+    if (vis->backend == VISUALIZER_BACKEND_SOFTWARE) {
+        // A textura deixa de acompanhar o anel enquanto o backend software desenha
+        vis->spectrogram_stale = true;
+        vis->spectrogram_pending = 0;
         
-        if (p->x < 0) p->x = 0;
-        if (p->x >= vis->width) p->x = vis->width - 1;
-        if (p->y < 0) p->y = 0;
-        if (p->y >= vis->height) p->y = vis->height - 1;
+        const uint32_t* image = spectrogram_get_pixels(vis->spectrogram);
+        soft_rasterizer_draw_image(vis->raster, image + (size_t)head * columns,
+                                   columns, rows - head, columns, 0, 0);
+        if (head > 0) {
+            soft_rasterizer_draw_image(vis->raster, image, columns, head, columns, 0, rows - head);
+        }
+        return;
+    }
+    
+    if (!upload_spectrogram(vis)) {
+        return;
+    }
+    
+    SDL_Rect src = {0, head, columns, rows - head};
+    SDL_Rect dst = {0, 0, columns, rows - head};
+    SDL_RenderCopy(vis->renderer, vis->spectrogram_texture, &src, &dst);
+    if (head > 0) {
+        src = (SDL_Rect){0, 0, columns, head};
+        dst = (SDL_Rect){0, rows - head, columns, head};
+        SDL_RenderCopy(vis->renderer, vis->spectrogram_texture, &src, &dst);
+    }
+}
+
+void visualizer_draw_text(Visualizer* vis, float x, float y, float scale, const char* text, RGBColor color) {
+    if (!vis || !text || scale <= 0.0f || vis->layer_skip) return;
+    
+    float advance = (HUD_FONT_WIDTH + 1) * scale;
+    float line_height = (HUD_FONT_HEIGHT + 2) * scale;
+    
+    // Fundo escuro sob o bloco de texto (maior linha x número de linhas)
+    int columns = 0;
+    int lines = 0;
+    int current = 0;
+    for (const char* c = text; *c; c++) {
+        if (*c == '\n') {
+            lines++;
+            current = 0;
+        } else if (++current > columns) {
+            columns = current;
+        }
+    }
+    if (current > 0) lines++;
+    if (lines == 0) return;
+    render_batch_add_rect(vis->batch, x - 2.0f * scale, y - 2.0f * scale,
+                          columns * advance + 3.0f * scale, lines * line_height + 2.0f * scale,
+                          (RGBColor){0, 0, 0});
+    
+    // Cada trecho contínuo aceso de uma linha do glifo vira um retângulo
+    float pen_x = x;
+    float pen_y = y;
+    for (const char* c = text; *c; c++) {
+        if (*c == '\n') {
+            pen_x = x;
+            pen_y += line_height;
+            continue;
+        }
         
-        // Desenha partícula
-        if (p->life > 0) {
-            double alpha = p->life / p->max_life;
-            RGBColor color = p->color;
-            color.r = (uint8_t)(color.r * alpha);
-            color.g = (uint8_t)(color.g * alpha);
-            color.b = (uint8_t)(color.b * alpha);
-            
-            SDL_SetRenderDrawColor(vis->renderer, color.r, color.g, color.b, (uint8_t)(alpha * 255));
-            
-            // Desenha círculo simples (quadrado pequeno)
-            int size = (int)(p->size * alpha);
-            if (size > 0) {
-                SDL_Rect rect = {(int)p->x - size/2, (int)p->y - size/2, size, size};
-                SDL_RenderFillRect(vis->renderer, &rect);
+        uint16_t glyph = hud_font_glyph(*c);
+        for (int row = 0; row < HUD_FONT_HEIGHT && glyph; row++) {
+            int col = 0;
+            while (col < HUD_FONT_WIDTH) {
+                if (!(glyph & (1u << (row * HUD_FONT_WIDTH + col)))) {
+                    col++;
+                    continue;
+                }
+                int start = col;
+                while (col < HUD_FONT_WIDTH && (glyph & (1u << (row * HUD_FONT_WIDTH + col)))) col++;
+                render_batch_add_rect(vis->batch, pen_x + start * scale, pen_y + row * scale,
+                                      (col - start) * scale, scale, color);
             }
         }
+        pen_x += advance;
+    }
+    
+    submit_layer(vis, false);
+}
+
+bool visualizer_set_layer_rate(Visualizer* vis, VisualizerLayer layer, double hz) {
+    if (!vis || layer < 0 || layer >= VISUALIZER_LAYER_COUNT || hz < 0.0) return false;
+    
+    // Texturas alvo só existem no renderer da janela
+    if (!vis->renderer) return false;
+    
+    if (!vis->layers) {
+        if (hz == 0.0) return true;
+        vis->layers = layer_cache_init(vis->renderer, vis->width, vis->height, VISUALIZER_LAYER_COUNT);
+        if (!vis->layers) {
+            return false;
+        }
     }
+    return layer_cache_set_rate(vis->layers, layer, hz);
 }
 
+void visualizer_invalidate_layer(Visualizer* vis, VisualizerLayer layer) {
+    if (!vis || layer < 0 || layer >= VISUALIZER_LAYER_COUNT) return;
+    layer_cache_invalidate(vis->layers, layer);
+}
+
+bool visualizer_begin_layer(Visualizer* vis, VisualizerLayer layer, uint64_t now_ns) {
+    // No backend software toda camada é rasterizada no framebuffer a cada quadro
+    if (!vis || !vis->layers || vis->backend == VISUALIZER_BACKEND_SOFTWARE) return true;
+    
+    vis->layer_skip = !layer_cache_begin(vis->layers, layer, now_ns);
+    return !vis->layer_skip;
+}
+
+void visualizer_end_layer(Visualizer* vis) {
+    if (!vis || !vis->layers || vis->backend == VISUALIZER_BACKEND_SOFTWARE) return;
+    
+    layer_cache_end(vis->layers);
+    vis->layer_skip = false;
+}
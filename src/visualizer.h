@@ -4,15 +4,45 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "color_mapper.h"
+#include "bar_layout.h"
 
 typedef struct Visualizer Visualizer;
 
+// Semente padrão das partículas (a mesma em toda sessão)
+#define VISUALIZER_PARTICLE_SEED 0x853c49e6748fea9bULL
+
+// Backend de renderização das camadas
+typedef enum {
+    VISUALIZER_BACKEND_SDL,       // Primitivas enviadas ao SDL_Renderer
+    VISUALIZER_BACKEND_SOFTWARE   // Rasterização em CPU + upload único numa textura streaming
+} VisualizerBackend;
+
+// Mistura das partículas
+typedef enum {
+    VISUALIZER_BLEND_ADD,    // Aditiva (brilho acumula onde partículas se sobrepõem)
+    VISUALIZER_BLEND_ALPHA   // Normal (transparência pela vida da partícula)
+} VisualizerBlend;
+
+// Camadas do quadro, na ordem de composição
+typedef enum {
+    VISUALIZER_LAYER_BACKGROUND,   // Fundo (espectrograma)
+    VISUALIZER_LAYER_WAVEFORM,     // Waveform fluida ou scroll
+    VISUALIZER_LAYER_BARS,         // Barras de frequência
+    VISUALIZER_LAYER_PARTICLES,    // Partículas
+    VISUALIZER_LAYER_COUNT
+} VisualizerLayer;
+
 // Inicializa o visualizador
 // width: largura da janela
 // height: altura da janela
 // title: título da janela
 Visualizer* visualizer_init(int width, int height, const char* title);
 
+// Inicializa o visualizador sem janela (não usa o vídeo do SDL)
+// Os quadros são rasterizados em CPU de forma determinística e lidos com
+// visualizer_get_pixels após visualizer_present
+Visualizer* visualizer_init_headless(int width, int height);
+
 // Libera recursos do visualizador
 void visualizer_free(Visualizer* vis);
 
@@ -22,55 +52,163 @@ void visualizer_free(Visualizer* vis);
 // frequencies: array de frequências por região (pode ser NULL para cor única)
 // colors: array de cores correspondentes aos samples (pode ser NULL)
 void visualizer_draw_waveform(Visualizer* vis, const int16_t* samples, int num_samples,
-                               RGBColor* colors);
+                               const RGBColor* colors);
 
 // Desenha forma de onda com scroll contínuo (mantém histórico)
 // samples: novos samples a adicionar
-// num_samples: número de samples
+// num_samples: número de samples (0 = redesenha o histórico sem adicionar)
 // colors: cores correspondentes
 void visualizer_draw_waveform_scroll(Visualizer* vis, const int16_t* samples, int num_samples,
-                                      RGBColor* colors);
+                                      const RGBColor* colors);
 
 // Atualiza a tela (chama SDL_RenderPresent)
 void visualizer_present(Visualizer* vis);
 
+// Retorna o último quadro do backend software (RGBA32, width * height pixels)
+// Retorna: NULL se o backend software não estiver ativo
+const uint32_t* visualizer_get_pixels(Visualizer* vis);
+
 // Limpa a tela com cor de fundo
 void visualizer_clear(Visualizer* vis);
 
 // Verifica se a janela deve ser fechada
 bool visualizer_should_close(Visualizer* vis);
 
+// Retorna a próxima tecla pressionada desde a última chamada (código SDL_Keycode)
+// ESC e Q não entram na fila (fecham a janela)
+// Retorna: 0 se não houver teclas pendentes
+int visualizer_poll_key(Visualizer* vis);
+
 // Retorna a largura da janela
 int visualizer_get_width(Visualizer* vis);
 
 // Retorna a altura da janela
 int visualizer_get_height(Visualizer* vis);
 
+// Retorna a taxa do monitor (Hz) quando o present espera o vsync
+// Retorna: 0 sem vsync, sem janela ou se a taxa for desconhecida
+int visualizer_get_vsync_rate(Visualizer* vis);
+
+// Troca a paleta e a resolução das tabelas de cor usadas pelas camadas
+// palette: paleta (NULL = padrão)
+// resolution: número de entradas das tabelas
+// Retorna: false se não foi possível criar as novas tabelas (mantém as atuais)
+bool visualizer_set_color_palette(Visualizer* vis, const ColorPalette* palette, int resolution);
+
 // Desenha forma de onda com scroll contínuo (mantém histórico)
 // samples: novos samples a adicionar
-// num_samples: número de samples
+// num_samples: número de samples (0 = redesenha o histórico sem adicionar)
 // colors: cores correspondentes
 void visualizer_draw_waveform_scroll(Visualizer* vis, const int16_t* samples, int num_samples,
-                                      RGBColor* colors);
+                                      const RGBColor* colors);
+
+// Seleciona o backend de renderização
+// (o backend software é escolhido automaticamente quando o SDL usa o renderer software)
+// Retorna: false se não foi possível criar os recursos do backend
+bool visualizer_set_backend(Visualizer* vis, VisualizerBackend backend);
+
+// Retorna o backend de renderização atual
+VisualizerBackend visualizer_get_backend(Visualizer* vis);
+
+// Rastro entre quadros (backend software): fração do quadro anterior mantida
+// persistence: 0 = sem rastro (limpa a tela), até 1
+void visualizer_set_trails(Visualizer* vis, float persistence);
+
+// Brilho aditivo em torno das waveforms (backend software)
+void visualizer_set_glow(Visualizer* vis, bool enabled);
+
+// Número de threads que rasterizam o quadro em faixas (backend software)
+// threads: 0 = automático (núcleos disponíveis), 1 = só a thread de renderização
+// Retorna: false se não foi possível criar as threads (mantém a configuração atual)
+bool visualizer_set_render_threads(Visualizer* vis, int threads);
+
+// Formato do espectro passado às camadas (padrão: 44100 Hz, FFT de 2048)
+// sample_rate: taxa de amostragem do áudio
+// fft_size: tamanho da janela FFT (espectros com fft_size / 2 + 1 bins)
+// Retorna: false se os parâmetros forem inválidos
+bool visualizer_set_audio_format(Visualizer* vis, int sample_rate, int fft_size);
+
+// Duração exibida pelo scroll contínuo, em samples (padrão: 2x a largura)
+// O custo de desenho é uma coluna por pixel, qualquer que seja a duração
+// Retorna: false se a duração exceder o histórico guardado
+bool visualizer_set_scroll_history(Visualizer* vis, uint64_t samples);
+
+// Número máximo de partículas vivas (padrão 1000)
+// capacity: de 1 a 100000; a geração por quadro escala com a capacidade
+// Retorna: false se o valor for inválido ou faltar memória
+bool visualizer_set_particle_capacity(Visualizer* vis, int capacity);
+
+// Retorna a capacidade atual de partículas
+int visualizer_get_particle_capacity(Visualizer* vis);
+
+// Detalhe da waveform fluida (padrão: 1.0, 1)
+// line_scale: fração da espessura das linhas (0.1 a 1.0, mínimo de 1 pixel)
+// step: usa 1 a cada N samples (menos vértices por quadro)
+void visualizer_set_waveform_detail(Visualizer* vis, float line_scale, int step);
+
+// Semente do gerador de números aleatórios das partículas
+void visualizer_set_particle_seed(Visualizer* vis, uint64_t seed);
+
+// Mistura usada ao desenhar as partículas (padrão: aditiva)
+void visualizer_set_particle_blend(Visualizer* vis, VisualizerBlend blend);
+
+// Espaçamento das barras de frequência (padrão: logarítmico)
+void visualizer_set_bar_scale(Visualizer* vis, BarScale scale);
 
 // Desenha barras de frequência animadas
 // frequencies: array de magnitudes de frequência do FFT
 // num_bins: número de bins de frequência
-// num_bars: número de barras a desenhar
+// num_bars: número de barras a desenhar (até 512; o layout é refeito só
+// quando barras, largura, escala ou formato de áudio mudam)
 void visualizer_draw_frequency_bars(Visualizer* vis, const double* frequencies, int num_bins, int num_bars);
 
+// Desenha o espectrograma (waterfall) ocupando a janela, mais recente no topo
+// frequencies: espectro novo, vira uma linha (NULL = redesenha sem adicionar)
+// num_bins: número de bins (fft_size / 2 + 1)
+// Opaco: usado como fundo, antes das outras camadas
+void visualizer_draw_spectrogram(Visualizer* vis, const double* frequencies, int num_bins);
+
 // Desenha waveform fluida/ambient com efeitos
 // samples: array de samples
 // num_samples: número de samples
 // frequencies: array de frequências para cores
 // colors: cores correspondentes
 void visualizer_draw_fluid_waveform(Visualizer* vis, const int16_t* samples, int num_samples,
-                                     const double* frequencies, RGBColor* colors);
+                                     const double* frequencies, const RGBColor* colors);
 
-// Atualiza e desenha sistema de partículas
+// Atualiza o sistema de partículas (gera, move e remove; não desenha nem usa o SDL)
 // frequencies: array de frequências para gerar partículas
 // num_bins: número de bins
 void visualizer_update_particles(Visualizer* vis, const double* frequencies, int num_bins);
 
+// Desenha as partículas vivas numa única submissão (sprites de círculo suave)
+void visualizer_draw_particles(Visualizer* vis);
+
+// Taxa de atualização de uma camada (backend SDL): com taxa, a camada é
+// desenhada numa textura alvo reutilizada entre redesenhos e copiada para a
+// tela a cada quadro
+// hz: redesenhos por segundo (0 = a cada quadro, padrão)
+// Retorna: false sem janela ou se o renderer não suporta texturas alvo
+bool visualizer_set_layer_rate(Visualizer* vis, VisualizerLayer layer, double hz);
+
+// Força o redesenho de uma camada no próximo quadro
+void visualizer_invalidate_layer(Visualizer* vis, VisualizerLayer layer);
+
+// Começa uma camada; as chamadas de desenho seguintes pertencem a ela até
+// visualizer_end_layer. Numa camada que não será redesenhada elas só
+// avançam o estado (suavização das barras e da waveform, linhas do
+// espectrograma, histórico do scroll) e a textura guardada é reutilizada.
+// now_ns: instante do quadro (frame_clock_now_ns)
+// Retorna: false se a camada não será redesenhada neste quadro
+bool visualizer_begin_layer(Visualizer* vis, VisualizerLayer layer, uint64_t now_ns);
+
+// Termina a camada atual (compõe a textura dela na tela)
+void visualizer_end_layer(Visualizer* vis);
+
+// Desenha texto de diagnóstico sobre um fundo escuro (fonte bitmap 3x5)
+// x, y: canto superior esquerdo; scale: pixels por ponto da fonte
+// text: pode conter várias linhas separadas por '\n'
+void visualizer_draw_text(Visualizer* vis, float x, float y, float scale, const char* text, RGBColor color);
+
 #endif // VISUALIZER_H
 
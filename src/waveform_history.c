@@ -0,0 +1,223 @@
+#include "waveform_history.h"
+#include <stdlib.h>
+#include <math.h>
+#include "memory_arena.h"
+
+// Um nível da pirâmide: buffer circular de blocos completos + bloco parcial
+typedef struct {
+    int16_t* min;
+    int16_t* max;
+    float* sum_sq;       // Soma dos quadrados (normalizados em [-1, 1])
+    RGBColor* color;
+    uint64_t completed;  // Blocos completos desde o início
+    
+    // Bloco em formação
+    int16_t pending_min;
+    int16_t pending_max;
+    float pending_sum_sq;
+    RGBColor pending_color;
+    int pending_count;   // Filhos acumulados (samples no nível 0, blocos nos demais)
+} HistoryLevel;
+
+struct WaveformHistory {
+    HistoryLevel* levels;
+    int num_levels;
+    int capacity;
+    uint64_t total_samples;
+};
+
+static void reset_pending(HistoryLevel* level) {
+    level->pending_min = INT16_MAX;
+    level->pending_max = INT16_MIN;
+    level->pending_sum_sq = 0.0f;
+    level->pending_count = 0;
+}
+
+WaveformHistory* waveform_history_init(int level_capacity, int num_levels) {
+    if (level_capacity < 2 || num_levels < 1 || num_levels > 40) {
+        return NULL;
+    }
+    
+    WaveformHistory* hist = mem_calloc(1, sizeof(WaveformHistory));
+    if (!hist) {
+        return NULL;
+    }
+    
+    hist->capacity = level_capacity;
+    hist->levels = mem_calloc(num_levels, sizeof(HistoryLevel));
+    if (!hist->levels) {
+        mem_free(hist);
+        return NULL;
+    }
+    hist->num_levels = num_levels;
+    
+    for (int l = 0; l < num_levels; l++) {
+        HistoryLevel* level = &hist->levels[l];
+        level->min = mem_alloc(level_capacity * sizeof(int16_t));
+        level->max = mem_alloc(level_capacity * sizeof(int16_t));
+        level->sum_sq = mem_alloc(level_capacity * sizeof(float));
+        level->color = mem_alloc(level_capacity * sizeof(RGBColor));
+        if (!level->min || !level->max || !level->sum_sq || !level->color) {
+            waveform_history_free(hist);
+            return NULL;
+        }
+    }
+    
+    waveform_history_clear(hist);
+    return hist;
+}
+
+void waveform_history_free(WaveformHistory* hist) {
+    if (!hist) return;
+    
+    if (hist->levels) {
+        for (int l = 0; l < hist->num_levels; l++) {
+            HistoryLevel* level = &hist->levels[l];
+            if (level->color) mem_free(level->color);
+            if (level->sum_sq) mem_free(level->sum_sq);
+            if (level->max) mem_free(level->max);
+            if (level->min) mem_free(level->min);
+        }
+        mem_free(hist->levels);
+    }
+    
+    mem_free(hist);
+}
+
+void waveform_history_clear(WaveformHistory* hist) {
+    if (!hist) return;
+    
+    hist->total_samples = 0;
+    for (int l = 0; l < hist->num_levels; l++) {
+        hist->levels[l].completed = 0;
+        reset_pending(&hist->levels[l]);
+    }
+}
+
+// Fecha o bloco parcial do nível e o propaga ao nível de cima
+static void complete_block(WaveformHistory* hist, int l) {
+    for (; l < hist->num_levels; l++) {
+        HistoryLevel* level = &hist->levels[l];
+        int slot = (int)(level->completed % (uint64_t)hist->capacity);
+        level->min[slot] = level->pending_min;
+        level->max[slot] = level->pending_max;
+        level->sum_sq[slot] = level->pending_sum_sq;
+        level->color[slot] = level->pending_color;
+        level->completed++;
+        
+        int16_t block_min = level->pending_min;
+        int16_t block_max = level->pending_max;
+        float block_sum_sq = level->pending_sum_sq;
+        RGBColor block_color = level->pending_color;
+        reset_pending(level);
+        
+        if (l + 1 >= hist->num_levels) break;
+        
+        // Acumula no bloco parcial do nível de cima (2 filhos por bloco)
+        HistoryLevel* up = &hist->levels[l + 1];
+        if (block_min < up->pending_min) up->pending_min = block_min;
+        if (block_max > up->pending_max) up->pending_max = block_max;
+        up->pending_sum_sq += block_sum_sq;
+        up->pending_color = block_color;
+        if (++up->pending_count < 2) break;
+    }
+}
+
+void waveform_history_push(WaveformHistory* hist, const int16_t* samples, const RGBColor* colors,
+                           int num_samples) {
+    if (!hist || !samples || num_samples <= 0) return;
+    
+    HistoryLevel* base = &hist->levels[0];
+    const float scale = 1.0f / 32768.0f;
+    
+    // No nível 0 cada bloco é um sample
+    for (int i = 0; i < num_samples; i++) {
+        int16_t s = samples[i];
+        float v = s * scale;
+        base->pending_min = s;
+        base->pending_max = s;
+        base->pending_sum_sq = v * v;
+        base->pending_color = colors ? colors[i] : (RGBColor){255, 255, 255};
+        base->pending_count = 1;
+        complete_block(hist, 0);
+    }
+    
+    hist->total_samples += num_samples;
+}
+
+uint64_t waveform_history_get_total(const WaveformHistory* hist) {
+    if (!hist) return 0;
+    return hist->total_samples;
+}
+
+uint64_t waveform_history_get_max_span(const WaveformHistory* hist, int num_columns) {
+    if (!hist || num_columns <= 0) return 0;
+    
+    // O nível mais alto precisa de no máximo 2 blocos por coluna
+    uint64_t blocks = (uint64_t)hist->capacity;
+    if (blocks > (uint64_t)num_columns * 2) blocks = (uint64_t)num_columns * 2;
+    return blocks << (hist->num_levels - 1);
+}
+
+int waveform_history_get_columns(const WaveformHistory* hist, uint64_t span, int num_columns,
+                                 WaveColumn* columns) {
+    if (!hist || !columns || num_columns <= 0 || span == 0) return 0;
+    
+    // Escolhe o nível mais alto cujo bloco cabe numa coluna
+    double per_column = (double)span / num_columns;
+    int l = 0;
+    while (l + 1 < hist->num_levels && (double)(1ULL << (l + 1)) <= per_column) {
+        l++;
+    }
+    
+    const HistoryLevel* level = &hist->levels[l];
+    uint64_t block_size = 1ULL << l;
+    
+    // Janela termina no último bloco completo do nível, em blocos
+    uint64_t end_block = level->completed;
+    double span_blocks = (double)span / block_size;
+    double start_block = (double)end_block - span_blocks;
+    
+    // Blocos mais antigos que o buffer circular já foram sobrescritos
+    uint64_t oldest = end_block > (uint64_t)hist->capacity ? end_block - hist->capacity : 0;
+    
+    int valid = 0;
+    for (int c = 0; c < num_columns; c++) {
+        WaveColumn* col = &columns[c];
+        double first_f = start_block + span_blocks * c / num_columns;
+        double last_f = start_block + span_blocks * (c + 1) / num_columns;
+        
+        col->valid = false;
+        col->min = 0;
+        col->max = 0;
+        col->rms = 0.0f;
+        col->color = (RGBColor){0, 0, 0};
+        
+        if (last_f <= (double)oldest) continue;
+        
+        uint64_t first = first_f < (double)oldest ? oldest : (uint64_t)first_f;
+        uint64_t last = (uint64_t)last_f;
+        if (last <= first) last = first + 1;
+        if (last > end_block) last = end_block;
+        if (first >= last) continue;
+        
+        int16_t mn = INT16_MAX;
+        int16_t mx = INT16_MIN;
+        float sum_sq = 0.0f;
+        for (uint64_t b = first; b < last; b++) {
+            int slot = (int)(b % (uint64_t)hist->capacity);
+            if (level->min[slot] < mn) mn = level->min[slot];
+            if (level->max[slot] > mx) mx = level->max[slot];
+            sum_sq += level->sum_sq[slot];
+        }
+        
+        col->min = mn;
+        col->max = mx;
+        col->rms = sqrtf(sum_sq / (float)((last - first) * block_size));
+        col->color = level->color[(int)((last - 1) % (uint64_t)hist->capacity)];
+        col->valid = true;
+        valid++;
+    }
+    
+    return valid;
+}
@@ -0,0 +1,50 @@
+#ifndef WAVEFORM_HISTORY_H
+#define WAVEFORM_HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "color_mapper.h"
+
+// Resumo de um intervalo de samples (uma coluna de pixels)
+typedef struct {
+    int16_t min;
+    int16_t max;
+    float rms;
+    RGBColor color;   // Cor do sample mais recente do intervalo
+    bool valid;       // false se o intervalo está fora do histórico
+} WaveColumn;
+
+// Histórico de waveform em pirâmide: cada nível guarda resumos min/max/RMS
+// de blocos com o dobro de samples do nível anterior, num buffer circular
+// de tamanho fixo. Atualizado incrementalmente a cada sample; uma consulta
+// custa O(colunas) independentemente da duração exibida.
+typedef struct WaveformHistory WaveformHistory;
+
+// Inicializa o histórico
+// level_capacity: blocos guardados por nível (>= 2x o maior número de colunas consultado)
+// num_levels: níveis da pirâmide (o nível k resume 2^k samples por bloco)
+WaveformHistory* waveform_history_init(int level_capacity, int num_levels);
+
+// Libera recursos do histórico
+void waveform_history_free(WaveformHistory* hist);
+
+// Descarta todo o histórico
+void waveform_history_clear(WaveformHistory* hist);
+
+// Adiciona samples ao histórico
+// colors: cor de cada sample (pode ser NULL para branco)
+void waveform_history_push(WaveformHistory* hist, const int16_t* samples, const RGBColor* colors,
+                           int num_samples);
+
+// Retorna o número total de samples adicionados
+uint64_t waveform_history_get_total(const WaveformHistory* hist);
+
+// Retorna a maior duração (em samples) consultável com num_columns colunas
+uint64_t waveform_history_get_max_span(const WaveformHistory* hist, int num_columns);
+
+// Resume os últimos span samples em num_columns colunas (mais antiga primeiro)
+// Retorna: número de colunas válidas (as do início ficam inválidas até haver histórico)
+int waveform_history_get_columns(const WaveformHistory* hist, uint64_t span, int num_columns,
+                                 WaveColumn* columns);
+
+#endif // WAVEFORM_HISTORY_H